@@ -0,0 +1,78 @@
+#include "ActionPolicy.h"
+#include "SearchPolicy.h"
+#include <iostream>
+#include <limits>
+using namespace std;
+namespace FantasyArena {
+    // ConsolePolicy implementation
+    BattleAction ConsolePolicy::chooseAction(const Character& self, const Character& /*opponent*/, int /*turnNumber*/, BattleRandom& /*random*/) {
+        int choice;
+        if (self.getAbilityStatus() == SpecialAbilityStatus::READY) {
+            cout << "Enter your choice (1-2): ";
+            while (!(cin >> choice) || (choice != 1 && choice != 2)) {
+                cin.clear();
+                cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                cout << "Invalid input. Please enter 1 or 2: ";
+            }
+        }
+        else {
+            cout << "Enter your choice (1): ";
+            while (!(cin >> choice) || choice != 1) {
+                cin.clear();
+                cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                cout << "Special ability is on cooldown. Please enter 1 to attack: ";
+            }
+        }
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        return choice == 1 ? BattleAction::ATTACK : BattleAction::SPECIAL_ABILITY;
+    }
+    string ConsolePolicy::getPolicyName() const {
+        return "console";
+    }
+
+    // AlwaysAttackPolicy implementation
+    BattleAction AlwaysAttackPolicy::chooseAction(const Character& /*self*/, const Character& /*opponent*/, int /*turnNumber*/, BattleRandom& /*random*/) {
+        return BattleAction::ATTACK;
+    }
+    string AlwaysAttackPolicy::getPolicyName() const {
+        return "attack";
+    }
+
+    // AbilityWhenReadyPolicy implementation
+    BattleAction AbilityWhenReadyPolicy::chooseAction(const Character& self, const Character& /*opponent*/, int /*turnNumber*/, BattleRandom& /*random*/) {
+        if (self.getAbilityStatus() == SpecialAbilityStatus::READY) {
+            return BattleAction::SPECIAL_ABILITY;
+        }
+        return BattleAction::ATTACK;
+    }
+    string AbilityWhenReadyPolicy::getPolicyName() const {
+        return "ability";
+    }
+
+    // RandomPolicy implementation
+    BattleAction RandomPolicy::chooseAction(const Character& self, const Character& /*opponent*/, int /*turnNumber*/, BattleRandom& random) {
+        if (self.getAbilityStatus() == SpecialAbilityStatus::READY && random.nextInt(0, 1) == 1) {
+            return BattleAction::SPECIAL_ABILITY;
+        }
+        return BattleAction::ATTACK;
+    }
+    string RandomPolicy::getPolicyName() const {
+        return "random";
+    }
+
+    ActionPolicy* createPolicy(const string& name) {
+        if (name == "attack") {
+            return new AlwaysAttackPolicy();
+        }
+        if (name == "ability") {
+            return new AbilityWhenReadyPolicy();
+        }
+        if (name == "random") {
+            return new RandomPolicy();
+        }
+        if (name == "search") {
+            return new SearchPolicy();
+        }
+        return nullptr;
+    }
+} // namespace FantasyArena
@@ -0,0 +1,56 @@
+#pragma once
+#ifndef ACTION_POLICY_H
+#define ACTION_POLICY_H
+#include <string>
+#include "Character.h"
+#include "BattleRandom.h"
+using namespace std;
+namespace FantasyArena {
+    enum class BattleAction {
+        ATTACK = 1,
+        SPECIAL_ABILITY = 2
+    };
+    // Decides what a fighter does on its turn. The arena asks the policy of the
+    // current attacker once per turn instead of reading from cin directly.
+    // Any randomness must come from the arena's battle-scoped engine.
+    class ActionPolicy {
+    public:
+        virtual ~ActionPolicy() = default;
+        virtual BattleAction chooseAction(const Character& self, const Character& opponent, int turnNumber, BattleRandom& random) = 0;
+        virtual string getPolicyName() const = 0;
+    };
+
+    // Human player at the keyboard (the original interactive behaviour)
+    class ConsolePolicy : public ActionPolicy {
+    public:
+        BattleAction chooseAction(const Character& self, const Character& opponent, int turnNumber, BattleRandom& random) override;
+        string getPolicyName() const override;
+    };
+
+    // Always attacks, never uses the special ability
+    class AlwaysAttackPolicy : public ActionPolicy {
+    public:
+        BattleAction chooseAction(const Character& self, const Character& opponent, int turnNumber, BattleRandom& random) override;
+        string getPolicyName() const override;
+    };
+
+    // Uses the special ability whenever it is ready, otherwise attacks
+    class AbilityWhenReadyPolicy : public ActionPolicy {
+    public:
+        BattleAction chooseAction(const Character& self, const Character& opponent, int turnNumber, BattleRandom& random) override;
+        string getPolicyName() const override;
+    };
+
+    // Picks uniformly between attacking and a ready special ability
+    class RandomPolicy : public ActionPolicy {
+    public:
+        BattleAction chooseAction(const Character& self, const Character& opponent, int turnNumber, BattleRandom& random) override;
+        string getPolicyName() const override;
+    };
+
+    // Create a headless policy by name ("attack", "ability", "random", or
+    // "search" for the computer opponent with its default time budget).
+    // Returns nullptr for an unknown name; the caller owns the result.
+    ActionPolicy* createPolicy(const string& name);
+} // namespace FantasyArena
+#endif // ACTION_POLICY_H
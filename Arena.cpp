@@ -1,20 +1,53 @@
 ﻿#define _CRT_SECURE_NO_WARNINGS //For warnings
 #include "Arena.h"
+#include "CombatantPool.h"
+#include "StatTables.h"
+#include "Tablebase.h"
+#include "BattleInstrumentation.h"
+#include "FrameRenderer.h"
 #include <iostream>
 #include <fstream>
 #include <ctime>
 #include <limits>
+#include <algorithm>
 #include<string>
 using namespace std;
 namespace FantasyArena {
     Arena::Arena(const string& name, EnvironmentType environmentType)
-        : name(name), environmentType(environmentType), isLogFileOpen(false), playerChoice(1) {
-        // Generate a log file name based on arena name
-        logFileName = "battle_log_" + name + ".txt";
-        // We'll open the log file when needed
+        : name(name), environmentType(environmentType), logSink(new AsyncLogSink()), playerChoice(1), traceWriter(nullptr), tablebase(nullptr), headless(false),
+        random(BattleRandom::seedFromClock()), suspended(false), suspendedBattle() {
+        // The log file is named and opened when a battle starts
+    }
+    Arena::Arena(const Arena& other)
+        : name(other.name), environmentType(other.environmentType), logSink(new AsyncLogSink()),
+        playerChoice(other.playerChoice), traceWriter(nullptr), tablebase(nullptr), headless(false),
+        random(other.random.getSeed(), other.random.getStream()), suspended(false), suspendedBattle() {
+        if (other.logSink) {
+            logSink->setConfig(other.logSink->getConfig());
+        }
+    }
+    Arena& Arena::operator=(const Arena& other) {
+        if (this != &other) {
+            closeLogFile();
+            name = other.name;
+            environmentType = other.environmentType;
+            logFileName.clear();
+            logSink.reset(new AsyncLogSink());
+            if (other.logSink) {
+                logSink->setConfig(other.logSink->getConfig());
+            }
+            playerChoice = other.playerChoice;
+            traceWriter = nullptr;
+            tablebase = nullptr;
+            headless = false;
+            random.reseed(other.random.getSeed(), other.random.getStream());
+            suspended = false;
+        }
+        return *this;
     }
     Arena::~Arena() {
-        // No need to close anything here
+        // Flushes and closes a log that is still open
+        closeLogFile();
     }
     string Arena::getName() const {
         return name;
@@ -22,91 +55,174 @@ namespace FantasyArena {
     EnvironmentType Arena::getEnvironmentType() const {
         return environmentType;
     }
+    string getEnvironmentNameForType(EnvironmentType environmentType) {
+        int index = static_cast<int>(environmentType);
+        return (index >= 0 && index < ENVIRONMENT_COUNT) ? ENVIRONMENT_MODIFIERS[index].name : "Unknown";
+    }
     std::string Arena::getEnvironmentName() const {
-        switch (environmentType) {
-        case EnvironmentType::FIRE:
-            return "Fire";
-        case EnvironmentType::ICE:
-            return "Ice";
-        case EnvironmentType::JUNGLE:
-            return "Jungle";
-        case EnvironmentType::DESERT:
-            return "Desert";
-        case EnvironmentType::MOUNTAIN:
-            return "Mountain";
-        default:
-            return "Unknown";
-        }
+        return getEnvironmentNameForType(environmentType);
+    }
+    void Arena::applyEnvironmentModifiers(Character& character) const {
+        // Exact integer percentages from the environment table
+        const EnvironmentModifiers& modifiers = getEnvironmentModifiers(environmentType);
+        character.setAttack(applyPercent(character.getAttack(), modifiers.attackPercent));
+        character.setDefense(applyPercent(character.getDefense(), modifiers.defensePercent));
+        character.setHealth(applyPercent(character.getHealth(), modifiers.healthPercent));
     }
     void Arena::applyEnvironmentalEffects(Character* character) {
+        applyEnvironmentModifiers(*character);
+        if (!Character::isLogConsumed()) {
+            return;
+        }
         string effectDescription;
         switch (environmentType) {
         case EnvironmentType::FIRE:
-            // Fire arenas boost attack but reduce defense
-            character->setAttack(character->getAttack() * 1.2);
-            character->setDefense(character->getDefense() * 0.9);
             effectDescription = "The scorching heat of the fire arena boosts " + character->getName() +
                 "'s attack but weakens their defense!";
             break;
         case EnvironmentType::ICE:
-            // Ice arenas reduce attack speed but increase defense
-            character->setAttack(character->getAttack() * 0.9);
-            character->setDefense(character->getDefense() * 1.2);
             effectDescription = "The freezing cold of the ice arena slows " + character->getName() +
                 "'s attacks but hardens their defense!";
             break;
         case EnvironmentType::JUNGLE:
-            // Jungle arenas provide balanced stats
-            character->setAttack(character->getAttack() * 1.1);
-            character->setDefense(character->getDefense() * 1.1);
             effectDescription = "The lush jungle environment provides " + character->getName() +
                 " with balanced stat boosts!";
             break;
         case EnvironmentType::DESERT:
-            // Desert arenas increase attack but reduce health
-            character->setAttack(character->getAttack() * 1.3);
-            character->setHealth(character->getHealth() * 0.9);
             effectDescription = "The harsh desert sun empowers " + character->getName() +
                 "'s attacks but drains their health!";
             break;
         case EnvironmentType::MOUNTAIN:
-            // Mountain arenas increase defense but reduce attack
-            character->setAttack(character->getAttack() * 0.8);
-            character->setDefense(character->getDefense() * 1.4);
             effectDescription = "The high altitude of the mountain arena reduces " + character->getName() +
                 "'s attack power but greatly enhances their defense!";
             break;
         }
-        cout << effectDescription << endl;
+        Character::display(effectDescription);
         logEvent(effectDescription);
     }
    
-    void Arena::startBattle(Character* player1, Character* player2) {
-        Character::setEnvironmentName(getEnvironmentName());
-        Character::openLogFile();
+    BattleResult Arena::startBattle(const Character& player1, const Character& player2) {
+        ConsolePolicy player1Policy;
+        ConsolePolicy player2Policy;
+        return startBattle(player1, player2, player1Policy, player2Policy);
+    }
 
-        string battleStart = "Battle started in " + name + " (" + getEnvironmentName() + " environment) between " +
-            player1->getName() + " (" + player1->getClassName() + ") and " +
-            player2->getName() + " (" + player2->getClassName() + ")";
+    BattleResult Arena::startBattle(const Character& player1, const Character& player2, ActionPolicy& player1Policy,
+        ActionPolicy& player2Policy) {
+        CombatantPool& pool = CombatantPool::forThisThread();
+        Character* fighter1 = pool.acquire(player1);
+        Character* fighter2 = pool.acquire(player2);
+        headless = false;
+        openLogFile();
+        BattleResult result = runBattle(fighter1, fighter2, player1Policy, player2Policy);
+        closeLogFile();
+        pool.release(fighter1);
+        pool.release(fighter2);
+        return result;
+    }
 
-        cout << "\n=== BATTLE START ===" << endl;
-        cout << battleStart << endl;
-        cout << "===================" << endl;
-        Character::logAction(battleStart);
+    BattleResult Arena::resumeBattle(const Character& player1, const Character& player2, ActionPolicy& player1Policy,
+        ActionPolicy& player2Policy, const BattleCheckpoint& checkpoint) {
+        CombatantPool& pool = CombatantPool::forThisThread();
+        Character* fighter1 = pool.acquire(player1);
+        Character* fighter2 = pool.acquire(player2);
+        headless = false;
+        openLogFile();
+        BattleResult result = runBattle(fighter1, fighter2, player1Policy, player2Policy, &checkpoint);
+        closeLogFile();
+        pool.release(fighter1);
+        pool.release(fighter2);
+        return result;
+    }
 
-        applyEnvironmentalEffects(player1);
-        applyEnvironmentalEffects(player2);
+    BattleResult Arena::simulateBattle(const Character& player1, const Character& player2, ActionPolicy& policy1, ActionPolicy& policy2) {
+        // Headless battles never wait for input and only log if the caller opened the log.
+        // Console output is controlled globally through Character::setConsoleMode.
+        CombatantPool& pool = CombatantPool::forThisThread();
+        Character* fighter1 = pool.acquire(player1);
+        Character* fighter2 = pool.acquire(player2);
+        headless = true;
+        BattleResult result = runBattle(fighter1, fighter2, policy1, policy2);
+        headless = false;
+        pool.release(fighter1);
+        pool.release(fighter2);
+        return result;
+    }
 
-        cout << "\nInitial Stats:" << endl;
-        cout << player1->getName() << ": " << player1->getHealth() << "/" << player1->getMaxHealth() << " HP" << endl;
-        cout << player2->getName() << ": " << player2->getHealth() << "/" << player2->getMaxHealth() << " HP" << endl;
+    BattleResult Arena::runBattle(Character* player1, Character* player2, ActionPolicy& policy1, ActionPolicy& policy2,
+        const BattleCheckpoint* resumeFrom) {
+        const bool showOutput = Character::isConsoleOutputEnabled();
+        const bool showSummary = Character::isBattleSummaryEnabled();
+        suspended = false;
+        BattleInstrumentation* instrumentation = BattleInstrumentation::getCurrent();
+        chrono::steady_clock::time_point battleClock;
+        if (instrumentation) {
+            battleClock = chrono::steady_clock::now();
+            BattleInstrumentation::count(BattleCounter::BATTLES);
+        }
 
-        cout << "\nPress Enter to start the battle...";
-        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        Character::registerLogName(*player1);
+        Character::registerLogName(*player2);
+        if (showSummary || Character::getLogSink()) {
+            string battleStart = (resumeFrom ? "Battle resumed at turn " + to_string(resumeFrom->turnNumber) : string("Battle started")) +
+                " in " + name + " (" + getEnvironmentName() + " environment) between " +
+                player1->getName() + " (" + player1->getClassName() + ") and " +
+                player2->getName() + " (" + player2->getClassName() + ")";
+            if (showSummary) {
+                FrameRenderer::out() << "\n=== BATTLE START ===\n" << battleStart << "\n===================\n";
+            }
+            Character::logAction(battleStart);
+        }
+        // Every battle starts at the beginning of its stream, so it can be re-run from the log
+        random.reseed(random.getSeed(), random.getStream());
+        if (Character::getLogSink()) {
+            Character::logAction("Battle seed: " + to_string(random.getSeed()) + " (stream " + to_string(random.getStream()) + ")");
+        }
+        Character::attachTraceWriter(traceWriter);
+        if (traceWriter) {
+            traceWriter->beginBattle(name, static_cast<uint8_t>(environmentType), *player1, *player2,
+                random.getSeed(), random.getStream());
+        }
+
+        if (resumeFrom) {
+            // The saved states already include the environment's modifiers
+            player1->setCombatState(resumeFrom->fighters[0]);
+            player2->setCombatState(resumeFrom->fighters[1]);
+            random.seek(resumeFrom->randomPosition);
+        }
+        else {
+            PhaseTimer timer(BattlePhase::ENVIRONMENT);
+            applyEnvironmentalEffects(player1);
+            applyEnvironmentalEffects(player2);
+        }
+        Character::traceEvent(TraceEventType::BATTLE_START, player1, player1->getHealth(), player2->getHealth());
+
+        if (showOutput) {
+            ostream& frame = FrameRenderer::out();
+            frame << "\nInitial Stats:\n";
+            frame << player1->getName() << ": " << player1->getHealth() << "/" << player1->getMaxHealth() << " HP\n";
+            frame << player2->getName() << ": " << player2->getHealth() << "/" << player2->getMaxHealth() << " HP\n";
+        }
+
+        if (!headless) {
+            FrameRenderer::endFrame();
+            PhaseTimer timer(BattlePhase::INPUT_WAIT);
+            cout << "\nPress Enter to start the battle...";
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        }
 
         int turnNumber = 1;
         Character* currentAttacker = player1;
         Character* currentDefender = player2;
+        ActionPolicy* currentPolicy = &policy1;
+        ActionPolicy* waitingPolicy = &policy2;
+        if (resumeFrom) {
+            turnNumber = resumeFrom->turnNumber;
+            if (resumeFrom->attacker == 2) {
+                std::swap(currentAttacker, currentDefender);
+                std::swap(currentPolicy, waitingPolicy);
+            }
+        }
 
         while (player1->isAlive() && player2->isAlive()) {
             //  Decrement cooldown from second turn onward
@@ -114,185 +230,367 @@ namespace FantasyArena {
                 currentAttacker->decrementCooldown();
             }
 
+            BattleInstrumentation::count(BattleCounter::TURNS);
+            if (traceWriter) {
+                traceWriter->beginTurn(turnNumber);
+            }
+            Character::traceEvent(TraceEventType::TURN_START, currentAttacker, 0, 0);
             checkAndDeactivateAbilitiesWithoutCooldown(currentAttacker);
-            processTurn(currentAttacker, currentDefender, turnNumber);
+            processTurn(currentAttacker, currentDefender, turnNumber, *currentPolicy);
 
             if (!currentDefender->isAlive()) {
-                if (currentDefender->getClassName() == "LegendaryCharacter") {
-                    LegendaryCharacter* legendary = dynamic_cast<LegendaryCharacter*>(currentDefender);
-                    if (legendary && !legendary->hasResurrected() && legendary->checkResurrection()) {
-                        cout << "\n*** The battle continues! ***" << endl;
-                    }
-                    else {
-                        break;
+                if (currentDefender->tryResurrect()) {
+                    BattleInstrumentation::count(BattleCounter::RESURRECTIONS);
+                    if (showOutput) {
+                        Character::display("\n*** The battle continues! ***");
                     }
                 }
                 else {
                     break;
                 }
             }
-
-            cout << "\nPress Enter for next turn...";
-            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            // The whole turn reaches the console in one write
+            FrameRenderer::endFrame();
 
             std::swap(currentAttacker, currentDefender);
+            std::swap(currentPolicy, waitingPolicy);
             ++turnNumber;
+
+            if (!headless) {
+                string input;
+                {
+                    PhaseTimer timer(BattlePhase::INPUT_WAIT);
+                    cout << "\nPress Enter for next turn (S to save and quit)...";
+                    getline(cin, input);
+                }
+                if ((input == "s" || input == "S") && player1->isAlive() && player2->isAlive()) {
+                    // Checkpoint at the turn boundary: plain copies of both states
+                    suspendedBattle.turnNumber = turnNumber;
+                    suspendedBattle.attacker = currentAttacker == player1 ? 1 : 2;
+                    suspendedBattle.randomPosition = random.getPosition();
+                    suspendedBattle.fighters[0] = player1->getCombatState();
+                    suspendedBattle.fighters[1] = player2->getCombatState();
+                    suspended = true;
+                    break;
+                }
+            }
+        }
+
+        if (suspended) {
+            Character::logAction("Battle saved and quit before turn " + to_string(turnNumber));
+            if (traceWriter) {
+                traceWriter->endBattle(0);
+            }
+            Character::attachTraceWriter(nullptr);
+            if (instrumentation) {
+                instrumentation->addBattleTime(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - battleClock).count());
+            }
+            return { 0, turnNumber, 0 };
         }
 
         Character* winner = player1->isAlive() ? player1 : player2;
         Character* loser = player1->isAlive() ? player2 : player1;
 
-        string battleEnd = "Battle ended! " + winner->getName() + " (" + winner->getClassName() + ") has defeated " +
-            loser->getName() + " (" + loser->getClassName() + ") with " +
-            to_string(winner->getHealth()) + " health remaining!";
+        if (showSummary || Character::getLogSink()) {
+            string battleEnd = "Battle ended! " + winner->getName() + " (" + winner->getClassName() + ") has defeated " +
+                loser->getName() + " (" + loser->getClassName() + ") with " +
+                to_string(winner->getHealth()) + " health remaining!";
+            if (showSummary) {
+                FrameRenderer::out() << "\n=== BATTLE END ===\n" << battleEnd << "\n=================\n";
+            }
+            Character::logAction(battleEnd);
+        }
+        FrameRenderer::endFrame();
+
+        BattleResult result;
+        result.winner = (winner == player1) ? 1 : 2;
+        result.turns = turnNumber;
+        result.winnerHealth = winner->getHealth();
+        Character::traceEvent(TraceEventType::BATTLE_END, winner, result.winner, result.winnerHealth);
+        if (traceWriter) {
+            traceWriter->endBattle(result.winner);
+        }
+        Character::attachTraceWriter(nullptr);
+        if (instrumentation) {
+            instrumentation->addBattleTime(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - battleClock).count());
+        }
+        return result;
+    }
+
+    TeamBattleResult Arena::simulateTeamBattle(const vector<const Character*>& fighters, const vector<int>& teams,
+        const vector<ActionPolicy*>& policies, TargetRule rule) {
+        const bool showSummary = Character::isBattleSummaryEnabled();
+        BattleInstrumentation* instrumentation = BattleInstrumentation::getCurrent();
+        chrono::steady_clock::time_point battleClock;
+        if (instrumentation) {
+            battleClock = chrono::steady_clock::now();
+            BattleInstrumentation::count(BattleCounter::BATTLES);
+        }
+        headless = true;
+        CombatantPool& pool = CombatantPool::forThisThread();
+        const size_t fighterCount = fighters.size();
+        vector<Character*> fighting(fighterCount);
+        int teamCount = 0;
+        for (size_t i = 0; i < fighterCount; ++i) {
+            fighting[i] = pool.acquire(*fighters[i]);
+            Character::registerLogName(*fighting[i]); // Past the sink's name table, names log as "?"
+            teamCount = max(teamCount, teams[i] + 1);
+        }
+        const bool freeForAll = static_cast<size_t>(teamCount) == fighterCount;
+
+        if (showSummary || Character::getLogSink()) {
+            string battleStart = string(freeForAll ? "Free-for-all" : "Team battle") + " started in " + name +
+                " (" + getEnvironmentName() + " environment) between " + to_string(fighterCount) + " fighters in " +
+                to_string(teamCount) + " teams, attacking the " + getTargetRuleName(rule) + " enemy";
+            if (showSummary) {
+                FrameRenderer::out() << "\n=== BATTLE START ===\n" << battleStart << "\n===================\n";
+            }
+            Character::logAction(battleStart);
+        }
+        random.reseed(random.getSeed(), random.getStream());
+        if (Character::getLogSink()) {
+            Character::logAction("Battle seed: " + to_string(random.getSeed()) + " (stream " + to_string(random.getStream()) + ")");
+        }
+        {
+            PhaseTimer timer(BattlePhase::ENVIRONMENT);
+            for (Character* fighter : fighting) {
+                applyEnvironmentalEffects(fighter);
+            }
+        }
 
-        cout << "\n=== BATTLE END ===" << endl;
-        cout << battleEnd << endl;
-        cout << "=================" << endl;
+        vector<int64_t> keys(fighterCount);
+        for (size_t i = 0; i < fighterCount; ++i) {
+            keys[i] = targetKey(rule, fighting[i]->getHealth(), fighting[i]->getAttack());
+        }
+        // Every fighter acts once a round, in an order shuffled for the battle;
+        // the same order breaks targeting ties
+        const int64_t turnInterval = static_cast<int64_t>(fighterCount);
+        vector<uint32_t> order(fighterCount);
+        for (size_t i = 0; i < fighterCount; ++i) {
+            size_t j = static_cast<size_t>(random.nextInt(0, static_cast<int>(i)));
+            order[i] = order[j];
+            order[j] = static_cast<uint32_t>(i);
+        }
+        targetIndex.build(teams, keys, order);
+        initiative.clear();
+        for (size_t i = 0; i < fighterCount; ++i) {
+            initiative.schedule(static_cast<uint32_t>(i), order[i]);
+        }
+        vector<bool> hasActed(fighterCount, false);
+
+        // After a turn: the fighter falls for good, comes back, or is re-keyed.
+        // As in a duel, only the fighter that was attacked can resurrect
+        auto settle = [&](uint32_t id, bool canResurrect) {
+            Character* fighter = fighting[id];
+            if (!targetIndex.contains(id)) {
+                return;
+            }
+            if (!fighter->isAlive()) {
+                if (canResurrect && fighter->tryResurrect()) {
+                    BattleInstrumentation::count(BattleCounter::RESURRECTIONS);
+                }
+                else {
+                    targetIndex.remove(id);
+                    if (Character::isLogConsumed()) {
+                        string fallen = fighter->getName() + " has fallen!";
+                        Character::display(fallen);
+                        Character::logAction(fallen);
+                    }
+                    return;
+                }
+            }
+            targetIndex.update(id, targetKey(rule, fighter->getHealth(), fighter->getAttack()));
+        };
 
-        Character::logAction(battleEnd);
-        Character::closeLogFile();
+        int turnNumber = 1;
+        while (targetIndex.getTeamsStanding() > 1) {
+            int64_t time;
+            uint32_t current = initiative.next(time);
+            if (!targetIndex.contains(current)) {
+                continue; // Fell after it was scheduled
+            }
+            Character* attacker = fighting[current];
+            if (hasActed[current]) {
+                attacker->decrementCooldown();
+            }
+            hasActed[current] = true;
+
+            BattleInstrumentation::count(BattleCounter::TURNS);
+            checkAndDeactivateAbilitiesWithoutCooldown(attacker);
+            uint32_t target = targetIndex.getBestEnemy(static_cast<uint32_t>(teams[current]));
+            // Defensive abilities and reflection act between the attacker and this target only
+            processTurn(attacker, fighting[target], turnNumber, *policies[current]);
+            settle(target, true);
+            settle(current, false); // Reflected damage may have killed the attacker
+            if (targetIndex.contains(current)) {
+                initiative.schedule(current, time + turnInterval);
+            }
+            FrameRenderer::endFrame();
+            ++turnNumber;
+        }
+
+        TeamBattleResult result;
+        // A reflected hit can kill the attacker along with the last enemy
+        result.winningTeam = targetIndex.getTeamsStanding() == 0 ? -1 : static_cast<int>(targetIndex.getLeadingTeam());
+        result.turns = turnNumber - 1;
+        result.survivors = 0;
+        result.winnerHealth = 0;
+        for (size_t i = 0; i < fighterCount; ++i) {
+            if (targetIndex.contains(static_cast<uint32_t>(i))) {
+                result.survivors++;
+                result.winnerHealth += fighting[i]->getHealth();
+            }
+        }
+        if (showSummary || Character::getLogSink()) {
+            string battleEnd;
+            if (result.winningTeam < 0) {
+                battleEnd = "Battle ended! No survivors: the last fighters fell together after " + to_string(result.turns) + " turns!";
+            }
+            else if (freeForAll) {
+                const Character* winner = fighting[result.winningTeam];
+                battleEnd = "Battle ended! " + winner->getName() + " (" + winner->getClassName() + ") wins the free-for-all with " +
+                    to_string(result.winnerHealth) + " health remaining after " + to_string(result.turns) + " turns!";
+            }
+            else {
+                battleEnd = "Battle ended! Team " + to_string(result.winningTeam + 1) + " wins with " + to_string(result.survivors) +
+                    " fighters standing and " + to_string(result.winnerHealth) + " health remaining after " +
+                    to_string(result.turns) + " turns!";
+            }
+            if (showSummary) {
+                FrameRenderer::out() << "\n=== BATTLE END ===\n" << battleEnd << "\n=================\n";
+            }
+            Character::logAction(battleEnd);
+        }
+        FrameRenderer::endFrame();
+
+        for (Character* fighter : fighting) {
+            pool.release(fighter);
+        }
+        headless = false;
+        if (instrumentation) {
+            instrumentation->addBattleTime(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - battleClock).count());
+        }
+        return result;
     }
 
     
-void Arena::processTurn(Character* attacker, Character* defender, int turnNumber) {
-    cout << "\n--- Turn " << turnNumber << " ---" << endl;
-    cout << attacker->getName() << "'s turn" << endl;
-
-    // Show current active or cooldown status
-    displayActiveAbilities(attacker);
+void Arena::processTurn(Character* attacker, Character* defender, int turnNumber, ActionPolicy& policy) {
+    const bool showOutput = Character::isConsoleOutputEnabled();
+    if (showOutput) {
+        PhaseTimer timer(BattlePhase::LOGGING);
+        FrameRenderer::out() << "\n--- Turn " << turnNumber << " ---\n" << attacker->getName() << "'s turn\n";
+
+        // Show current active or cooldown status
+        displayActiveAbilities(attacker);
+    }
 
-    Character::logAction("Turn " + std::to_string(turnNumber) + ": " + attacker->getName() + "'s turn");
+    Character::logEvent(LogEventType::TURN_START, *attacker, nullptr, turnNumber);
 
-    cout << "1. Attack" << endl;
+    if (showOutput) {
+        PhaseTimer timer(BattlePhase::LOGGING);
+        ostream& frame = FrameRenderer::out();
+        frame << "1. Attack\n";
 
-    if (attacker->getAbilityStatus() == SpecialAbilityStatus::READY) {
-        cout << "2. Use Special Ability: " << attacker->getSpecialAbilityName() << " (READY)" << endl;
+        if (attacker->getAbilityStatus() == SpecialAbilityStatus::READY) {
+            frame << "2. Use Special Ability: " << attacker->getSpecialAbilityName() << " (READY)\n";
+        }
+        else {
+            frame << "Special Ability: " << attacker->getSpecialAbilityName()
+                << " (COOLDOWN: " << attacker->getCurrentCooldown() << " turns remaining)\n";
+        }
+        TablebaseProbe solved;
+        if (tablebase && tablebase->probe(*attacker, *defender, solved)) {
+            frame << "Perfect play: " << attacker->getName() << " "
+                << (solved.outcome == TablebaseOutcome::WIN ? "wins" : solved.outcome == TablebaseOutcome::LOSS ? "loses" : "draws")
+                << " (best: " << (solved.bestAction == BattleAction::ATTACK ? string("Attack") : attacker->getSpecialAbilityName())
+                << ")\n";
+        }
     }
-    else {
-        cout << "Special Ability: " << attacker->getSpecialAbilityName()
-            << " (COOLDOWN: " << attacker->getCurrentCooldown() << " turns remaining)" << endl;
+    if (!headless) {
+        // The player needs the menu before the prompt
+        FrameRenderer::endFrame();
     }
 
-    int choice;
-    if (attacker->getAbilityStatus() == SpecialAbilityStatus::READY) {
-        cout << "Enter your choice (1-2): ";
-        while (!(cin >> choice) || (choice != 1 && choice != 2)) {
-            cin.clear();
-            cin.ignore(numeric_limits<streamsize>::max(), '\n');
-            cout << "Invalid input. Please enter 1 or 2: ";
-        }
+    BattleAction action;
+    {
+        PhaseTimer timer(BattlePhase::INPUT_WAIT);
+        action = policy.chooseAction(*attacker, *defender, turnNumber, random);
     }
-    else {
-        cout << "Enter your choice (1): ";
-        while (!(cin >> choice) || choice != 1) {
-            cin.clear();
-            cin.ignore(numeric_limits<streamsize>::max(), '\n');
-            cout << "Special ability is on cooldown. Please enter 1 to attack: ";
-        }
+    // A policy may not use an ability that is still on cooldown
+    if (attacker->getAbilityStatus() != SpecialAbilityStatus::READY) {
+        action = BattleAction::ATTACK;
     }
-    cin.ignore(numeric_limits<streamsize>::max(), '\n');
 
     // ===== PERFORM ACTION =====
-    if (choice == 1) {
-        // Check for defensive abilities on defender
-        bool skipAttack = false;
-
-        if (defender->getClassName() == "Warrior") {
-            Warrior* w = dynamic_cast<Warrior*>(defender);
-            if (w && w->isTransparentActive()) {
-                cout << attacker->getName() << "'s attack passes through " << defender->getName() << "'s transparent form!" << endl;
-                Character::logAction(attacker->getName() + "'s attack missed due to Transparent.");
-                skipAttack = true;
-            }
-        }
-        else if (defender->getClassName() == "Mage") {
-            Mage* m = dynamic_cast<Mage*>(defender);
-            if (m && m->isMirrorImageActive()) {
-                cout << attacker->getName() << "'s attack is fooled by " << defender->getName() << "'s mirror image!" << endl;
-                Character::logAction(attacker->getName() + "'s attack missed due to Mirror Image.");
-                m->deactivateMirrorImage();
-                skipAttack = true;
-            }
-        }
-        else if (defender->getClassName() == "Archer") {
-            Archer* a = dynamic_cast<Archer*>(defender);
-            if (a && a->isEvasiveRollActive()) {
-                cout << defender->getName() << " dodges the attack with an Evasive Roll!" << endl;
-                Character::logAction(attacker->getName() + "'s attack missed due to Evasive Roll.");
-                a->deactivateEvasiveRoll();
-                skipAttack = true;
-            }
-        }
-
-        if (!skipAttack) {
+    PhaseTimer resolutionTimer(BattlePhase::ACTION_RESOLUTION);
+    int attackerHealthBefore = attacker->getHealth();
+    if (action == BattleAction::ATTACK) {
+        BattleInstrumentation::count(BattleCounter::ATTACKS);
+        // Defensive abilities on the defender may avoid the attack entirely
+        if (!defender->negatesIncomingAttack(*attacker)) {
             int beforeHP = defender->getHealth();
             attacker->attackTarget(*defender);
-            int damage = beforeHP - defender->getHealth();
-
-            if (defender->getClassName() == "MirrorStriker") {
-                MirrorStriker* ms = dynamic_cast<MirrorStriker*>(defender);
-                if (ms && ms->isMirrorStrikeActive()) {
-                    ms->reflectDamage(damage, *attacker);
-                }
-            }
+            defender->onDamageTaken(beforeHP - defender->getHealth(), *attacker);
+        }
+        else {
+            BattleInstrumentation::count(BattleCounter::DODGES);
         }
     }
     else {
+        BattleInstrumentation::count(BattleCounter::ABILITY_ACTIVATIONS);
         // Use special ability
-        cout << attacker->getName() << " uses " << attacker->getSpecialAbilityName() << "!" << endl;
-        Character::logAction(attacker->getName() + " uses special ability: " + attacker->getSpecialAbilityName());
+        Character::logEvent(LogEventType::SPECIAL_ABILITY, *attacker, nullptr);
         attacker->useSpecialAbility();
+        Character::traceEvent(TraceEventType::ABILITY_USED, attacker, attacker->getSpecialAbilityCooldown(), 0);
 
         // Handle Archer auto-attack after activating ability
-        if (attacker->getClassName() == "Archer") {
-            Archer* archer = dynamic_cast<Archer*>(attacker);
-            if (archer && archer->isEvasiveRollActive()) {
-                cout << attacker->getName() << " attacks while in evasive stance!" << endl;
-                int beforeHP = defender->getHealth();
-                attacker->attackTarget(*defender);
-                int damage = beforeHP - defender->getHealth();
-                if (defender->getClassName() == "MirrorStriker") {
-                    MirrorStriker* ms = dynamic_cast<MirrorStriker*>(defender);
-                    if (ms && ms->isMirrorStrikeActive()) {
-                        ms->reflectDamage(damage, *attacker);
-                    }
-                }
-            }
+        if (attacker->attacksAfterAbility()) {
+            Character::logEvent(LogEventType::EVASIVE_ATTACK, *attacker, defender);
+            int beforeHP = defender->getHealth();
+            attacker->attackTarget(*defender);
+            defender->onDamageTaken(beforeHP - defender->getHealth(), *attacker);
         }
 
         // Reset cooldown only if ability was used
         attacker->resetCooldown();
-        Character::logAction(attacker->getName() + "'s ability is now on cooldown (" +
-            to_string(attacker->getCurrentCooldown()) + " turns).");
+        Character::logEvent(LogEventType::COOLDOWN_RESET, *attacker, nullptr, attacker->getCurrentCooldown());
+    }
+    if (attacker->getHealth() < attackerHealthBefore) {
+        BattleInstrumentation::count(BattleCounter::REFLECTIONS); // Only Mirror Strike hurts the attacker
     }
 
     // ===== Update Display =====
-    cout << "\nUpdated Stats:" << endl;
-    cout << attacker->getName() << ": " << attacker->getHealth() << "/" << attacker->getMaxHealth() << " HP" << endl;
-    cout << defender->getName() << ": " << defender->getHealth() << "/" << defender->getMaxHealth() << " HP" << endl;
+    if (showOutput) {
+        PhaseTimer timer(BattlePhase::LOGGING);
+        ostream& frame = FrameRenderer::out();
+        frame << "\nUpdated Stats:\n";
+        frame << attacker->getName() << ": " << attacker->getHealth() << "/" << attacker->getMaxHealth() << " HP\n";
+        frame << defender->getName() << ": " << defender->getHealth() << "/" << defender->getMaxHealth() << " HP\n";
+    }
 
-    Character::logAction(attacker->getName() + " HP: " + to_string(attacker->getHealth()) + "/" + to_string(attacker->getMaxHealth()));
-    Character::logAction(defender->getName() + " HP: " + to_string(defender->getHealth()) + "/" + to_string(defender->getMaxHealth()));
+    Character::logEvent(LogEventType::HEALTH, *attacker, nullptr, attacker->getHealth(), attacker->getMaxHealth());
+    Character::logEvent(LogEventType::HEALTH, *defender, nullptr, defender->getHealth(), defender->getMaxHealth());
 }
 
     void Arena::openLogFile() {
-        // Open the log file for writing
-        std::ofstream logFile(logFileName);
-
-        if (logFile.is_open()) {
-            // Get current time
-            time_t now = time(0);
-            char timeStr[100];
-            strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", localtime(&now));
-
-            logFile << "=== Fantasy Arena Battle Log ===" << endl;
-            logFile << "Arena: " << name << " (" << getEnvironmentName() << " environment)" << endl;
-            logFile << "Log started at: " << timeStr << endl;
-            logFile << "===============================" << std::endl << std::endl;
-
-            logFile.close();
-            isLogFileOpen = true;
+        closeLogFile();
+        if (!logSink) {
+            logSink.reset(new AsyncLogSink());
+        }
+        // One file per battle, shared by the arena and both characters
+        time_t now = time(0);
+        char fileStamp[32];
+        char timeStr[100];
+        strftime(fileStamp, sizeof(fileStamp), "%Y%m%d_%H%M%S", localtime(&now));
+        strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", localtime(&now));
+        logFileName = getEnvironmentName() + "_battle_log_" + fileStamp + ".txt";
+
+        string header = "=== Fantasy Arena Battle Log: " + getEnvironmentName() + " Environment ===\n";
+        header += "Arena: " + name + "\n";
+        header += "Log started at: " + string(timeStr) + "\n";
+        header += "===============================\n\n";
+        if (logSink->openFile(logFileName, header)) {
+            Character::attachLogSink(logSink.get());
         }
         else {
             std::cerr << "Error: Could not open log file." << std::endl;
@@ -300,59 +598,59 @@ void Arena::processTurn(Character* attacker, Character* defender, int turnNumber
     }
 
     void Arena::logEvent(const std::string& event) {
-        // Open the log file in append mode
-        std::ofstream logFile(logFileName, std::ios::app);
+        if (logSink && logSink->isOpen()) {
+            logSink->write(event);
+        }
+    }
 
-        if (logFile.is_open()) {
-            // Get current time
+    void Arena::closeLogFile() {
+        if (logSink && logSink->isOpen()) {
             time_t now = time(0);
             char timeStr[100];
-            strftime(timeStr, sizeof(timeStr), "%H:%M:%S", localtime(&now));
-
-            logFile << "[" << timeStr << "] " << event << std::endl;
-            logFile.close();
+            strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", localtime(&now));
+            if (Character::getLogSink() == logSink.get()) {
+                Character::attachLogSink(nullptr);
+            }
+            // Blocks until every queued line has reached the file
+            logSink->closeFile("\nLog closed at: " + string(timeStr) + "\n");
         }
     }
 
-    void Arena::closeLogFile() {
-        if (isLogFileOpen) {
-            // Open the log file in append mode
-            std::ofstream logFile(logFileName, std::ios::app);
-
-            if (logFile.is_open()) {
-                // Get current time
-                time_t now = time(0);
-                char timeStr[100];
-                strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", localtime(&now));
-
-                logFile << std::endl << "Log closed at: " << timeStr << std::endl;
-                logFile.close();
-            }
+    void Arena::setTraceWriter(BattleTraceWriter* writer) {
+        traceWriter = writer;
+    }
+
+    void Arena::setTablebase(const Tablebase* solved) {
+        tablebase = solved;
+    }
+
+    void Arena::setBattleSeed(uint64_t seed, uint64_t stream) {
+        random.reseed(seed, stream);
+    }
+
+    uint64_t Arena::getBattleSeed() const {
+        return random.getSeed();
+    }
+
+    uint64_t Arena::getBattleStream() const {
+        return random.getStream();
+    }
+
+    bool Arena::isLogOpen() const {
+        return logSink && logSink->isOpen();
+    }
 
-            isLogFileOpen = false;
+    void Arena::configureLogSink(const LogSinkConfig& config) {
+        if (!logSink) {
+            logSink.reset(new AsyncLogSink());
         }
+        logSink->setConfig(config);
     }
+
     std::ostream& operator<<(std::ostream& os, const Arena& arena) {
         os << "Arena: " << arena.name << "\n"
             << "Environment: " << arena.getEnvironmentName() << "\n";
-        // Add environment-specific descriptions
-        switch (arena.environmentType) {
-        case EnvironmentType::FIRE:
-            os << "Effects: Increases attack by 20%, reduces defense by 10%\n";
-            break;
-        case EnvironmentType::ICE:
-            os << "Effects: Reduces attack by 10%, increases defense by 20%\n";
-            break;
-        case EnvironmentType::JUNGLE:
-            os << "Effects: Increases attack and defense by 10%\n";
-            break;
-        case EnvironmentType::DESERT:
-            os << "Effects: Increases attack by 30%, reduces health by 10%\n";
-            break;
-        case EnvironmentType::MOUNTAIN:
-            os << "Effects: Reduces attack by 20%, increases defense by 40%\n";
-            break;
-        }
+        os << "Effects: " << describeEnvironmentModifiers(arena.environmentType) << "\n";
         return os;
     }
     void Arena::checkAndDeactivateAbilities(Character* character) {
@@ -365,134 +663,23 @@ void Arena::processTurn(Character* attacker, Character* defender, int turnNumber
 
     // New method that checks and deactivates abilities without affecting cooldown
     void Arena::checkAndDeactivateAbilitiesWithoutCooldown(Character* character) {
-        // Check for Warrior's Transparent ability
-        if (character->getClassName() == "Warrior") {
-            Warrior* warrior = dynamic_cast<Warrior*>(character);
-            if (warrior && warrior->isTransparentActive()) {
-                // Deactivate Transparent after one turn
-                warrior->deactivateTransparent();
-            }
-        }
-        // Check for Mage's Mirror Image - deactivate at end of turn if not used
-        else if (character->getClassName() == "Mage") {
-            Mage* mage = dynamic_cast<Mage*>(character);
-            if (mage && mage->isMirrorImageActive()) {
-                mage->deactivateMirrorImage();
-            }
-        }
-        // Check for Archer's Evasive Roll - deactivate at end of turn if not used
-        else if (character->getClassName() == "Archer") {
-            Archer* archer = dynamic_cast<Archer*>(character);
-            if (archer && archer->isEvasiveRollActive()) {
-                archer->deactivateEvasiveRoll();
-            }
-        }
-        // Check for MirrorStriker's Mirror Strike
-        else if (character->getClassName() == "MirrorStriker") {
-            MirrorStriker* mirrorStriker = dynamic_cast<MirrorStriker*>(character);
-            if (mirrorStriker && mirrorStriker->isMirrorStrikeActive()) {
-                mirrorStriker->deactivateMirrorStrike();
-            }
-        }
+        // One-turn abilities (Transparent, Mirror Image, Evasive Roll, Mirror Strike)
+        // end at the start of their owner's next turn
+        character->expireAbilities();
     }
 
     void Arena::displayActiveAbilities(Character* character) {
-        cout << "\n=== " << character->getName() << "'s Status ===" << endl;
-        cout << "Health: " << character->getHealth() << "/" << character->getMaxHealth() << endl;
+        ostream& frame = FrameRenderer::out();
+        frame << "\n=== " << character->getName() << "'s Status ===\n";
+        frame << "Health: " << character->getHealth() << "/" << character->getMaxHealth() << "\n";
 
         // Display cooldown status regardless of active abilities
         if (character->getAbilityStatus() == SpecialAbilityStatus::COOLDOWN) {
-            cout << "Ability Cooldown: " << character->getCurrentCooldown() << " turns remaining" << endl;
+            frame << "Ability Cooldown: " << character->getCurrentCooldown() << " turns remaining\n";
         }
 
-        bool hasActiveAbility = false;
-
-        // Check for Warrior's Transparent ability
-        if (character->getClassName() == "Warrior") {
-            Warrior* warrior = dynamic_cast<Warrior*>(character);
-            if (warrior && warrior->isTransparentActive()) {
-                cout << "[Active] Transparent - Immune to all attacks for this turn!" << endl;
-                hasActiveAbility = true;
-            }
-            else if (warrior) {
-                if (character->getAbilityStatus() == SpecialAbilityStatus::COOLDOWN) {
-                    cout << "[Cooldown] Transparent - Ready in " << character->getCurrentCooldown() << " turns" << endl;
-                }
-                else {
-                    cout << "[Ready] Transparent - Use special ability to become immune to attacks" << endl;
-                }
-                hasActiveAbility = true;
-            }
-        }
-        // Check for Mage's Mirror Image
-        else if (character->getClassName() == "Mage") {
-            Mage* mage = dynamic_cast<Mage*>(character);
-            if (mage && mage->isMirrorImageActive()) {
-                cout << "[Active] Mirror Image - Next attack will miss completely!" << endl;
-                hasActiveAbility = true;
-            }
-            else if (mage) {
-                if (character->getAbilityStatus() == SpecialAbilityStatus::COOLDOWN) {
-                    cout << "[Cooldown] Mirror Image - Ready in " << character->getCurrentCooldown() << " turns" << endl;
-                }
-                else {
-                    cout << "[Ready] Mirror Image - Use special ability to make the next attack miss" << endl;
-                }
-                hasActiveAbility = true;
-            }
-        }
-        // Check for Archer's Evasive Roll
-        else if (character->getClassName() == "Archer") {
-            Archer* archer = dynamic_cast<Archer*>(character);
-            if (archer && archer->isEvasiveRollActive()) {
-                cout << "[Active] Evasive Roll - Next attack will be dodged completely!" << endl;
-                hasActiveAbility = true;
-            }
-            else if (archer) {
-                if (character->getAbilityStatus() == SpecialAbilityStatus::COOLDOWN) {
-                    cout << "[Cooldown] Evasive Roll - Ready in " << character->getCurrentCooldown() << " turns" << endl;
-                }
-                else {
-                    cout << "[Ready] Evasive Roll - Use special ability to dodge the next attack" << endl;
-                }
-                hasActiveAbility = true;
-            }
-        }
-        // Check for LegendaryCharacter's Resurrection
-        else if (character->getClassName() == "LegendaryCharacter") {
-            LegendaryCharacter* legendary = dynamic_cast<LegendaryCharacter*>(character);
-            if (legendary) {
-                if (legendary->hasResurrected()) {
-                    cout << "[Used] Resurrection - Already used once this battle" << endl;
-                }
-                else {
-                    cout << "[Passive] Resurrection - Will revive once with 25% health upon death" << endl;
-                }
-                hasActiveAbility = true;
-            }
-        }
-        // Check for MirrorStriker's Mirror Strike
-        else if (character->getClassName() == "MirrorStriker") {
-            MirrorStriker* mirrorStriker = dynamic_cast<MirrorStriker*>(character);
-            if (mirrorStriker && mirrorStriker->isMirrorStrikeActive()) {
-                cout << "[Active] Mirror Strike - Reflects 25% of damage back to attacker!" << endl;
-                hasActiveAbility = true;
-            }
-            else if (mirrorStriker) {
-                if (character->getAbilityStatus() == SpecialAbilityStatus::COOLDOWN) {
-                    cout << "[Cooldown] Mirror Strike - Ready in " << character->getCurrentCooldown() << " turns" << endl;
-                }
-                else {
-                    cout << "[Ready] Mirror Strike - Use special ability to activate" << endl;
-                }
-                hasActiveAbility = true;
-            }
-        }
-
-        if (!hasActiveAbility) {
-            cout << "No active abilities" << endl;
-        }
+        character->displayAbilityStatus(frame);
 
-        cout << "====================" << endl;
+        frame << "====================\n";
     }
 } // namespace FantasyArena
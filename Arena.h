@@ -5,9 +5,28 @@
 #include <iostream>
 #include <fstream>
 #include <ctime>
+#include <memory>
+#include <vector>
 #include "Character.h"
+#include "ActionPolicy.h"
+#include "BattleRandom.h"
+#include "TeamBattle.h"
 using namespace std;
 namespace FantasyArena {
+    class Tablebase;
+    // Outcome of a single battle
+    struct BattleResult {
+        int winner;        // 1 or 2
+        int turns;         // Number of turns played
+        int winnerHealth;  // Health the winner finished with
+    };
+    // A battle between two turns: everything needed to continue it exactly
+    struct BattleCheckpoint {
+        int turnNumber;          // Next turn to play
+        int attacker;            // Player of that turn, 1 or 2
+        uint64_t randomPosition; // Position of the battle random engine in its stream
+        CombatState fighters[2]; // Player 1, player 2
+    };
     enum class EnvironmentType {
         FIRE,
         ICE,
@@ -15,15 +34,34 @@ namespace FantasyArena {
         DESERT,
         MOUNTAIN
     };
+    // Display name by type, for code without an Arena (e.g. statistics)
+    string getEnvironmentNameForType(EnvironmentType environmentType);
     class Arena {
     private:
         string name;
         EnvironmentType environmentType;
         string logFileName;
-        bool isLogFileOpen;
+        unique_ptr<AsyncLogSink> logSink; // Buffered battle log, shared with Character::logAction
         int playerChoice; // Store player's action choice
+        BattleTraceWriter* traceWriter; // Optional binary trace, not owned
+        const Tablebase* tablebase; // Optional solved outcomes shown each turn, not owned
+        bool headless; // No console output, pauses or arena log file
+        BattleRandom random; // Restarted from (seed, stream) at the start of every battle
+        bool suspended; // The last interactive battle was saved and quit
+        BattleCheckpoint suspendedBattle;
+        // Kept between team battles, so a warm arena schedules without allocating
+        InitiativeQueue initiative;
+        TargetIndex targetIndex;
+        // Shared turn loop for interactive and simulated battles; continues
+        // from `resumeFrom` instead of the start if given
+        BattleResult runBattle(Character* player1, Character* player2, ActionPolicy& policy1, ActionPolicy& policy2,
+            const BattleCheckpoint* resumeFrom = nullptr);
     public:
         Arena(const string& name, EnvironmentType environmentType);
+        Arena(const Arena& other); // Copies the settings, never an open log
+        Arena& operator=(const Arena& other);
+        Arena(Arena&& other) noexcept = default;
+        Arena& operator=(Arena&& other) noexcept = default;
         ~Arena();
         // Getters
         string getName() const;
@@ -31,13 +69,44 @@ namespace FantasyArena {
         string getEnvironmentName() const;
         // Apply environmental effects to characters
         void applyEnvironmentalEffects(Character* character);
+        void applyEnvironmentModifiers(Character& character) const; // Stat changes only, no output
+
         // Battle methods
-        void startBattle(Character* player1, Character* player2);
-        void processTurn(Character* attacker, Character* defender, int turnNumber);
+        // Battles fight on pooled copies of the two characters, which are left unchanged.
+        // The result has winner 0 if the player saved and quit.
+        BattleResult startBattle(const Character& player1, const Character& player2);
+        // Interactive battle with a chosen controller per player, e.g. a SearchPolicy opponent
+        BattleResult startBattle(const Character& player1, const Character& player2, ActionPolicy& player1Policy,
+            ActionPolicy& player2Policy);
+        // Continue a battle saved with "S" at a turn prompt; needs the seed it was played with
+        BattleResult resumeBattle(const Character& player1, const Character& player2, ActionPolicy& player1Policy,
+            ActionPolicy& player2Policy, const BattleCheckpoint& checkpoint);
+        // After startBattle or resumeBattle: true if the player saved and quit
+        bool isBattleSuspended() const { return suspended; }
+        const BattleCheckpoint& getSuspendedBattle() const { return suspendedBattle; }
+        BattleResult simulateBattle(const Character& player1, const Character& player2, ActionPolicy& policy1, ActionPolicy& policy2);
+        // Headless battle between any number of fighters: fighter i fights for
+        // team teams[i] (from 0) with policies[i], so one fighter per team is a
+        // free-for-all. Fighters act in initiative order and attack the best
+        // enemy under `rule`; a turn costs O(log n) in the number of fighters.
+        // Pooled copies fight, as in simulateBattle. No trace is recorded.
+        TeamBattleResult simulateTeamBattle(const vector<const Character*>& fighters, const vector<int>& teams,
+            const vector<ActionPolicy*>& policies, TargetRule rule);
+        void processTurn(Character* attacker, Character* defender, int turnNumber, ActionPolicy& policy);
         // Logging methods
         void openLogFile();
         void logEvent(const string& event);
         void closeLogFile();
+        bool isLogOpen() const;
+        // Record following battles into a binary trace (nullptr to stop)
+        void setTraceWriter(BattleTraceWriter* writer);
+        // Show the perfect-play outcome before every move (nullptr to stop)
+        void setTablebase(const Tablebase* solved);
+        void configureLogSink(const LogSinkConfig& config); // Applies from the next openLogFile
+        // Seed for the following battles; the same seed and stream replay a battle exactly
+        void setBattleSeed(uint64_t seed, uint64_t stream = 0);
+        uint64_t getBattleSeed() const;
+        uint64_t getBattleStream() const;
         // Ability management methods
         void checkAndDeactivateAbilities(Character* character);
         void checkAndDeactivateAbilitiesWithoutCooldown(Character* character);
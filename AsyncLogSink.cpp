@@ -0,0 +1,220 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include "AsyncLogSink.h"
+#include <chrono>
+using namespace std;
+namespace FantasyArena {
+    LogSinkConfig defaultLogSinkConfig() {
+        LogSinkConfig config;
+        config.queueCapacity = 4096;
+        config.flushIntervalMs = 100;
+        config.batchBytes = 64 * 1024;
+        config.overflowPolicy = LogOverflowPolicy::BLOCK;
+        return config;
+    }
+
+    AsyncLogSink::AsyncLogSink(const LogSinkConfig& config)
+        : config(config), mask(0), enqueuePosition(0), dequeuePosition(0), open(false), stopRequested(false),
+        activeWriters(0), droppedMessages(0), cachedSecond(0), nameCount(0) {
+        cachedStamp[0] = '\0';
+    }
+
+    AsyncLogSink::~AsyncLogSink() {
+        closeFile("");
+    }
+
+    void AsyncLogSink::setConfig(const LogSinkConfig& newConfig) {
+        config = newConfig;
+    }
+
+    const LogSinkConfig& AsyncLogSink::getConfig() const {
+        return config;
+    }
+
+    bool AsyncLogSink::openFile(const string& fileName, const string& header) {
+        closeFile("");
+        file.open(fileName);
+        if (!file.is_open()) {
+            return false;
+        }
+        file << header;
+
+        // Bounded ring in the style of Vyukov's MPMC queue: a slot is free for
+        // position p when its sequence equals p, and full when it equals p + 1
+        size_t capacity = 2;
+        while (capacity < config.queueCapacity) {
+            capacity <<= 1;
+        }
+        slots = vector<Slot>(capacity);
+        for (size_t i = 0; i < capacity; ++i) {
+            slots[i].sequence.store(i, memory_order_relaxed);
+        }
+        mask = capacity - 1;
+        enqueuePosition.store(0, memory_order_relaxed);
+        dequeuePosition = 0;
+        droppedMessages.store(0, memory_order_relaxed);
+        cachedSecond = 0;
+        nameCount = 0;
+
+        stopRequested.store(false, memory_order_relaxed);
+        open.store(true, memory_order_release);
+        worker = thread(&AsyncLogSink::run, this);
+        return true;
+    }
+
+    void AsyncLogSink::closeFile(const string& footer) {
+        if (!open.exchange(false, memory_order_seq_cst)) {
+            return;
+        }
+        // Writers that saw the sink open finish their push before the final drain.
+        // Each side stores its flag, then loads the other's; only seq_cst orders
+        // that store before the load on every architecture
+        while (activeWriters.load(memory_order_seq_cst) != 0) {
+            this_thread::yield();
+        }
+        stopRequested.store(true, memory_order_release);
+        wakeSignal.notify_one();
+        worker.join();
+        file << footer;
+        file.close();
+        slots.clear();
+    }
+
+    bool AsyncLogSink::isOpen() const {
+        return open.load(memory_order_acquire);
+    }
+
+    uint64_t AsyncLogSink::getDroppedCount() const {
+        return droppedMessages.load(memory_order_relaxed);
+    }
+
+    void AsyncLogSink::write(const string& message) {
+        LogEvent event = {};
+        event.type = LogEventType::TEXT;
+        push(event, &message);
+    }
+
+    void AsyncLogSink::write(const LogEvent& event) {
+        push(event, nullptr);
+    }
+
+    uint8_t AsyncLogSink::internName(const string& name) {
+        for (size_t i = 0; i < nameCount; ++i) {
+            if (names[i] == name) {
+                return static_cast<uint8_t>(i);
+            }
+        }
+        if (nameCount == LOG_NAME_CAPACITY) {
+            return LOG_NAME_UNKNOWN;
+        }
+        names[nameCount] = name;
+        return static_cast<uint8_t>(nameCount++);
+    }
+
+    const string& AsyncLogSink::nameForHandle(uint8_t handle) const {
+        static const string unknown = "?";
+        return handle < LOG_NAME_CAPACITY ? names[handle] : unknown;
+    }
+
+    void AsyncLogSink::push(const LogEvent& event, const string* message) {
+        activeWriters.fetch_add(1, memory_order_seq_cst);
+        if (open.load(memory_order_seq_cst)) {
+            time_t now = time(nullptr);
+            while (!tryPush(now, event, message)) {
+                if (config.overflowPolicy == LogOverflowPolicy::DROP) {
+                    droppedMessages.fetch_add(1, memory_order_relaxed);
+                    break;
+                }
+                wakeSignal.notify_one();
+                this_thread::yield();
+            }
+        }
+        activeWriters.fetch_sub(1, memory_order_acq_rel);
+    }
+
+    bool AsyncLogSink::tryPush(time_t timestamp, const LogEvent& event, const string* message) {
+        size_t position = enqueuePosition.load(memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &slots[position & mask];
+            size_t sequence = slot->sequence.load(memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0) {
+                if (enqueuePosition.compare_exchange_weak(position, position + 1, memory_order_relaxed)) {
+                    break;
+                }
+            }
+            else if (difference < 0) {
+                return false; // Queue is full
+            }
+            else {
+                position = enqueuePosition.load(memory_order_relaxed);
+            }
+        }
+        slot->timestamp = timestamp;
+        slot->event = event;
+        if (message) {
+            slot->message.assign(*message); // Reuses the slot's capacity after warm-up
+        }
+        slot->sequence.store(position + 1, memory_order_release);
+        return true;
+    }
+
+    size_t AsyncLogSink::drainInto(string& buffer) {
+        size_t count = 0;
+        for (;;) {
+            Slot& slot = slots[dequeuePosition & mask];
+            if (slot.sequence.load(memory_order_acquire) != dequeuePosition + 1) {
+                break;
+            }
+            if (slot.timestamp != cachedSecond) {
+                cachedSecond = slot.timestamp;
+                strftime(cachedStamp, sizeof(cachedStamp), "[%H:%M:%S] ", localtime(&cachedSecond));
+            }
+            size_t lineStart = buffer.size();
+            buffer += cachedStamp;
+            if (slot.event.type == LogEventType::TEXT) {
+                buffer += slot.message;
+                slot.message.clear();
+                buffer += '\n';
+            }
+            else if (formatLogEvent(slot.event, LogView::FILE, nameForHandle(slot.event.actor),
+                nameForHandle(slot.event.target), buffer)) {
+                buffer += '\n';
+            }
+            else {
+                buffer.resize(lineStart); // No file text for this event
+            }
+            slot.sequence.store(dequeuePosition + mask + 1, memory_order_release);
+            ++dequeuePosition;
+            ++count;
+        }
+        return count;
+    }
+
+    void AsyncLogSink::run() {
+        string buffer;
+        buffer.reserve(config.batchBytes + 1024);
+        auto lastFlush = chrono::steady_clock::now();
+        const auto flushInterval = chrono::milliseconds(config.flushIntervalMs);
+        const auto idleWait = chrono::milliseconds(config.flushIntervalMs < 1 ? 1 : (config.flushIntervalMs < 5 ? config.flushIntervalMs : 5));
+        for (;;) {
+            // Read the stop flag before draining so nothing queued before it is missed
+            bool stopping = stopRequested.load(memory_order_acquire);
+            size_t drained = drainInto(buffer);
+            auto now = chrono::steady_clock::now();
+            if (buffer.size() >= config.batchBytes || (!buffer.empty() && (stopping || now - lastFlush >= flushInterval))) {
+                file.write(buffer.data(), static_cast<streamsize>(buffer.size()));
+                file.flush();
+                buffer.clear();
+                lastFlush = now;
+            }
+            if (stopping && drained == 0) {
+                break;
+            }
+            if (drained == 0) {
+                unique_lock<mutex> lock(wakeMutex);
+                wakeSignal.wait_for(lock, idleWait);
+            }
+        }
+    }
+} // namespace FantasyArena
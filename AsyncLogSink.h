@@ -0,0 +1,101 @@
+#pragma once
+#ifndef ASYNC_LOG_SINK_H
+#define ASYNC_LOG_SINK_H
+#include <string>
+#include <fstream>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <ctime>
+#include <cstdint>
+#include "LogEvent.h"
+using namespace std;
+namespace FantasyArena {
+    // What a writer does when the queue is full
+    enum class LogOverflowPolicy {
+        DROP,  // Discard the message and count it
+        BLOCK  // Wait until the background thread frees a slot
+    };
+
+    struct LogSinkConfig {
+        size_t queueCapacity;   // Messages in flight, rounded up to a power of two
+        int flushIntervalMs;    // Longest time a message waits before reaching the file
+        size_t batchBytes;      // Write as soon as this much text is buffered
+        LogOverflowPolicy overflowPolicy;
+    };
+
+    LogSinkConfig defaultLogSinkConfig();
+
+    const size_t LOG_NAME_CAPACITY = 16; // Names one log file can refer to
+
+    // Log file writer that moves formatting and file I/O off the battle thread.
+    // Writers push events into a bounded lock-free queue; a background thread
+    // drains it, turns each event into text, prefixes a cached "[HH:MM:SS]"
+    // timestamp and writes in batches.
+    class AsyncLogSink {
+    private:
+        struct Slot {
+            atomic<size_t> sequence;
+            time_t timestamp;
+            LogEvent event;
+            string message; // TEXT events only
+        };
+
+        LogSinkConfig config;
+        vector<Slot> slots;
+        size_t mask;
+        atomic<size_t> enqueuePosition;
+        size_t dequeuePosition; // Only touched by the background thread
+
+        ofstream file;
+        thread worker;
+        mutex wakeMutex;
+        condition_variable wakeSignal; // Lets a blocked writer wake the idle worker early
+        atomic<bool> open;
+        atomic<bool> stopRequested;
+        atomic<int> activeWriters;
+        atomic<uint64_t> droppedMessages;
+
+        // Per-second timestamp cache (background thread only)
+        time_t cachedSecond;
+        char cachedStamp[16];
+
+        // Names of the characters in the file's events, indexed by handle.
+        // Only appended to before the events that use them are queued.
+        string names[LOG_NAME_CAPACITY];
+        size_t nameCount;
+
+        bool tryPush(time_t timestamp, const LogEvent& event, const string* message);
+        void push(const LogEvent& event, const string* message);
+        const string& nameForHandle(uint8_t handle) const;
+        size_t drainInto(string& buffer);
+        void run();
+    public:
+        explicit AsyncLogSink(const LogSinkConfig& config = defaultLogSinkConfig());
+        ~AsyncLogSink();
+        AsyncLogSink(const AsyncLogSink&) = delete;
+        AsyncLogSink& operator=(const AsyncLogSink&) = delete;
+
+        // Only takes effect for the next open()
+        void setConfig(const LogSinkConfig& newConfig);
+        const LogSinkConfig& getConfig() const;
+
+        // Create the file, write the header synchronously and start the writer thread
+        bool openFile(const string& fileName, const string& header);
+        // Stop accepting messages, drain everything queued, write the footer and close
+        void closeFile(const string& footer);
+        bool isOpen() const;
+
+        // Queue one timestamped line
+        void write(const string& message);
+        // Queue an event; its text is built on the background thread
+        void write(const LogEvent& event);
+        // Handle of a name for events, LOG_NAME_UNKNOWN if the table is full.
+        // Call from the writing thread before queuing events that use it.
+        uint8_t internName(const string& name);
+        uint64_t getDroppedCount() const;
+    };
+} // namespace FantasyArena
+#endif // ASYNC_LOG_SINK_H
@@ -0,0 +1,270 @@
+#include "BatchCombat.h"
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FANTASY_ARENA_SSE2 1
+#include <emmintrin.h>
+#endif
+using namespace std;
+namespace FantasyArena {
+    // Lanes are padded to a multiple of the SIMD width
+    static const size_t LANE_WIDTH = 4;
+
+    void DuelSide::resize(size_t lanes) {
+        vector<int32_t>* columns[] = {
+            &health, &maxHealth, &attack, &defense, &cooldown, &cooldownLength, &abilityReady,
+            &abilityActive, &revived, &usesAbility, &isWarrior, &isArcher, &isMirrorStriker,
+            &negatesAttacks, &consumesNegate, &isLegendary, &hasTimedAbility
+        };
+        for (vector<int32_t>* column : columns) {
+            column->resize(lanes, 0);
+        }
+    }
+
+    BatchCombat::BatchCombat() : duelCount(0) {
+    }
+
+    static int32_t toMask(bool value) {
+        return value ? -1 : 0;
+    }
+
+    void BatchCombat::loadSide(int side, size_t lane, const Character& fighter, BatchPolicy policy) {
+        DuelSide& s = sides[side];
+        CharacterKind kind = fighter.getKind();
+        s.health[lane] = fighter.getHealth();
+        s.maxHealth[lane] = fighter.getMaxHealth();
+        s.attack[lane] = fighter.getAttack();
+        s.defense[lane] = fighter.getDefense();
+        s.cooldown[lane] = fighter.getCurrentCooldown();
+        s.cooldownLength[lane] = fighter.getSpecialAbilityCooldown();
+        s.abilityReady[lane] = toMask(fighter.getAbilityStatus() == SpecialAbilityStatus::READY);
+        s.abilityActive[lane] = toMask(fighter.isAbilityActive());
+        s.revived[lane] = toMask(kind == CharacterKind::LEGENDARY &&
+            static_cast<const LegendaryCharacter&>(fighter).hasResurrected());
+        s.usesAbility[lane] = toMask(policy == BatchPolicy::ABILITY_WHEN_READY);
+        s.isWarrior[lane] = toMask(kind == CharacterKind::WARRIOR);
+        s.isArcher[lane] = toMask(kind == CharacterKind::ARCHER);
+        s.isMirrorStriker[lane] = toMask(kind == CharacterKind::MIRROR_STRIKER);
+        s.negatesAttacks[lane] = toMask(kind == CharacterKind::WARRIOR || kind == CharacterKind::MAGE ||
+            kind == CharacterKind::ARCHER);
+        s.consumesNegate[lane] = toMask(kind == CharacterKind::MAGE || kind == CharacterKind::ARCHER);
+        s.isLegendary[lane] = toMask(kind == CharacterKind::LEGENDARY);
+        s.hasTimedAbility[lane] = toMask(kind != CharacterKind::LEGENDARY);
+    }
+
+    size_t BatchCombat::addDuel(const Arena& arena, const Character& player1, const Character& player2,
+        BatchPolicy policy1, BatchPolicy policy2) {
+        size_t lane = duelCount++;
+        size_t padded = (duelCount + LANE_WIDTH - 1) / LANE_WIDTH * LANE_WIDTH;
+        if (sides[0].health.size() < padded) {
+            sides[0].resize(padded);
+            sides[1].resize(padded);
+        }
+        // Apply the environment to copies so the stats match Arena::simulateBattle
+        Character* fighter1 = player1.clone();
+        Character* fighter2 = player2.clone();
+        arena.applyEnvironmentModifiers(*fighter1);
+        arena.applyEnvironmentModifiers(*fighter2);
+        loadSide(0, lane, *fighter1, policy1);
+        loadSide(1, lane, *fighter2, policy2);
+        delete fighter1;
+        delete fighter2;
+        return lane;
+    }
+
+    size_t BatchCombat::size() const {
+        return duelCount;
+    }
+
+    const vector<BattleResult>& BatchCombat::getResults() const {
+        return results;
+    }
+
+#ifdef FANTASY_ARENA_SSE2
+    // mask ? a : b
+    static inline __m128i select(__m128i mask, __m128i a, __m128i b) {
+        return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+    }
+
+    // Exact x / 3 for non-negative 32-bit lanes: (x * 0xAAAAAAAB) >> 33
+    static inline __m128i divideBy3(__m128i x) {
+        const __m128i magic = _mm_set1_epi32(static_cast<int32_t>(0xAAAAAAABu));
+        __m128i even = _mm_srli_epi64(_mm_mul_epu32(x, magic), 33);
+        __m128i odd = _mm_srli_epi64(_mm_mul_epu32(_mm_srli_epi64(x, 32), magic), 33);
+        return _mm_or_si128(even, _mm_slli_epi64(odd, 32));
+    }
+
+    static inline __m128i load(const int32_t* p) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+
+    static inline void store(int32_t* p, __m128i v) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+    }
+#endif
+
+    void BatchCombat::resolveAttacks(DuelSide& attacker, DuelSide& defender,
+        const int32_t* attacking, const int32_t* evasive, size_t lanes) {
+        size_t i = 0;
+#ifdef FANTASY_ARENA_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i one = _mm_set1_epi32(1);
+        for (; i + LANE_WIDTH <= lanes; i += LANE_WIDTH) {
+            __m128i active = load(attacking + i);
+            // Evasive Roll attacks ignore half of the target's defense
+            __m128i defense = load(&defender.defense[i]);
+            __m128i effective = select(load(evasive + i), _mm_srai_epi32(defense, 1), defense);
+            // Warrior: defense / 2, Archer: defense / 4, everyone else: defense / 3
+            __m128i reduction = select(load(&attacker.isWarrior[i]), _mm_srai_epi32(effective, 1),
+                select(load(&attacker.isArcher[i]), _mm_srai_epi32(effective, 2), divideBy3(effective)));
+            __m128i damage = _mm_sub_epi32(load(&attacker.attack[i]), reduction);
+            damage = select(_mm_cmplt_epi32(damage, one), one, damage);
+            // Health never drops below 0, so the damage dealt is min(damage, health)
+            __m128i health = load(&defender.health[i]);
+            __m128i dealt = select(_mm_cmpgt_epi32(damage, health), health, damage);
+            dealt = _mm_and_si128(dealt, active);
+            store(&defender.health[i], _mm_sub_epi32(health, dealt));
+            // Mirror Strike reflects 25% of the damage dealt, at least 1
+            __m128i reflecting = _mm_and_si128(active,
+                _mm_and_si128(load(&defender.isMirrorStriker[i]), load(&defender.abilityActive[i])));
+            __m128i reflected = _mm_srai_epi32(dealt, 2);
+            reflected = select(_mm_cmplt_epi32(reflected, one), one, reflected);
+            reflected = _mm_and_si128(reflected, reflecting);
+            __m128i attackerHealth = _mm_sub_epi32(load(&attacker.health[i]), reflected);
+            attackerHealth = _mm_andnot_si128(_mm_cmplt_epi32(attackerHealth, zero), attackerHealth);
+            store(&attacker.health[i], attackerHealth);
+        }
+#endif
+        // Scalar path (remaining lanes, or builds without SSE2); same formulas
+        for (; i < lanes; ++i) {
+            if (!attacking[i]) {
+                continue;
+            }
+            int32_t defense = defender.defense[i];
+            int32_t effective = evasive[i] ? (defense >> 1) : defense;
+            int32_t reduction = attacker.isWarrior[i] ? (effective >> 1) :
+                attacker.isArcher[i] ? (effective >> 2) : (effective / 3);
+            int32_t damage = attacker.attack[i] - reduction;
+            if (damage < 1) damage = 1;
+            int32_t dealt = damage > defender.health[i] ? defender.health[i] : damage;
+            defender.health[i] -= dealt;
+            if (defender.isMirrorStriker[i] && defender.abilityActive[i]) {
+                int32_t reflected = dealt >> 2;
+                if (reflected < 1) reflected = 1;
+                attacker.health[i] -= reflected;
+                if (attacker.health[i] < 0) attacker.health[i] = 0;
+            }
+        }
+    }
+
+    void BatchCombat::runTurn(int attackerSide, int turnNumber) {
+        DuelSide& a = sides[attackerSide];
+        DuelSide& d = sides[1 - attackerSide];
+        size_t lanes = attacking.size();
+
+        // Phase 1: cooldowns, ability expiry and action choice
+        for (size_t i = 0; i < lanes; ++i) {
+            attacking[i] = 0;
+            evasive[i] = 0;
+            if (finished[i]) {
+                continue;
+            }
+            if (turnNumber > 1 && a.cooldown[i] > 0) {
+                a.cooldown[i]--;
+                if (a.cooldown[i] == 0) {
+                    a.abilityReady[i] = -1;
+                }
+            }
+            // One-turn abilities end at the start of their owner's turn
+            a.abilityActive[i] = 0;
+
+            if (a.usesAbility[i] && a.abilityReady[i]) {
+                a.abilityActive[i] = a.hasTimedAbility[i];
+                a.cooldown[i] = a.cooldownLength[i];
+                a.abilityReady[i] = 0;
+                // The Archer attacks from the evasive stance in the same turn
+                attacking[i] = a.isArcher[i];
+                evasive[i] = a.isArcher[i];
+            }
+            else if (d.negatesAttacks[i] && d.abilityActive[i]) {
+                // Transparent stays up; Mirror Image and Evasive Roll are used up
+                if (d.consumesNegate[i]) {
+                    d.abilityActive[i] = 0;
+                }
+            }
+            else {
+                attacking[i] = -1;
+            }
+        }
+
+        // Phase 2: damage and reflection across all lanes at once
+        resolveAttacks(a, d, attacking.data(), evasive.data(), lanes);
+
+        // Phase 3: resurrection and battle end
+        for (size_t i = 0; i < lanes; ++i) {
+            if (finished[i]) {
+                continue;
+            }
+            if (evasive[i]) {
+                a.abilityActive[i] = 0;
+            }
+            int endTurn = 0;
+            if (d.health[i] <= 0) {
+                if (d.isLegendary[i] && !d.revived[i]) {
+                    d.health[i] = d.maxHealth[i] >> 2;
+                    d.revived[i] = -1;
+                }
+                else {
+                    endTurn = turnNumber;
+                }
+            }
+            if (endTurn == 0 && (a.health[i] <= 0 || d.health[i] <= 0)) {
+                endTurn = turnNumber + 1;
+            }
+            if (endTurn != 0) {
+                finished[i] = 1;
+                BattleResult& result = results[i];
+                result.winner = sides[0].health[i] > 0 ? 1 : 2;
+                result.turns = endTurn;
+                result.winnerHealth = sides[result.winner - 1].health[i];
+            }
+        }
+    }
+
+    void BatchCombat::run() {
+        size_t lanes = sides[0].health.size();
+        attacking.assign(lanes, 0);
+        evasive.assign(lanes, 0);
+        finished.assign(lanes, 1);
+        results.assign(duelCount, BattleResult());
+        size_t remaining = 0;
+        for (size_t i = 0; i < duelCount; ++i) {
+            finished[i] = (sides[0].health[i] > 0 && sides[1].health[i] > 0) ? 0 : 1;
+            if (finished[i]) {
+                results[i].winner = sides[0].health[i] > 0 ? 1 : 2;
+                results[i].turns = 1;
+                results[i].winnerHealth = sides[results[i].winner - 1].health[i];
+            }
+            else {
+                remaining++;
+            }
+        }
+        for (int turnNumber = 1; remaining > 0; ++turnNumber) {
+            runTurn((turnNumber % 2 == 1) ? 0 : 1, turnNumber);
+            remaining = 0;
+            for (size_t i = 0; i < duelCount; ++i) {
+                remaining += finished[i] ? 0 : 1;
+            }
+        }
+    }
+
+    bool toBatchPolicy(const string& name, BatchPolicy& policy) {
+        if (name == "attack") {
+            policy = BatchPolicy::ATTACK;
+            return true;
+        }
+        if (name == "ability") {
+            policy = BatchPolicy::ABILITY_WHEN_READY;
+            return true;
+        }
+        return false;
+    }
+} // namespace FantasyArena
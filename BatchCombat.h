@@ -0,0 +1,80 @@
+#pragma once
+#ifndef BATCH_COMBAT_H
+#define BATCH_COMBAT_H
+#include <vector>
+#include <cstdint>
+#include "Character.h"
+#include "Arena.h"
+using namespace std;
+namespace FantasyArena {
+    // Fixed per-side behaviour for batch duels (no per-turn virtual calls)
+    enum class BatchPolicy {
+        ATTACK,
+        ABILITY_WHEN_READY
+    };
+
+    // Combat state of one side of every duel, stored as parallel arrays.
+    // Flags are stored as 32-bit masks (0 or -1) so they can be loaded
+    // straight into SIMD registers next to the stats.
+    struct DuelSide {
+        vector<int32_t> health;
+        vector<int32_t> maxHealth;
+        vector<int32_t> attack;
+        vector<int32_t> defense;
+        vector<int32_t> cooldown;        // Turns until the ability is ready
+        vector<int32_t> cooldownLength;  // Cooldown after using the ability
+        vector<int32_t> abilityReady;
+        vector<int32_t> abilityActive;   // Transparent / Mirror Image / Evasive Roll / Mirror Strike
+        vector<int32_t> revived;
+        vector<int32_t> usesAbility;     // Policy: use the ability whenever it is ready
+        // Class masks, fixed for the lifetime of the lane
+        vector<int32_t> isWarrior;       // Damage divisor 2
+        vector<int32_t> isArcher;        // Damage divisor 4, evasive attack halves defense
+        vector<int32_t> isMirrorStriker; // Reflects damage while active
+        vector<int32_t> negatesAttacks;  // Active ability makes incoming attacks miss
+        vector<int32_t> consumesNegate;  // Negation ends the ability (Mage, Archer)
+        vector<int32_t> isLegendary;     // Resurrects once
+        vector<int32_t> hasTimedAbility; // Ability sets abilityActive when used
+
+        void resize(size_t lanes);
+    };
+
+    // Data-oriented battle engine: thousands of independent duels advanced in
+    // lockstep, one turn at a time. Attack resolution is evaluated across lanes
+    // with SSE2 where available. Results match Arena::simulateBattle exactly.
+    class BatchCombat {
+    private:
+        DuelSide sides[2];
+        vector<int32_t> attacking; // Lanes that resolve an attack this turn (mask)
+        vector<int32_t> evasive;   // Attacker lanes attacking from Evasive Roll (mask)
+        vector<uint8_t> finished;
+        vector<BattleResult> results;
+        size_t duelCount;
+
+        void loadSide(int side, size_t lane, const Character& fighter, BatchPolicy policy);
+        void runTurn(int attackerSide, int turnNumber);
+    public:
+        BatchCombat();
+
+        // Queue a duel. The fighters are copied and the arena's environment
+        // modifiers are applied to the copies; the originals are not changed.
+        size_t addDuel(const Arena& arena, const Character& player1, const Character& player2,
+            BatchPolicy policy1, BatchPolicy policy2);
+        size_t size() const;
+
+        // Run every queued duel to completion
+        void run();
+        const vector<BattleResult>& getResults() const;
+
+        // Attack resolution kernel: for every lane whose mask in `attacking` is set,
+        // the attacker hits the defender (damage = attack - defense / divisor, at
+        // least 1) and an active Mirror Strike reflects 25% back, all branch-free.
+        static void resolveAttacks(DuelSide& attacker, DuelSide& defender,
+            const int32_t* attacking, const int32_t* evasive, size_t lanes);
+    };
+
+    // Convert a headless policy name to its batch equivalent. Returns false for
+    // policies that need per-turn decisions (e.g. "random").
+    bool toBatchPolicy(const string& name, BatchPolicy& policy);
+} // namespace FantasyArena
+#endif // BATCH_COMBAT_H
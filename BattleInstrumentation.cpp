@@ -0,0 +1,127 @@
+#include "BattleInstrumentation.h"
+#include <iomanip>
+using namespace std;
+namespace FantasyArena {
+    thread_local BattleInstrumentation* BattleInstrumentation::current = nullptr;
+
+    string getBattleCounterName(BattleCounter counter) {
+        switch (counter) {
+        case BattleCounter::BATTLES:
+            return "Battles";
+        case BattleCounter::TURNS:
+            return "Turns";
+        case BattleCounter::ATTACKS:
+            return "Attacks";
+        case BattleCounter::ABILITY_ACTIVATIONS:
+            return "Ability activations";
+        case BattleCounter::DODGES:
+            return "Dodges";
+        case BattleCounter::REFLECTIONS:
+            return "Reflections";
+        case BattleCounter::RESURRECTIONS:
+            return "Resurrections";
+        default:
+            return "Unknown";
+        }
+    }
+
+    string getBattlePhaseName(BattlePhase phase) {
+        switch (phase) {
+        case BattlePhase::ENVIRONMENT:
+            return "Environment";
+        case BattlePhase::INPUT_WAIT:
+            return "Input wait";
+        case BattlePhase::ACTION_RESOLUTION:
+            return "Action resolution";
+        case BattlePhase::LOGGING:
+            return "Logging";
+        default:
+            return "Other";
+        }
+    }
+
+    BattleInstrumentation::BattleInstrumentation() {
+        reset();
+    }
+
+    void BattleInstrumentation::reset() {
+        for (int i = 0; i < BATTLE_COUNTER_COUNT; ++i) {
+            counters[i] = 0;
+        }
+        for (int i = 0; i < BATTLE_PHASE_COUNT; ++i) {
+            phaseNanoseconds[i] = 0;
+            phaseEntries[i] = 0;
+        }
+        battleNanoseconds = 0;
+        openPhase = BattlePhase::NONE;
+    }
+
+    void BattleInstrumentation::merge(const BattleInstrumentation& other) {
+        for (int i = 0; i < BATTLE_COUNTER_COUNT; ++i) {
+            counters[i] += other.counters[i];
+        }
+        for (int i = 0; i < BATTLE_PHASE_COUNT; ++i) {
+            phaseNanoseconds[i] += other.phaseNanoseconds[i];
+            phaseEntries[i] += other.phaseEntries[i];
+        }
+        battleNanoseconds += other.battleNanoseconds;
+    }
+
+    BattlePhase BattleInstrumentation::enterPhase(BattlePhase phase) {
+        chrono::steady_clock::time_point now = chrono::steady_clock::now();
+        if (openPhase != BattlePhase::NONE) {
+            phaseNanoseconds[static_cast<int>(openPhase)] += chrono::duration_cast<chrono::nanoseconds>(now - openSince).count();
+        }
+        BattlePhase interrupted = openPhase;
+        openPhase = phase;
+        openSince = now;
+        ++phaseEntries[static_cast<int>(phase)];
+        return interrupted;
+    }
+
+    void BattleInstrumentation::leavePhase(BattlePhase resumed) {
+        chrono::steady_clock::time_point now = chrono::steady_clock::now();
+        if (openPhase != BattlePhase::NONE) {
+            phaseNanoseconds[static_cast<int>(openPhase)] += chrono::duration_cast<chrono::nanoseconds>(now - openSince).count();
+        }
+        openPhase = resumed;
+        openSince = now;
+    }
+
+    void BattleInstrumentation::printReport(ostream& os, const string& title) const {
+        uint64_t battles = getCounter(BattleCounter::BATTLES);
+        os << "\n=== " << title << " ===" << endl;
+        os << fixed;
+        for (int i = 0; i < BATTLE_COUNTER_COUNT; ++i) {
+            os << left << setw(22) << getBattleCounterName(static_cast<BattleCounter>(i)) << right << setw(14) << counters[i];
+            if (battles > 0 && i != static_cast<int>(BattleCounter::BATTLES)) {
+                os << setprecision(2) << setw(12) << static_cast<double>(counters[i]) / battles << " per battle";
+            }
+            os << endl;
+        }
+        os << "\n" << left << setw(22) << "Phase" << right << setw(14) << "Time (ms)" << setw(14) << "Entries"
+            << setw(14) << "ns/entry" << setw(10) << "Share" << endl;
+        int64_t measured = 0;
+        for (int i = 0; i < BATTLE_PHASE_COUNT; ++i) {
+            measured += phaseNanoseconds[i];
+        }
+        // Battle time outside every phase: turn bookkeeping, console status lines, tracing
+        int64_t other = battleNanoseconds > measured ? battleNanoseconds - measured : 0;
+        for (int i = 0; i <= BATTLE_PHASE_COUNT; ++i) {
+            int64_t nanoseconds = i < BATTLE_PHASE_COUNT ? phaseNanoseconds[i] : other;
+            os << left << setw(22) << getBattlePhaseName(static_cast<BattlePhase>(i)) << right << setprecision(3)
+                << setw(14) << nanoseconds / 1e6;
+            if (i < BATTLE_PHASE_COUNT) {
+                os << setw(14) << phaseEntries[i] << setprecision(1) << setw(14)
+                    << (phaseEntries[i] > 0 ? static_cast<double>(nanoseconds) / phaseEntries[i] : 0.0);
+            }
+            else {
+                os << setw(28) << "";
+            }
+            os << setprecision(1) << setw(9) << (battleNanoseconds > 0 ? 100.0 * nanoseconds / battleNanoseconds : 0.0) << "%" << endl;
+        }
+        os << left << setw(22) << "Battle total" << right << setprecision(3) << setw(14) << battleNanoseconds / 1e6 << endl;
+        os.unsetf(ios::floatfield);
+        os << setprecision(6);
+    }
+} // namespace FantasyArena
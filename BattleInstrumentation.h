@@ -0,0 +1,97 @@
+#pragma once
+#ifndef BATTLE_INSTRUMENTATION_H
+#define BATTLE_INSTRUMENTATION_H
+#include <string>
+#include <iostream>
+#include <chrono>
+#include <cstdint>
+using namespace std;
+namespace FantasyArena {
+    enum class BattleCounter {
+        BATTLES,
+        TURNS,
+        ATTACKS,              // Plain attacks chosen, landed or not
+        ABILITY_ACTIVATIONS,
+        DODGES,               // Attacks negated by Transparent, Mirror Image or Evasive Roll
+        REFLECTIONS,          // Mirror Strike damage sent back
+        RESURRECTIONS,
+        COUNT
+    };
+
+    // Time is charged to the innermost open phase only, so nested phases
+    // (e.g. a log line written during action resolution) are not counted twice
+    enum class BattlePhase {
+        ENVIRONMENT,          // Applying arena modifiers at the start of a battle
+        INPUT_WAIT,           // Choosing an action (human or computer) and "Press Enter" prompts
+        ACTION_RESOLUTION,    // Attacks, abilities and their reactions
+        LOGGING,              // Writing log lines and console messages
+        COUNT,
+        NONE = COUNT
+    };
+
+    const int BATTLE_COUNTER_COUNT = static_cast<int>(BattleCounter::COUNT);
+    const int BATTLE_PHASE_COUNT = static_cast<int>(BattlePhase::COUNT);
+
+    string getBattleCounterName(BattleCounter counter);
+    string getBattlePhaseName(BattlePhase phase);
+
+    // Counters and phase timers of the battles run on one thread while it is
+    // attached. With nothing attached every hook is one thread-local load and
+    // a branch.
+    class BattleInstrumentation {
+    private:
+        static thread_local BattleInstrumentation* current;
+        uint64_t counters[BATTLE_COUNTER_COUNT];
+        int64_t phaseNanoseconds[BATTLE_PHASE_COUNT];
+        uint64_t phaseEntries[BATTLE_PHASE_COUNT];
+        int64_t battleNanoseconds; // Wall time inside the battle loop
+        BattlePhase openPhase;
+        chrono::steady_clock::time_point openSince;
+    public:
+        BattleInstrumentation();
+        void reset();
+        void merge(const BattleInstrumentation& other);
+
+        // Instrument the calling thread's battles (nullptr to stop)
+        static void attach(BattleInstrumentation* instrumentation) { current = instrumentation; }
+        static BattleInstrumentation* getCurrent() { return current; }
+        static void count(BattleCounter counter) {
+            if (current) {
+                ++current->counters[static_cast<int>(counter)];
+            }
+        }
+
+        BattlePhase enterPhase(BattlePhase phase); // Returns the phase it interrupted
+        void leavePhase(BattlePhase resumed);
+        void addBattleTime(int64_t nanoseconds) { battleNanoseconds += nanoseconds; }
+
+        uint64_t getCounter(BattleCounter counter) const { return counters[static_cast<int>(counter)]; }
+        int64_t getPhaseNanoseconds(BattlePhase phase) const { return phaseNanoseconds[static_cast<int>(phase)]; }
+        uint64_t getPhaseEntries(BattlePhase phase) const { return phaseEntries[static_cast<int>(phase)]; }
+        int64_t getBattleNanoseconds() const { return battleNanoseconds; }
+
+        // Counters with per-battle averages, then time per phase
+        void printReport(ostream& os, const string& title) const;
+    };
+
+    // Charges the enclosing scope to a phase if the thread is instrumented
+    class PhaseTimer {
+    private:
+        BattleInstrumentation* instrumentation;
+        BattlePhase resumed;
+    public:
+        explicit PhaseTimer(BattlePhase phase) : instrumentation(BattleInstrumentation::getCurrent()), resumed(BattlePhase::NONE) {
+            if (instrumentation) {
+                resumed = instrumentation->enterPhase(phase);
+            }
+        }
+        ~PhaseTimer() {
+            if (instrumentation) {
+                instrumentation->leavePhase(resumed);
+            }
+        }
+        PhaseTimer(const PhaseTimer&) = delete;
+        PhaseTimer& operator=(const PhaseTimer&) = delete;
+    };
+} // namespace FantasyArena
+#endif // BATTLE_INSTRUMENTATION_H
@@ -0,0 +1,101 @@
+#include "BattleRandom.h"
+#include <chrono>
+#include <random>
+using namespace std;
+namespace FantasyArena {
+    // Philox4x32 constants (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3")
+    static const uint32_t PHILOX_M0 = 0xD2511F53u;
+    static const uint32_t PHILOX_M1 = 0xCD9E8D57u;
+    static const uint32_t PHILOX_W0 = 0x9E3779B9u;
+    static const uint32_t PHILOX_W1 = 0xBB67AE85u;
+    static const uint64_t NO_BLOCK = ~0ull;
+
+    BattleRandom::BattleRandom(uint64_t seed, uint64_t stream) {
+        reseed(seed, stream);
+    }
+
+    void BattleRandom::reseed(uint64_t newSeed, uint64_t newStream) {
+        seed = newSeed;
+        stream = newStream;
+        position = 0;
+        blockCounter = NO_BLOCK;
+    }
+
+    void BattleRandom::seek(uint64_t newPosition) {
+        position = newPosition;
+    }
+
+    void BattleRandom::generateBlock(uint64_t counter) {
+        // 128-bit counter = (output block, stream), 64-bit key = seed
+        uint32_t c0 = static_cast<uint32_t>(counter);
+        uint32_t c1 = static_cast<uint32_t>(counter >> 32);
+        uint32_t c2 = static_cast<uint32_t>(stream);
+        uint32_t c3 = static_cast<uint32_t>(stream >> 32);
+        uint32_t k0 = static_cast<uint32_t>(seed);
+        uint32_t k1 = static_cast<uint32_t>(seed >> 32);
+        for (int round = 0; round < 10; ++round) {
+            uint64_t product0 = static_cast<uint64_t>(PHILOX_M0) * c0;
+            uint64_t product1 = static_cast<uint64_t>(PHILOX_M1) * c2;
+            uint32_t hi0 = static_cast<uint32_t>(product0 >> 32);
+            uint32_t lo0 = static_cast<uint32_t>(product0);
+            uint32_t hi1 = static_cast<uint32_t>(product1 >> 32);
+            uint32_t lo1 = static_cast<uint32_t>(product1);
+            c0 = hi1 ^ c1 ^ k0;
+            c1 = lo1;
+            c2 = hi0 ^ c3 ^ k1;
+            c3 = lo0;
+            k0 += PHILOX_W0;
+            k1 += PHILOX_W1;
+        }
+        block[0] = c0;
+        block[1] = c1;
+        block[2] = c2;
+        block[3] = c3;
+        blockCounter = counter;
+    }
+
+    uint32_t BattleRandom::next() {
+        uint64_t counter = position >> 2;
+        if (counter != blockCounter) {
+            generateBlock(counter);
+        }
+        return block[position++ & 3];
+    }
+
+    int BattleRandom::nextInt(int minValue, int maxValue) {
+        if (maxValue <= minValue) {
+            return minValue;
+        }
+        // Lemire's multiply-and-reject method
+        uint32_t range = static_cast<uint32_t>(static_cast<int64_t>(maxValue) - minValue + 1);
+        uint64_t product = static_cast<uint64_t>(next()) * range;
+        uint32_t low = static_cast<uint32_t>(product);
+        if (low < range) {
+            uint32_t threshold = static_cast<uint32_t>(-range) % range;
+            while (low < threshold) {
+                product = static_cast<uint64_t>(next()) * range;
+                low = static_cast<uint32_t>(product);
+            }
+        }
+        return static_cast<int>(minValue + static_cast<int64_t>(product >> 32));
+    }
+
+    uint64_t BattleRandom::getSeed() const {
+        return seed;
+    }
+
+    uint64_t BattleRandom::getStream() const {
+        return stream;
+    }
+
+    uint64_t BattleRandom::getPosition() const {
+        return position;
+    }
+
+    uint64_t BattleRandom::seedFromClock() {
+        random_device device;
+        uint64_t entropy = (static_cast<uint64_t>(device()) << 32) ^ device();
+        uint64_t ticks = static_cast<uint64_t>(chrono::high_resolution_clock::now().time_since_epoch().count());
+        return entropy ^ (ticks * 0x9E3779B97F4A7C15ull);
+    }
+} // namespace FantasyArena
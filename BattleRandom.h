@@ -0,0 +1,38 @@
+#pragma once
+#ifndef BATTLE_RANDOM_H
+#define BATTLE_RANDOM_H
+#include <cstdint>
+using namespace std;
+namespace FantasyArena {
+    // Counter-based random engine (Philox4x32-10). Output number n of stream s
+    // under seed S is a pure function of (S, s, n), so any battle can be
+    // replayed from its seed and streams can be used from many threads at once.
+    class BattleRandom {
+    private:
+        uint64_t seed;
+        uint64_t stream;
+        uint64_t position;  // Index of the next 32-bit output
+        uint32_t block[4];  // Outputs of the current counter block
+        uint64_t blockCounter; // Counter of the cached block
+
+        void generateBlock(uint64_t counter);
+    public:
+        explicit BattleRandom(uint64_t seed = 0, uint64_t stream = 0);
+
+        // Restart at the first output of a stream
+        void reseed(uint64_t newSeed, uint64_t newStream = 0);
+        // Jump directly to any output of the current stream
+        void seek(uint64_t newPosition);
+
+        uint32_t next();
+        int nextInt(int minValue, int maxValue); // Inclusive, unbiased
+
+        uint64_t getSeed() const;
+        uint64_t getStream() const;
+        uint64_t getPosition() const;
+
+        // Fresh seed for interactive play
+        static uint64_t seedFromClock();
+    };
+} // namespace FantasyArena
+#endif // BATTLE_RANDOM_H
@@ -0,0 +1,302 @@
+#include "BattleTrace.h"
+#include "Character.h"
+#include "StatTables.h"
+#include <algorithm>
+#include <cstring>
+using namespace std;
+namespace FantasyArena {
+    static const size_t PENDING_EVENTS = 4096;
+    static const char TRACE_MAGIC[4] = { 'F', 'A', 'T', 'R' };
+    // BattleTraceWriter implementation
+    BattleTraceWriter::BattleTraceWriter() : eventCount(0), currentTurn(0), inBattle(false) {
+        fighters[0] = nullptr;
+        fighters[1] = nullptr;
+        memset(&current, 0, sizeof(current));
+    }
+
+    BattleTraceWriter::~BattleTraceWriter() {
+        close();
+    }
+
+    bool BattleTraceWriter::open(const string& path) {
+        close();
+        file.open(path, ios::binary | ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+        // Placeholder header, rewritten by close() once the tables are known
+        TraceFileHeader header;
+        memset(&header, 0, sizeof(header));
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        pending.reserve(PENDING_EVENTS);
+        eventCount = 0;
+        return true;
+    }
+
+    bool BattleTraceWriter::isOpen() const {
+        return file.is_open();
+    }
+
+    uint64_t BattleTraceWriter::getBattleCount() const {
+        return battles.size();
+    }
+
+    uint32_t BattleTraceWriter::internName(const string& name) {
+        auto it = nameOffsets.find(name);
+        if (it != nameOffsets.end()) {
+            return it->second;
+        }
+        uint32_t offset = static_cast<uint32_t>(nameTable.size());
+        nameTable += name;
+        nameTable += '\0';
+        nameOffsets.emplace(name, offset);
+        return offset;
+    }
+
+    void BattleTraceWriter::flushPending() {
+        if (!pending.empty()) {
+            file.write(reinterpret_cast<const char*>(pending.data()),
+                static_cast<streamsize>(pending.size() * sizeof(TraceEvent)));
+            pending.clear();
+        }
+    }
+
+    void BattleTraceWriter::beginBattle(const string& arenaName, uint8_t environment,
+        const Character& player1, const Character& player2, uint64_t seed, uint64_t stream) {
+        if (!file.is_open()) {
+            return;
+        }
+        if (inBattle) {
+            endBattle(0);
+        }
+        memset(&current, 0, sizeof(current));
+        current.firstEvent = eventCount;
+        current.firstTurn = static_cast<uint32_t>(turnTable.size());
+        current.nameOffset[0] = internName(arenaName);
+        current.nameOffset[1] = internName(player1.getName());
+        current.nameOffset[2] = internName(player2.getName());
+        current.level[0] = static_cast<uint16_t>(player1.getLevel());
+        current.level[1] = static_cast<uint16_t>(player2.getLevel());
+        current.environment = environment;
+        current.kind[0] = static_cast<uint8_t>(player1.getClassId());
+        current.kind[1] = static_cast<uint8_t>(player2.getClassId());
+        current.seed = seed;
+        current.stream = stream;
+        fighters[0] = &player1;
+        fighters[1] = &player2;
+        currentTurn = 0;
+        inBattle = true;
+    }
+
+    void BattleTraceWriter::beginTurn(int turnNumber) {
+        if (!inBattle) {
+            return;
+        }
+        currentTurn = turnNumber;
+        turnTable.push_back(static_cast<uint32_t>(eventCount - current.firstEvent));
+        current.turnCount++;
+    }
+
+    void BattleTraceWriter::record(TraceEventType type, const Character* actor, int value, int aux) {
+        if (!inBattle) {
+            return;
+        }
+        TraceEvent event;
+        event.turn = static_cast<uint16_t>(min(currentTurn, static_cast<int>(UINT16_MAX)));
+        event.actor = (actor == fighters[1]) ? 1 : 0;
+        event.type = static_cast<uint8_t>(type);
+        event.value = value;
+        event.aux = aux;
+        pending.push_back(event);
+        eventCount++;
+        if (pending.size() >= PENDING_EVENTS) {
+            flushPending();
+        }
+    }
+
+    void BattleTraceWriter::endBattle(int winner) {
+        if (!inBattle) {
+            return;
+        }
+        current.eventCount = static_cast<uint32_t>(eventCount - current.firstEvent);
+        current.winner = static_cast<uint8_t>(winner);
+        battles.push_back(current);
+        fighters[0] = nullptr;
+        fighters[1] = nullptr;
+        inBattle = false;
+    }
+
+    bool BattleTraceWriter::close() {
+        if (!file.is_open()) {
+            return false;
+        }
+        if (inBattle) {
+            endBattle(0);
+        }
+        flushPending();
+
+        TraceFileHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+        header.version = TRACE_FORMAT_VERSION;
+        header.battleCount = battles.size();
+        header.eventCount = eventCount;
+        header.turnTableOffset = sizeof(TraceFileHeader) + eventCount * sizeof(TraceEvent);
+        header.battleTableOffset = header.turnTableOffset + turnTable.size() * sizeof(uint32_t);
+        // Keep the battle table 8-byte aligned for in-place access
+        uint64_t padding = (8 - header.battleTableOffset % 8) % 8;
+        header.battleTableOffset += padding;
+        header.nameTableOffset = header.battleTableOffset + battles.size() * sizeof(TraceBattleRecord);
+        header.nameTableSize = nameTable.size();
+
+        file.write(reinterpret_cast<const char*>(turnTable.data()),
+            static_cast<streamsize>(turnTable.size() * sizeof(uint32_t)));
+        const char zeros[8] = { 0 };
+        file.write(zeros, static_cast<streamsize>(padding));
+        file.write(reinterpret_cast<const char*>(battles.data()),
+            static_cast<streamsize>(battles.size() * sizeof(TraceBattleRecord)));
+        file.write(nameTable.data(), static_cast<streamsize>(nameTable.size()));
+        file.seekp(0);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        bool ok = file.good();
+        file.close();
+
+        turnTable.clear();
+        battles.clear();
+        nameTable.clear();
+        nameOffsets.clear();
+        eventCount = 0;
+        return ok;
+    }
+
+    // BattleTraceReader implementation
+    BattleTraceReader::BattleTraceReader()
+        : header(nullptr), events(nullptr), turnTable(nullptr), battles(nullptr), names(nullptr) {
+    }
+
+    bool BattleTraceReader::open(const string& path) {
+        header = nullptr;
+        if (!file.open(path) || file.size() < sizeof(TraceFileHeader)) {
+            return false;
+        }
+        const unsigned char* base = file.getData();
+        const TraceFileHeader* candidate = reinterpret_cast<const TraceFileHeader*>(base);
+        if (memcmp(candidate->magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0 || candidate->version != TRACE_FORMAT_VERSION) {
+            file.close();
+            return false;
+        }
+        // Every table must lie inside the mapping
+        uint64_t size = file.size();
+        if (candidate->eventCount > size / sizeof(TraceEvent) || candidate->battleCount > size / sizeof(TraceBattleRecord) ||
+            candidate->turnTableOffset != sizeof(TraceFileHeader) + candidate->eventCount * sizeof(TraceEvent) ||
+            candidate->battleTableOffset < candidate->turnTableOffset || candidate->battleTableOffset > size ||
+            candidate->nameTableOffset != candidate->battleTableOffset + candidate->battleCount * sizeof(TraceBattleRecord) ||
+            candidate->nameTableOffset > size || candidate->nameTableSize > size - candidate->nameTableOffset) {
+            file.close();
+            return false;
+        }
+        const uint32_t* candidateTurns = reinterpret_cast<const uint32_t*>(base + candidate->turnTableOffset);
+        const TraceBattleRecord* candidateBattles = reinterpret_cast<const TraceBattleRecord*>(base + candidate->battleTableOffset);
+        // So must every battle's events and turns, and every turn's first event
+        uint64_t turnTableLength = (candidate->battleTableOffset - candidate->turnTableOffset) / sizeof(uint32_t);
+        for (uint64_t i = 0; i < candidate->battleCount; ++i) {
+            const TraceBattleRecord& record = candidateBattles[i];
+            bool valid = record.firstEvent <= candidate->eventCount &&
+                record.eventCount <= candidate->eventCount - record.firstEvent &&
+                record.firstTurn <= turnTableLength && record.turnCount <= turnTableLength - record.firstTurn;
+            for (uint32_t turn = 0; valid && turn < record.turnCount; ++turn) {
+                valid = candidateTurns[record.firstTurn + turn] <= record.eventCount;
+            }
+            if (!valid) {
+                file.close();
+                return false;
+            }
+        }
+        header = candidate;
+        events = reinterpret_cast<const TraceEvent*>(base + sizeof(TraceFileHeader));
+        turnTable = candidateTurns;
+        battles = candidateBattles;
+        names = reinterpret_cast<const char*>(base + header->nameTableOffset);
+        return true;
+    }
+
+    size_t BattleTraceReader::getBattleCount() const {
+        return header ? static_cast<size_t>(header->battleCount) : 0;
+    }
+
+    const TraceBattleRecord& BattleTraceReader::getBattle(size_t battle) const {
+        return battles[battle];
+    }
+
+    const char* BattleTraceReader::getName(uint32_t offset) const {
+        return (header && offset < header->nameTableSize) ? names + offset : "";
+    }
+
+    const TraceEvent* BattleTraceReader::getEvents(size_t battle, int fromTurn, size_t& count) const {
+        const TraceBattleRecord& record = battles[battle];
+        uint32_t start = 0;
+        if (fromTurn > 1) {
+            // Turn t's first event comes straight from the turn table
+            uint32_t turnIndex = static_cast<uint32_t>(fromTurn - 1);
+            start = (turnIndex < record.turnCount) ? turnTable[record.firstTurn + turnIndex] : record.eventCount;
+        }
+        count = record.eventCount - start;
+        return events + record.firstEvent + start;
+    }
+
+    void BattleTraceReader::renderText(ostream& os, size_t battle, int fromTurn, int toTurn) const {
+        const TraceBattleRecord& record = getBattle(battle);
+        string fighter[2] = { getName(record.nameOffset[1]), getName(record.nameOffset[2]) };
+        int kind[2] = { record.kind[0], record.kind[1] };
+        const char* environment = record.environment < ENVIRONMENT_COUNT ? ENVIRONMENT_MODIFIERS[record.environment].name : "Unknown";
+
+        size_t count = 0;
+        const TraceEvent* event = getEvents(battle, fromTurn, count);
+        for (size_t i = 0; i < count; ++i, ++event) {
+            if (event->turn > toTurn) {
+                break;
+            }
+            int self = event->actor;
+            int other = 1 - self;
+            switch (static_cast<TraceEventType>(event->type)) {
+            case TraceEventType::BATTLE_START:
+                os << "Battle started in " << getName(record.nameOffset[0]) << " (" << environment << " environment) between "
+                    << fighter[0] << " (" << getClassNameForId(kind[0]) << ") and "
+                    << fighter[1] << " (" << getClassNameForId(kind[1]) << ")\n";
+                os << fighter[0] << ": " << event->value << " HP, " << fighter[1] << ": " << event->aux << " HP\n";
+                break;
+            case TraceEventType::TURN_START:
+                os << "Turn " << event->turn << ": " << fighter[self] << "'s turn\n";
+                break;
+            case TraceEventType::ATTACK:
+                os << fighter[self] << " attacks " << fighter[other] << " for " << event->value << " damage ("
+                    << fighter[other] << " HP: " << event->aux << ")\n";
+                break;
+            case TraceEventType::ATTACK_NEGATED:
+                os << fighter[self] << "'s attack missed due to " << getAbilityNameForId(kind[other]) << ".\n";
+                break;
+            case TraceEventType::ABILITY_USED:
+                os << fighter[self] << " uses special ability: " << getAbilityNameForId(kind[self])
+                    << " (cooldown " << event->value << " turns)\n";
+                break;
+            case TraceEventType::ABILITY_ENDED:
+                os << fighter[self] << "'s " << getAbilityNameForId(kind[self]) << " ends.\n";
+                break;
+            case TraceEventType::REFLECT:
+                os << fighter[self] << "'s " << getAbilityNameForId(kind[self]) << " reflects " << event->value << " damage back to "
+                    << fighter[other] << "! (" << fighter[other] << " HP: " << event->aux << ")\n";
+                break;
+            case TraceEventType::RESURRECT:
+                os << fighter[self] << " RESURRECTS with " << event->value << " health!\n";
+                break;
+            case TraceEventType::BATTLE_END: {
+                int winner = event->value == 2 ? 1 : 0;
+                os << "Battle ended! " << fighter[winner] << " (" << getClassNameForId(kind[winner]) << ") has defeated "
+                    << fighter[1 - winner] << " (" << getClassNameForId(kind[1 - winner]) << ") with "
+                    << event->aux << " health remaining!\n";
+                break;
+            }
+            }
+        }
+    }
+} // namespace FantasyArena
@@ -0,0 +1,123 @@
+#pragma once
+#ifndef BATTLE_TRACE_H
+#define BATTLE_TRACE_H
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+#include <climits>
+#include <cstdint>
+#include "MappedFile.h"
+using namespace std;
+namespace FantasyArena {
+    class Character;
+
+    enum class TraceEventType : uint8_t {
+        BATTLE_START,   // value: player 1 health, aux: player 2 health (after environment)
+        TURN_START,     // actor: side whose turn begins
+        ATTACK,         // value: damage dealt, aux: target health afterwards
+        ATTACK_NEGATED, // actor: attacker; the defender's ability made it miss
+        ABILITY_USED,   // value: cooldown afterwards
+        ABILITY_ENDED,  // a one-turn ability (Transparent, Mirror Image, ...) ran out
+        REFLECT,        // value: damage reflected, aux: attacker health afterwards
+        RESURRECT,      // value: health after resurrection
+        BATTLE_END      // value: winning side (1 or 2), aux: winner health
+    };
+
+    // One fixed-size event; files store these back to back (little-endian)
+    struct TraceEvent {
+        uint16_t turn;  // Saturates at 65535 on longer battles; the turn table stays exact
+        uint8_t actor;  // 0 = player 1, 1 = player 2
+        uint8_t type;   // TraceEventType
+        int32_t value;
+        int32_t aux;
+    };
+    static_assert(sizeof(TraceEvent) == 12, "TraceEvent must stay 12 bytes");
+
+    struct TraceBattleRecord {
+        uint64_t firstEvent;    // Index into the event array
+        uint32_t eventCount;
+        uint32_t firstTurn;     // Index into the turn table
+        uint32_t turnCount;
+        uint32_t nameOffset[3]; // Arena, player 1, player 2 in the name table
+        uint16_t level[2];
+        uint8_t environment;    // EnvironmentType
+        uint8_t kind[2];        // Class id (ClassDefinitions.h)
+        uint8_t winner;         // 1 or 2, 0 if the battle was not finished
+        uint64_t seed;          // BattleRandom seed and stream the battle ran with
+        uint64_t stream;
+    };
+    static_assert(sizeof(TraceBattleRecord) == 56, "TraceBattleRecord layout changed");
+
+    // File layout: header, event array, turn table (event index of each turn's
+    // first event, relative to its battle), battle table, name table
+    struct TraceFileHeader {
+        char magic[4];          // "FATR"
+        uint32_t version;
+        uint64_t battleCount;
+        uint64_t eventCount;
+        uint64_t turnTableOffset;
+        uint64_t battleTableOffset;
+        uint64_t nameTableOffset;
+        uint64_t nameTableSize;
+    };
+    static_assert(sizeof(TraceFileHeader) == 56, "TraceFileHeader layout changed");
+
+    const uint32_t TRACE_FORMAT_VERSION = 2;
+
+    // Streams the events of any number of battles into one trace file
+    class BattleTraceWriter {
+    private:
+        ofstream file;
+        vector<TraceEvent> pending;
+        vector<uint32_t> turnTable;
+        vector<TraceBattleRecord> battles;
+        string nameTable;
+        unordered_map<string, uint32_t> nameOffsets;
+        uint64_t eventCount;
+        const Character* fighters[2];
+        TraceBattleRecord current;
+        int currentTurn;
+        bool inBattle;
+
+        uint32_t internName(const string& name);
+        void flushPending();
+    public:
+        BattleTraceWriter();
+        ~BattleTraceWriter();
+        bool open(const string& path);
+        bool close(); // Writes the tables and the final header
+        bool isOpen() const;
+
+        void beginBattle(const string& arenaName, uint8_t environment, const Character& player1, const Character& player2,
+            uint64_t seed, uint64_t stream);
+        void beginTurn(int turnNumber);
+        void record(TraceEventType type, const Character* actor, int value, int aux);
+        void endBattle(int winner);
+        uint64_t getBattleCount() const;
+    };
+
+    // Memory-maps a trace file; events are read in place without parsing
+    class BattleTraceReader {
+    private:
+        MappedFile file;
+        const TraceFileHeader* header;
+        const TraceEvent* events;
+        const uint32_t* turnTable;
+        const TraceBattleRecord* battles;
+        const char* names;
+    public:
+        BattleTraceReader();
+        bool open(const string& path);
+        size_t getBattleCount() const;
+        const TraceBattleRecord& getBattle(size_t battle) const;
+        const char* getName(uint32_t offset) const;
+        // Events of a battle starting at the given turn (1-based); count is set to
+        // the number of events up to the end of the battle
+        const TraceEvent* getEvents(size_t battle, int fromTurn, size_t& count) const;
+        // Re-create a readable log for a range of turns
+        void renderText(ostream& os, size_t battle, int fromTurn = 1, int toTurn = INT_MAX) const;
+    };
+} // namespace FantasyArena
+#endif // BATTLE_TRACE_H
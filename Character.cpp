@@ -1,254 +1,365 @@
 #define _CRT_SECURE_NO_WARNINGS
 #include "Character.h"
-#include <cstdlib>
-#include <ctime>
+#include "StatTables.h"
+#include "BattleInstrumentation.h"
 #include <iomanip>
 using namespace std;
 namespace FantasyArena {
     // Initialize static members
-    ofstream Character::logFile;
-    string Character::environmentName = "Unknown";
-    // Character implementation
-    Character::Character(const std::string& name, int level, int health, int attack, int defense, int cooldown)
-        : name(name), level(level), health(health), maxHealth(health), attack(attack), originalAttack(attack),
-        defense(defense), originalDefense(defense), specialAbilityCooldown(cooldown), currentCooldown(0),
-        abilityDuration(0), abilityStatus(SpecialAbilityStatus::READY) {
+    thread_local AsyncLogSink* Character::logSink = nullptr;
+    thread_local BattleTraceWriter* Character::traceWriter = nullptr;
+    string getClassNameForKind(CharacterKind kind) {
+        return kind == CharacterKind::CUSTOM ? "Custom" : CLASS_STATS[static_cast<int>(kind)].className;
+    }
+    string getAbilityNameForKind(CharacterKind kind) {
+        return kind == CharacterKind::CUSTOM ? "Custom ability" : CLASS_STATS[static_cast<int>(kind)].abilityName;
     }
-    std::string Character::getName() const {
+    ConsoleMode Character::consoleMode = ConsoleMode::FULL;
+    // Character implementation
+    Character::Character(CharacterKind kind, const std::string& name, int level)
+        : Character(kind, name, level, getStatBlock(kind, level).health, getStatBlock(kind, level).attack,
+            getStatBlock(kind, level).defense, getStatBlock(kind, level).cooldown) {
+    }
+    Character::Character(CharacterKind kind, const std::string& name, int level, int health, int attack, int defense, int cooldown)
+        : kind(kind), name(name), level(level), maxHealth(health), originalAttack(attack), originalDefense(defense),
+        specialAbilityCooldown(cooldown), logName(LOG_NAME_UNKNOWN), classId(static_cast<uint8_t>(kind)),
+        customClass(nullptr) {
+        state.health = health;
+        state.attack = attack;
+        state.defense = defense;
+        state.currentCooldown = 0;
+        state.abilityDuration = 0;
+        state.abilityStatus = SpecialAbilityStatus::READY;
+        state.abilityActive = false;
+        state.revived = false;
+    }
+    void Character::resetFrom(const Character& source) {
+        // Subclasses only add per-class constants, so the profile and the
+        // combat state are all that differ between two characters of a class
+        kind = source.kind;
+        name = source.name;
+        level = source.level;
+        maxHealth = source.maxHealth;
+        originalAttack = source.originalAttack;
+        originalDefense = source.originalDefense;
+        specialAbilityCooldown = source.specialAbilityCooldown;
+        logName = source.logName;
+        classId = source.classId;
+        customClass = source.customClass;
+        state = source.state;
+    }
+    const std::string& Character::getName() const {
         return name;
     }
     int Character::getLevel() const {
         return level;
     }
     int Character::getHealth() const {
-        return health;
+        return state.health;
     }
     int Character::getMaxHealth() const {
         return maxHealth;
     }
     int Character::getAttack() const {
-        return attack;
+        return state.attack;
     }
     int Character::getDefense() const {
-        return defense;
+        return state.defense;
     }
     SpecialAbilityStatus Character::getAbilityStatus() const {
-        return abilityStatus;
+        return state.abilityStatus;
     }
     int Character::getCurrentCooldown() const {
-        return currentCooldown;
+        return state.currentCooldown;
+    }
+    int Character::getSpecialAbilityCooldown() const {
+        return specialAbilityCooldown;
     }
     void Character::setHealth(int newHealth) {
-        health = (newHealth < 0) ? 0 : newHealth;
+        state.health = (newHealth < 0) ? 0 : newHealth;
     }
     void Character::setAttack(int newAttack) {
-        attack = newAttack;
+        state.attack = newAttack;
     }
     void Character::setDefense(int newDefense) {
-        defense = newDefense;
+        state.defense = newDefense;
     }
     void Character::resetCooldown() {
-        currentCooldown = specialAbilityCooldown;
-        abilityStatus = SpecialAbilityStatus::COOLDOWN;
+        state.currentCooldown = specialAbilityCooldown;
+        state.abilityStatus = SpecialAbilityStatus::COOLDOWN;
     }
     void Character::decrementCooldown() {
-        if (currentCooldown > 0) {
-            currentCooldown--;
-            if (currentCooldown == 0) {
-                abilityStatus = SpecialAbilityStatus::READY;
+        if (state.currentCooldown > 0) {
+            state.currentCooldown--;
+            if (state.currentCooldown == 0) {
+                state.abilityStatus = SpecialAbilityStatus::READY;
             }
         }
     }
     bool Character::isAlive() const {
-        return health > 0;
+        return state.health > 0;
+    }
+    // Default ability hooks: no defensive, reactive or passive ability
+    bool Character::negatesIncomingAttack(Character& /*attacker*/) {
+        return false;
+    }
+    void Character::onDamageTaken(int /*damage*/, Character& /*attacker*/) {
+    }
+    void Character::expireAbilities() {
+    }
+    bool Character::tryResurrect() {
+        return false;
+    }
+    bool Character::attacksAfterAbility() const {
+        return false;
+    }
+    void Character::displayAbilityStatus(ostream& os) const {
+        os << "No active abilities\n";
+    }
+    bool Character::isAbilityActive() const {
+        return false;
     }
     // Operator overloading
     int operator+(const Character& lhs, const Character& rhs) {
         // Return combined attack power
-        return lhs.attack + rhs.attack;
+        return lhs.state.attack + rhs.state.attack;
     }
     bool operator==(const Character& lhs, const Character& rhs) {
         // Compare total power (attack + defense + health)
-        int lhsPower = lhs.attack + lhs.defense + lhs.health;
-        int rhsPower = rhs.attack + rhs.defense + rhs.health;
+        int lhsPower = lhs.state.attack + lhs.state.defense + lhs.state.health;
+        int rhsPower = rhs.state.attack + rhs.state.defense + rhs.state.health;
         return lhsPower == rhsPower;
     }std::ostream& operator<<(std::ostream& os, const Character& character) {
         os << "Name: " << character.name << "\n"
             << "Class: " << character.getClassName() << "\n"
             << "Level: " << character.level << "\n"
-            << "Health: " << character.health << "/" << character.maxHealth << "\n"
-            << "Attack: " << character.attack << "\n"
-            << "Defense: " << character.defense << "\n";
-        if (character.abilityStatus == SpecialAbilityStatus::READY) {
+            << "Health: " << character.state.health << "/" << character.maxHealth << "\n"
+            << "Attack: " << character.state.attack << "\n"
+            << "Defense: " << character.state.defense << "\n";
+        if (character.state.abilityStatus == SpecialAbilityStatus::READY) {
             os << "Special Ability: Ready\n";
         }
         else {
-            os << "Special Ability: Cooldown (" << character.currentCooldown << " turns remaining)\n";
+            os << "Special Ability: Cooldown (" << character.state.currentCooldown << " turns remaining)\n";
         }
         return os;
     }
     // Static methods for logging
-    void Character::openLogFile() {
-        // Create a timestamp for the log file name
-        std::time_t now_time = std::time(nullptr);
-        char buffer[80];
-        std::strftime(buffer, sizeof(buffer), "%Y%m%d_%H%M%S", std::localtime(&now_time));
-        // Include environment name in the filename
-        std::string filename = environmentName + "_battle_log_" + std::string(buffer) + ".txt";
-        logFile.open(filename);
-        if (logFile.is_open()) {
-            logFile << "=== Fantasy Arena Battle Log: " << environmentName << " Environment ===" << endl;
-            logFile << "Log started at: " << put_time(localtime(&now_time), "%Y-%m-%d %H:%M:%S") << endl;
-            logFile << "===============================" << endl << endl;
+    void Character::display(const string& message) {
+        if (consoleMode == ConsoleMode::FULL) {
+            PhaseTimer timer(BattlePhase::LOGGING);
+            FrameRenderer::out() << message << "\n";
         }
-        else {
-            cout << "Error: Could not open log file." << endl;
+    }
+    void Character::logAction(const string& action) {
+        if (logSink && logSink->isOpen()) {
+            PhaseTimer timer(BattlePhase::LOGGING);
+            logSink->write(action);
         }
     }
-    void Character::closeLogFile() {
-        if (logFile.is_open()) {
-            time_t now_time = time(nullptr);
-            logFile << endl << "Log closed at: " << put_time(localtime(&now_time), "%Y-%m-%d %H:%M:%S") << endl;
-            logFile.close();
+    void Character::recordLogEvent(LogEventType type, const Character& actor, const Character* target, int value, int aux) {
+        PhaseTimer timer(BattlePhase::LOGGING);
+        LogEvent event;
+        event.type = type;
+        event.kind = actor.classId;
+        event.actor = actor.logName;
+        event.target = target ? target->logName : LOG_NAME_UNKNOWN;
+        event.value = value;
+        event.aux = aux;
+        if (consoleMode == ConsoleMode::FULL) {
+            // Reused between calls, so a warm frame line costs no allocation
+            thread_local string line;
+            static const string noTarget;
+            line.clear();
+            if (formatLogEvent(event, LogView::CONSOLE, actor.name, target ? target->name : noTarget, line)) {
+                FrameRenderer::out() << line << "\n";
+            }
+        }
+        if (logSink && logSink->isOpen()) {
+            logSink->write(event);
         }
     }
-    void Character::logAction(const string& action) {
-        if (logFile.is_open()) {
-            time_t now_time = time(nullptr);
-            logFile << "[" << put_time(localtime(&now_time), "%H:%M:%S") << "] " << action << endl;
+    void Character::registerLogName(Character& character) {
+        if (logSink && logSink->isOpen()) {
+            character.logName = logSink->internName(character.name);
         }
     }
     // Warrior implementation
     Warrior::Warrior(const string& name, int level)
-        : Character(name, level, 100 + (level * 20), 15 + (level * 3), 10 + (level * 2), 3), // Changed cooldown to 3
-        transparentActive(false), transparentDuration(0) {
+        : Character(CharacterKind::WARRIOR, name, level) {
     }
 
     void Warrior::attackTarget(Character& target) {
-        int damage = attack - (target.getDefense() / 2);
+        int damage = state.attack - (target.getDefense() / 2);
         if (damage < 1) damage = 1;
 
-        target.setHealth(target.getHealth() - damage);
+        int targetHealth = target.getHealth();
+        target.setHealth(targetHealth - damage);
+        traceEvent(TraceEventType::ATTACK, this, targetHealth - target.getHealth(), target.getHealth());
 
-        string attackLog = name + " attacks " + target.getName() + " for " + to_string(damage) + " damage";
-        if (transparentActive) {
-            attackLog += " (Transparent active!)";
-        }
-        cout << attackLog << endl;
-        logAction(attackLog);
+        logEvent(LogEventType::ATTACK, *this, &target, damage, state.abilityActive);
     }
 
     void Warrior::useSpecialAbility() {
-        if (abilityStatus == SpecialAbilityStatus::READY) {
-            transparentActive = true;
-            transparentDuration = 1; // Lasts for 1 turn
-            string abilityLog = name + " becomes Transparent! Immune to attacks for 1 turn.";
-            cout << abilityLog << endl;
-            logAction(abilityLog);
+        if (state.abilityStatus == SpecialAbilityStatus::READY) {
+            state.abilityActive = true;
+            state.abilityDuration = 1; // Lasts for 1 turn
+            logEvent(LogEventType::ABILITY_USED, *this, nullptr);
 
             // Set cooldown
             resetCooldown();
-            string cooldownStartMsg = name + "'s Transparent ability is now on cooldown for " + to_string(currentCooldown) + " turns.";
-            cout << cooldownStartMsg << endl;
-            logAction(cooldownStartMsg);
+            logEvent(LogEventType::COOLDOWN_STARTED, *this, nullptr, state.currentCooldown);
         }
         else {
-            string cooldownMsg = name + "'s Transparent ability is on cooldown (" + to_string(currentCooldown) + " turns remaining)";
-            cout << cooldownMsg << endl;
-            logAction(cooldownMsg);
+            logEvent(LogEventType::ON_COOLDOWN, *this, nullptr, state.currentCooldown);
         }
     }
 
 
 
     std::string Warrior::getClassName() const {
-        return "Warrior";
+        return CLASS_STATS[static_cast<int>(kind)].className;
     }
 
     std::string Warrior::getSpecialAbilityName() const {
-        return "Transparent";
+        return CLASS_STATS[static_cast<int>(kind)].abilityName;
+    }
+
+    Character* Warrior::clone() const {
+        return new Warrior(*this);
+    }
+
+    bool Warrior::negatesIncomingAttack(Character& attacker) {
+        if (!state.abilityActive) {
+            return false;
+        }
+        logEvent(LogEventType::ATTACK_NEGATED, *this, &attacker);
+        traceEvent(TraceEventType::ATTACK_NEGATED, &attacker, 0, 0);
+        return true;
+    }
+
+    void Warrior::expireAbilities() {
+        // Deactivate Transparent after one turn
+        deactivateTransparent();
+    }
+
+    void Warrior::displayAbilityStatus(ostream& os) const {
+        if (state.abilityActive) {
+            os << "[Active] Transparent - Immune to all attacks for this turn!\n";
+        }
+        else if (state.abilityStatus == SpecialAbilityStatus::COOLDOWN) {
+            os << "[Cooldown] Transparent - Ready in " << state.currentCooldown << " turns\n";
+        }
+        else {
+            os << "[Ready] Transparent - Use special ability to become immune to attacks\n";
+        }
+    }
+
+    bool Warrior::isAbilityActive() const {
+        return state.abilityActive;
     }
 
     bool Warrior::isTransparentActive() const {
-        return transparentActive;
+        return state.abilityActive;
     }
 
     void Warrior::deactivateTransparent() {
-        if (transparentActive) {
-            transparentActive = false;
-            transparentDuration = 3;
-            string deactivateLog = name + "'s Transparent ability ends. No longer immune to attacks.";
-            cout << deactivateLog << endl;
-            logAction(deactivateLog);
+        if (state.abilityActive) {
+            state.abilityActive = false;
+            traceEvent(TraceEventType::ABILITY_ENDED, this, 0, 0);
+            state.abilityDuration = 3;
+            logEvent(LogEventType::ABILITY_ENDED, *this, nullptr);
         }
     }
     // Mage implementation
     Mage::Mage(const std::string& name, int level)
-        : Character(name, level, 70 + (level * 15), 20 + (level * 3), 5 + (level * 1), 3),
-        mirrorImageActive(false), mirrorImageDuration(0) {
+        : Character(CharacterKind::MAGE, name, level) {
     }
     void Mage::attackTarget(Character& target) {
-        int damage = attack - (target.getDefense() / 3);
+        int damage = state.attack - (target.getDefense() / 3);
         if (damage < 1) damage = 1;
-        target.setHealth(target.getHealth() - damage);
-        string attackLog = name + " attacks " + target.getName() + " for " + to_string(damage) + " damage";
-        if (mirrorImageActive) {
-            attackLog += " (Mirror Image active!)";
-        }
-        logAction(attackLog);
+        int targetHealth = target.getHealth();
+        target.setHealth(targetHealth - damage);
+        traceEvent(TraceEventType::ATTACK, this, targetHealth - target.getHealth(), target.getHealth());
+        logEvent(LogEventType::ATTACK, *this, &target, damage, state.abilityActive);
     }
     void Mage::useSpecialAbility() {
-        if (abilityStatus == SpecialAbilityStatus::READY) {
+        if (state.abilityStatus == SpecialAbilityStatus::READY) {
             // Mirror Image: Creates an illusory clone to make the next attack miss
-            mirrorImageActive = true;
-            mirrorImageDuration = 1; // Lasts for 1 turn
+            state.abilityActive = true;
+            state.abilityDuration = 1; // Lasts for 1 turn
 
-            string abilityLog = name + " creates a Mirror Image! The next attack will miss completely.";
-            cout << abilityLog << endl;
-            logAction(abilityLog);
+            logEvent(LogEventType::ABILITY_USED, *this, nullptr);
 
             // Set cooldown
             resetCooldown();
-            string cooldownStartMsg = name + "'s Mirror Image ability is now on cooldown for " + to_string(currentCooldown) + " turns.";
-            cout << cooldownStartMsg << endl;
-            logAction(cooldownStartMsg);
+            logEvent(LogEventType::COOLDOWN_STARTED, *this, nullptr, state.currentCooldown);
         }
         else {
-            string cooldownMsg = name + "'s Mirror Image is on cooldown (" + to_string(currentCooldown) + " turns remaining)";
-            cout << cooldownMsg << endl;
-            logAction(cooldownMsg);
+            logEvent(LogEventType::ON_COOLDOWN, *this, nullptr, state.currentCooldown);
         }
     }
 
 
     std::string Mage::getClassName() const {
-        return "Mage";
+        return CLASS_STATS[static_cast<int>(kind)].className;
     }
 
     std::string Mage::getSpecialAbilityName() const {
-        return "Mirror Image";
+        return CLASS_STATS[static_cast<int>(kind)].abilityName;
+    }
+
+    Character* Mage::clone() const {
+        return new Mage(*this);
+    }
+
+    bool Mage::negatesIncomingAttack(Character& attacker) {
+        if (!state.abilityActive) {
+            return false;
+        }
+        logEvent(LogEventType::ATTACK_NEGATED, *this, &attacker);
+        traceEvent(TraceEventType::ATTACK_NEGATED, &attacker, 0, 0);
+        deactivateMirrorImage();
+        return true;
+    }
+
+    void Mage::expireAbilities() {
+        // Mirror Image ends at the start of the Mage's turn if it was not used
+        deactivateMirrorImage();
+    }
+
+    void Mage::displayAbilityStatus(ostream& os) const {
+        if (state.abilityActive) {
+            os << "[Active] Mirror Image - Next attack will miss completely!\n";
+        }
+        else if (state.abilityStatus == SpecialAbilityStatus::COOLDOWN) {
+            os << "[Cooldown] Mirror Image - Ready in " << state.currentCooldown << " turns\n";
+        }
+        else {
+            os << "[Ready] Mirror Image - Use special ability to make the next attack miss\n";
+        }
+    }
+
+    bool Mage::isAbilityActive() const {
+        return state.abilityActive;
     }
 
     bool Mage::isMirrorImageActive() const {
-        return mirrorImageActive;
+        return state.abilityActive;
     }
 
     void Mage::deactivateMirrorImage() {
-        if (mirrorImageActive) {
-            mirrorImageActive = false;
-            mirrorImageDuration = 3;
-
-            string deactivateLog = name + "'s Mirror Image fades away. No longer protected from attacks.";
-            cout << deactivateLog << endl;
-            logAction(deactivateLog);
+        if (state.abilityActive) {
+            state.abilityActive = false;
+            traceEvent(TraceEventType::ABILITY_ENDED, this, 0, 0);
+            state.abilityDuration = 3;
+            logEvent(LogEventType::ABILITY_ENDED, *this, nullptr);
         }
     }
 
     // Archer implementation
     Archer::Archer(const string& name, int level)
-        : Character(name, level, 80 + (level * 15), 18 + (level * 3), 7 + (level * 2), 3), // Changed cooldown to 3
-        evasiveRollActive(false), evasiveRollDuration(0) {
-        srand(static_cast<unsigned int>(time(nullptr)));
+        : Character(CharacterKind::ARCHER, name, level) {
     }
 
     void Archer::attackTarget(Character& target) {
@@ -256,106 +367,134 @@ namespace FantasyArena {
         int effectiveDefense;
 
         // If Piercing Arrow is active, ignore 50% of target's defense
-        if (evasiveRollActive) {
+        if (state.abilityActive) {
             effectiveDefense = static_cast<int>(targetDefense * (1.0f - 0.5f));
         }
         else {
             effectiveDefense = targetDefense;
         }
 
-        int damage = attack - (effectiveDefense / 4);
+        int damage = state.attack - (effectiveDefense / 4);
         if (damage < 1) damage = 1;
 
-        target.setHealth(target.getHealth() - damage);
+        int targetHealth = target.getHealth();
+        target.setHealth(targetHealth - damage);
+        traceEvent(TraceEventType::ATTACK, this, targetHealth - target.getHealth(), target.getHealth());
 
-        string attackLog = name + " attacks " + target.getName() + " for " + to_string(damage) + " damage";
-        if (evasiveRollActive) {
-            attackLog += " (Evasive Roll active!)";
-        }
-        logAction(attackLog);
+        logEvent(LogEventType::ATTACK, *this, &target, damage, state.abilityActive);
 
         // Deactivate after one use
-        if (evasiveRollActive) {
+        if (state.abilityActive) {
             deactivateEvasiveRoll();
         }
     }
 
     void Archer::useSpecialAbility() {
-        if (abilityStatus == SpecialAbilityStatus::READY) {
-            evasiveRollActive = true;
-            evasiveRollDuration = 1; // Lasts for 1 turn
+        if (state.abilityStatus == SpecialAbilityStatus::READY) {
+            state.abilityActive = true;
+            state.abilityDuration = 1; // Lasts for 1 turn
 
-            string abilityLog = name + " performs an Evasive Roll! Will dodge the next attack completely.";
-            cout << abilityLog << endl;
-            logAction(abilityLog);
+            logEvent(LogEventType::ABILITY_USED, *this, nullptr);
 
             // Set cooldown
             resetCooldown();
-            string cooldownStartMsg = name + "'s Evasive Roll ability is now on cooldown for " + to_string(currentCooldown) + " turns.";
-            cout << cooldownStartMsg << endl;
-            logAction(cooldownStartMsg);
+            logEvent(LogEventType::COOLDOWN_STARTED, *this, nullptr, state.currentCooldown);
         }
         else {
-            string cooldownMsg = name + "'s Evasive Roll is on cooldown (" + to_string(currentCooldown) + " turns remaining)";
-            cout << cooldownMsg << endl;
-            logAction(cooldownMsg);
+            logEvent(LogEventType::ON_COOLDOWN, *this, nullptr, state.currentCooldown);
         }
     }
 
     std::string Archer::getClassName() const {
-        return "Archer";
+        return CLASS_STATS[static_cast<int>(kind)].className;
     }
 
     std::string Archer::getSpecialAbilityName() const {
-        return "Evasive Roll";
+        return CLASS_STATS[static_cast<int>(kind)].abilityName;
+    }
+
+    Character* Archer::clone() const {
+        return new Archer(*this);
+    }
+
+    bool Archer::negatesIncomingAttack(Character& attacker) {
+        if (!state.abilityActive) {
+            return false;
+        }
+        logEvent(LogEventType::ATTACK_NEGATED, *this, &attacker);
+        traceEvent(TraceEventType::ATTACK_NEGATED, &attacker, 0, 0);
+        deactivateEvasiveRoll();
+        return true;
+    }
+
+    void Archer::expireAbilities() {
+        // Evasive Roll ends at the start of the Archer's turn if it was not used
+        deactivateEvasiveRoll();
+    }
+
+    bool Archer::attacksAfterAbility() const {
+        // The Archer attacks from the evasive stance in the same turn
+        return state.abilityActive;
+    }
+
+    void Archer::displayAbilityStatus(ostream& os) const {
+        if (state.abilityActive) {
+            os << "[Active] Evasive Roll - Next attack will be dodged completely!\n";
+        }
+        else if (state.abilityStatus == SpecialAbilityStatus::COOLDOWN) {
+            os << "[Cooldown] Evasive Roll - Ready in " << state.currentCooldown << " turns\n";
+        }
+        else {
+            os << "[Ready] Evasive Roll - Use special ability to dodge the next attack\n";
+        }
+    }
+
+    bool Archer::isAbilityActive() const {
+        return state.abilityActive;
     }
 
     bool Archer::isEvasiveRollActive() const {
-        return evasiveRollActive;
+        return state.abilityActive;
     }
 
     void Archer::deactivateEvasiveRoll() {
-        if (evasiveRollActive) {
-            evasiveRollActive = false;
-            evasiveRollDuration = 0;
-
-            string deactivateLog = name + "'s Evasive Roll ends. No longer able to dodge attacks.";
-            cout << deactivateLog << endl;
-            logAction(deactivateLog);
+        if (state.abilityActive) {
+            state.abilityActive = false;
+            traceEvent(TraceEventType::ABILITY_ENDED, this, 0, 0);
+            state.abilityDuration = 0;
+            logEvent(LogEventType::ABILITY_ENDED, *this, nullptr);
         }
     }
 
     // LegendaryCharacter implementation
     LegendaryCharacter::LegendaryCharacter(const std::string& name, int level)
-        : Character(name, level, 120 + (level * 25), 22 + (level * 4), 12 + (level * 2), 0), // No cooldown for passive ability
-        revived(false), resurrectionHealthPercent(0.25f) {
+        : Character(CharacterKind::LEGENDARY, name, level),
+        resurrectionHealthPercent(0.25f) {
     }
 
     void LegendaryCharacter::attackTarget(Character& target) {
-        int damage = attack - (target.getDefense() / 3);
+        int damage = state.attack - (target.getDefense() / 3);
         if (damage < 1) damage = 1;
 
-        target.setHealth(target.getHealth() - damage);
+        int targetHealth = target.getHealth();
+        target.setHealth(targetHealth - damage);
+        traceEvent(TraceEventType::ATTACK, this, targetHealth - target.getHealth(), target.getHealth());
 
-        string attackLog = name + " attacks " + target.getName() + " for " + to_string(damage) + " damage";
-        logAction(attackLog);
+        logEvent(LogEventType::ATTACK, *this, &target, damage);
     }
 
     void LegendaryCharacter::useSpecialAbility() {
         // Resurrection is a passive ability that triggers automatically
-        string abilityLog = name + "'s Resurrection ability is passive and will trigger automatically upon death.";
-        cout << abilityLog << endl;
-        logAction(abilityLog);
+        logEvent(LogEventType::ABILITY_USED, *this, nullptr);
     }
 
     bool LegendaryCharacter::checkResurrection() {
-        if (health <= 0 && !revived) {
+        if (state.health <= 0 && !state.revived) {
             // Resurrect with 25% health
-            health = static_cast<int>(maxHealth * resurrectionHealthPercent);
-            revived = true;
-            string resurrectionLog = name + " RESURRECTS with " + to_string(health) + " health!";
-            cout << "\n*** " << resurrectionLog << " ***\n" << endl;
-            logAction(resurrectionLog);
+            state.health = static_cast<int>(maxHealth * resurrectionHealthPercent);
+            state.revived = true;
+            traceEvent(TraceEventType::RESURRECT, this, state.health, 0);
+            logEvent(LogEventType::RESURRECTED, *this, nullptr, state.health);
 
             return true;
         }
@@ -363,89 +502,271 @@ namespace FantasyArena {
     }
 
     string LegendaryCharacter::getClassName() const {
-        return "LegendaryCharacter";
+        return CLASS_STATS[static_cast<int>(kind)].className;
     }
 
     string LegendaryCharacter::getSpecialAbilityName() const {
-        return "Resurrection";
+        return CLASS_STATS[static_cast<int>(kind)].abilityName;
+    }
+
+    Character* LegendaryCharacter::clone() const {
+        return new LegendaryCharacter(*this);
+    }
+
+    bool LegendaryCharacter::tryResurrect() {
+        return checkResurrection();
+    }
+
+    void LegendaryCharacter::displayAbilityStatus(ostream& os) const {
+        if (state.revived) {
+            os << "[Used] Resurrection - Already used once this battle\n";
+        }
+        else {
+            os << "[Passive] Resurrection - Will revive once with 25% health upon death\n";
+        }
     }
 
     bool LegendaryCharacter::hasResurrected() const {
-        return revived;
+        return state.revived;
     }
 
     // MirrorStriker implementation
     MirrorStriker::MirrorStriker(const string& name, int level)
-        : Character(name, level, 90 + (level * 18), 16 + (level * 3), 9 + (level * 2), 3),
-        mirrorStrikeActive(false), reflectionPercent(0.25f) {
+        : Character(CharacterKind::MIRROR_STRIKER, name, level),
+        reflectionPercent(0.25f) {
     }
 
     void MirrorStriker::attackTarget(Character& target) {
-        int damage = attack - (target.getDefense() / 3);
+        int damage = state.attack - (target.getDefense() / 3);
         if (damage < 1) damage = 1;
 
-        target.setHealth(target.getHealth() - damage);
+        int targetHealth = target.getHealth();
+        target.setHealth(targetHealth - damage);
+        traceEvent(TraceEventType::ATTACK, this, targetHealth - target.getHealth(), target.getHealth());
 
-        string attackLog = name + " attacks " + target.getName() + " for " + to_string(damage) + " damage";
-        if (mirrorStrikeActive) {
-            attackLog += " (Mirror Strike active!)";
-        }
-        logAction(attackLog);
+        logEvent(LogEventType::ATTACK, *this, &target, damage, state.abilityActive);
     }
 
     void MirrorStriker::useSpecialAbility() {
-        if (abilityStatus == SpecialAbilityStatus::READY) {
-            mirrorStrikeActive = true;
+        if (state.abilityStatus == SpecialAbilityStatus::READY) {
+            state.abilityActive = true;
 
-            string abilityLog = name + " activates Mirror Strike! Will reflect " +
-                to_string(static_cast<int>(reflectionPercent * 100)) +
-                "% of incoming damage back to attackers.";
-            cout << abilityLog << endl;
-            logAction(abilityLog);
+            logEvent(LogEventType::ABILITY_USED, *this, nullptr, static_cast<int>(reflectionPercent * 100));
 
             resetCooldown();
         }
         else {
-            string cooldownMsg = name + "'s Mirror Strike is on cooldown (" + to_string(currentCooldown) + " turns remaining)";
-            cout << cooldownMsg << endl;
-            logAction(cooldownMsg);
+            logEvent(LogEventType::ON_COOLDOWN, *this, nullptr, state.currentCooldown);
         }
     }
 
     void MirrorStriker::reflectDamage(int damage, Character& attacker) {
-        if (mirrorStrikeActive) {
+        if (state.abilityActive) {
             int reflectedDamage = static_cast<int>(damage * reflectionPercent);
             if (reflectedDamage < 1) reflectedDamage = 1;
 
             attacker.setHealth(attacker.getHealth() - reflectedDamage);
-
-            string reflectLog = name + "'s Mirror Strike reflects " + to_string(reflectedDamage) +
-                " damage back to " + attacker.getName() + "!";
-            cout << reflectLog << endl;
-            logAction(reflectLog);
+            traceEvent(TraceEventType::REFLECT, this, reflectedDamage, attacker.getHealth());
+            logEvent(LogEventType::REFLECTED, *this, &attacker, reflectedDamage);
         }
     }
 
     string MirrorStriker::getClassName() const {
-        return "MirrorStriker";
+        return CLASS_STATS[static_cast<int>(kind)].className;
     }
 
     string MirrorStriker::getSpecialAbilityName() const {
-        return "Mirror Strike";
+        return CLASS_STATS[static_cast<int>(kind)].abilityName;
+    }
+
+    Character* MirrorStriker::clone() const {
+        return new MirrorStriker(*this);
+    }
+
+    void MirrorStriker::onDamageTaken(int damage, Character& attacker) {
+        reflectDamage(damage, attacker);
+    }
+
+    void MirrorStriker::expireAbilities() {
+        deactivateMirrorStrike();
+    }
+
+    void MirrorStriker::displayAbilityStatus(ostream& os) const {
+        if (state.abilityActive) {
+            os << "[Active] Mirror Strike - Reflects 25% of damage back to attacker!\n";
+        }
+        else if (state.abilityStatus == SpecialAbilityStatus::COOLDOWN) {
+            os << "[Cooldown] Mirror Strike - Ready in " << state.currentCooldown << " turns\n";
+        }
+        else {
+            os << "[Ready] Mirror Strike - Use special ability to activate\n";
+        }
+    }
+
+    bool MirrorStriker::isAbilityActive() const {
+        return state.abilityActive;
     }
 
     bool MirrorStriker::isMirrorStrikeActive() const {
-        return mirrorStrikeActive;
+        return state.abilityActive;
     }
 
     void MirrorStriker::deactivateMirrorStrike() {
-        if (mirrorStrikeActive) {
-            mirrorStrikeActive = false;
+        if (state.abilityActive) {
+            state.abilityActive = false;
+            traceEvent(TraceEventType::ABILITY_ENDED, this, 0, 0);
+            logEvent(LogEventType::ABILITY_ENDED, *this, nullptr);
+        }
+    }
+
+    // CustomCharacter implementation
+    static StatBlock customStatBlock(const ClassDefinition& definition, int level) {
+        return { definition.baseHealth + level * definition.healthPerLevel, definition.baseAttack + level * definition.attackPerLevel,
+            definition.baseDefense + level * definition.defensePerLevel, definition.cooldown };
+    }
+
+    CustomCharacter::CustomCharacter(int classId, const string& name, int level)
+        : Character(CharacterKind::CUSTOM, name, level, customStatBlock(getCustomClass(classId), level).health,
+            customStatBlock(getCustomClass(classId), level).attack, customStatBlock(getCustomClass(classId), level).defense,
+            getCustomClass(classId).cooldown) {
+        this->classId = static_cast<uint8_t>(classId);
+        customClass = &getCustomClass(classId);
+    }
+
+    void CustomCharacter::attackTarget(Character& target) {
+        int defense = target.getDefense();
+        if (state.abilityActive && customClass->ignoreDefensePercent > 0) {
+            defense -= applyPercent(defense, customClass->ignoreDefensePercent);
+        }
+        int damage = state.attack - defense / customClass->damageDivisor;
+        if (damage < 1) damage = 1;
+        int targetHealth = target.getHealth();
+        target.setHealth(targetHealth - damage);
+        traceEvent(TraceEventType::ATTACK, this, targetHealth - target.getHealth(), target.getHealth());
+        logEvent(LogEventType::ATTACK, *this, &target, damage, state.abilityActive);
+    }
+
+    void CustomCharacter::useSpecialAbility() {
+        if (customClass->passive) {
+            logEvent(LogEventType::ABILITY_USED, *this, nullptr);
+            return;
+        }
+        if (state.abilityStatus == SpecialAbilityStatus::READY) {
+            state.abilityActive = true;
+            state.abilityDuration = 1;
+            logEvent(LogEventType::ABILITY_USED, *this, nullptr, customClass->reflectPercent);
+            resetCooldown();
+            logEvent(LogEventType::COOLDOWN_STARTED, *this, nullptr, state.currentCooldown);
+        }
+        else {
+            logEvent(LogEventType::ON_COOLDOWN, *this, nullptr, state.currentCooldown);
+        }
+    }
+
+    string CustomCharacter::getClassName() const {
+        return customClass->className;
+    }
+
+    string CustomCharacter::getSpecialAbilityName() const {
+        return customClass->abilityName;
+    }
+
+    Character* CustomCharacter::clone() const {
+        return new CustomCharacter(*this);
+    }
 
-            string deactivateLog = name + "'s Mirror Strike ends.";
-            cout << deactivateLog << endl;
-            logAction(deactivateLog);
+    bool CustomCharacter::negatesIncomingAttack(Character& attacker) {
+        if (!state.abilityActive || !customClass->negatesNextHit) {
+            return false;
         }
+        logEvent(LogEventType::ATTACK_NEGATED, *this, &attacker);
+        traceEvent(TraceEventType::ATTACK_NEGATED, &attacker, 0, 0);
+        deactivateAbility();
+        return true;
     }
 
+    void CustomCharacter::onDamageTaken(int damage, Character& attacker) {
+        if (state.abilityActive && customClass->reflectPercent > 0) {
+            int reflectedDamage = applyPercent(damage, customClass->reflectPercent);
+            if (reflectedDamage < 1) reflectedDamage = 1;
+            attacker.setHealth(attacker.getHealth() - reflectedDamage);
+            traceEvent(TraceEventType::REFLECT, this, reflectedDamage, attacker.getHealth());
+            logEvent(LogEventType::REFLECTED, *this, &attacker, reflectedDamage);
+        }
+    }
+
+    void CustomCharacter::expireAbilities() {
+        deactivateAbility();
+    }
+
+    bool CustomCharacter::tryResurrect() {
+        if (customClass->resurrectPercent == 0 || state.health > 0 || state.revived) {
+            return false;
+        }
+        int health = applyPercent(maxHealth, customClass->resurrectPercent);
+        state.health = health < 1 ? 1 : health;
+        state.revived = true;
+        traceEvent(TraceEventType::RESURRECT, this, state.health, 0);
+        logEvent(LogEventType::RESURRECTED, *this, nullptr, state.health);
+        return true;
+    }
+
+    bool CustomCharacter::attacksAfterAbility() const {
+        return state.abilityActive && customClass->attacksAfterAbility;
+    }
+
+    void CustomCharacter::displayAbilityStatus(ostream& os) const {
+        const string& ability = customClass->abilityName;
+        if (customClass->passive) {
+            os << (state.revived ? "[Used] " : "[Passive] ") << ability << " - Revives once with "
+                << customClass->resurrectPercent << "% health\n";
+        }
+        else if (state.abilityActive) {
+            os << "[Active] " << ability << " - Ends at the start of the next turn\n";
+        }
+        else if (state.abilityStatus == SpecialAbilityStatus::COOLDOWN) {
+            os << "[Cooldown] " << ability << " - Ready in " << state.currentCooldown << " turns\n";
+        }
+        else {
+            os << "[Ready] " << ability << " - Use special ability to activate\n";
+        }
+    }
+
+    bool CustomCharacter::isAbilityActive() const {
+        return state.abilityActive;
+    }
+
+    void CustomCharacter::deactivateAbility() {
+        if (state.abilityActive) {
+            state.abilityActive = false;
+            traceEvent(TraceEventType::ABILITY_ENDED, this, 0, 0);
+            state.abilityDuration = 0;
+            logEvent(LogEventType::ABILITY_ENDED, *this, nullptr);
+        }
+    }
+
+    Character* createCharacterOfClass(int classId, const string& name, int level) {
+        if (classId >= 0 && classId < CHARACTER_KIND_COUNT) {
+            return createCharacter(static_cast<CharacterKind>(classId), name, level);
+        }
+        return isCustomClassId(classId) ? new CustomCharacter(classId, name, level) : nullptr;
+    }
+
+    Character* createCharacter(CharacterKind kind, const string& name, int level) {
+        switch (kind) {
+        case CharacterKind::WARRIOR:
+            return new Warrior(name, level);
+        case CharacterKind::MAGE:
+            return new Mage(name, level);
+        case CharacterKind::ARCHER:
+            return new Archer(name, level);
+        case CharacterKind::LEGENDARY:
+            return new LegendaryCharacter(name, level);
+        case CharacterKind::MIRROR_STRIKER:
+            return new MirrorStriker(name, level);
+        case CharacterKind::CUSTOM:
+            break; // Needs a class id, see createCharacterOfClass
+        }
+        return nullptr;
+    }
 } // namespace FantasyArena
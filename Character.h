@@ -4,35 +4,78 @@
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <type_traits>
+#include "AsyncLogSink.h"
+#include "BattleTrace.h"
+#include "FrameRenderer.h"
+#include "LogEvent.h"
+#include "ClassDefinitions.h"
 using namespace std;
 namespace FantasyArena {
     enum class SpecialAbilityStatus {
         READY,
         COOLDOWN
     };
+    // Concrete class of a character, stored on the object so hot paths can
+    // dispatch without calling getClassName() or dynamic_cast
+    enum class CharacterKind : unsigned char {
+        WARRIOR,
+        MAGE,
+        ARCHER,
+        LEGENDARY,
+        MIRROR_STRIKER,
+        CUSTOM // Loaded from a class definitions file; not a row of the per-kind tables
+    };
+    // Display names by kind, for code that only has the tag (e.g. trace replay)
+    string getClassNameForKind(CharacterKind kind);
+    string getAbilityNameForKind(CharacterKind kind);
+    const int CHARACTER_KIND_COUNT = 5; // Built-in kinds, the rows of the per-kind tables
+
+    // Everything about a character that changes during a battle. Plain data,
+    // so a fighter is reset from its roster template with a single copy.
+    struct CombatState {
+        int health;
+        int attack;
+        int defense;
+        int currentCooldown;
+        int abilityDuration;   // Duration of ability effects in turns
+        SpecialAbilityStatus abilityStatus;
+        bool abilityActive;    // Transparent, Mirror Image, Evasive Roll or Mirror Strike is up
+        bool revived;          // Legendary resurrection already used
+    };
+    static_assert(is_trivially_copyable<CombatState>::value, "CombatState must stay plain data");
+
     // Forward declaration for attack reflection
     class Character;
     class Character {
     protected:
+        // Profile, fixed once the character is created
+        CharacterKind kind;
         string name;
         int level;
-        int health;
         int maxHealth;
-        int attack;
         int originalAttack;  // Store original attack value
-        int defense;
         int originalDefense; // Store original defense value
         int specialAbilityCooldown;
-        int currentCooldown;
-        int abilityDuration; // Duration of ability effects in turns
-        SpecialAbilityStatus abilityStatus;
-        static ofstream logFile; // Static log file for all characters
-        static string environmentName; // Static environment name for log file
+        uint8_t logName; // Handle of the name in the attached log sink
+        uint8_t classId; // The kind for built-in classes (ClassDefinitions.h)
+        const ClassDefinition* customClass; // Dispatch entry of a custom class, else nullptr
+        // Everything a battle changes
+        CombatState state;
+        // Per thread, so battles on worker threads never see each other's log or trace
+        static thread_local AsyncLogSink* logSink; // Log of the battle in progress, owned by its Arena
+        static thread_local BattleTraceWriter* traceWriter; // Binary trace of the battle in progress, if any
+        static ConsoleMode consoleMode; // How much of a battle is echoed to the console
+        static void recordLogEvent(LogEventType type, const Character& actor, const Character* target, int value, int aux);
     public:
-        Character(const string& name, int level, int health, int attack, int defense, int cooldown);
+        Character(CharacterKind kind, const string& name, int level); // Stats from the class table (StatTables.h)
+        Character(CharacterKind kind, const string& name, int level, int health, int attack, int defense, int cooldown);
         virtual ~Character() = default;
         // Getters
-        std::string getName() const;
+        CharacterKind getKind() const { return kind; }
+        int getClassId() const { return classId; }
+        const ClassDefinition* getClassDefinition() const { return customClass; }
+        const std::string& getName() const;
         int getLevel() const;
         int getHealth() const;
         int getMaxHealth() const;
@@ -40,6 +83,7 @@ namespace FantasyArena {
         int getDefense() const;
         SpecialAbilityStatus getAbilityStatus() const;
         int getCurrentCooldown() const;
+        int getSpecialAbilityCooldown() const;
         // Setters
         void setHealth(int health);
         void setAttack(int attack);
@@ -51,11 +95,49 @@ namespace FantasyArena {
         virtual void useSpecialAbility() = 0;
         virtual string getClassName() const = 0;
         virtual string getSpecialAbilityName() const = 0;
-        // Static method to open and close log file
-        static void openLogFile();
-        static void closeLogFile();
+        virtual Character* clone() const = 0; // Independent copy, e.g. for a fighter pool
+        // Battle state snapshot
+        const CombatState& getCombatState() const { return state; }
+        void setCombatState(const CombatState& newState) { state = newState; }
+        // Become a fresh copy of a character of the same class; reuses this
+        // object's storage, so a pooled fighter is reset without allocating
+        void resetFrom(const Character& source);
+        // Defensive and reactive ability hooks called by the arena turn loop.
+        // The defaults describe a character without such an ability.
+        virtual bool negatesIncomingAttack(Character& attacker); // True if the attack misses
+        virtual void onDamageTaken(int damage, Character& attacker); // React to a landed hit
+        virtual void expireAbilities(); // Start of own turn: end abilities that lasted one turn
+        virtual bool tryResurrect(); // True if the character came back after dying
+        virtual bool attacksAfterAbility() const; // Ability use is followed by an attack
+        virtual void displayAbilityStatus(ostream& os) const; // One status line for the turn display
+        virtual bool isAbilityActive() const; // A timed ability effect is currently running
+        // Battle log shared with the arena (nullptr when no battle is being logged)
+        static void attachLogSink(AsyncLogSink* sink) { logSink = sink; }
+        static AsyncLogSink* getLogSink() { return logSink; }
         static void logAction(const string& action);
-        static void setEnvironmentName(const string& envName) { environmentName = envName; }
+        // Structured log call: records the event and only builds text for the
+        // console (in full mode) and the log sink (on its own thread)
+        static void logEvent(LogEventType type, const Character& actor, const Character* target, int value = 0, int aux = 0) {
+            if (logSink || consoleMode == ConsoleMode::FULL) {
+                recordLogEvent(type, actor, target, value, aux);
+            }
+        }
+        static bool isLogConsumed() { return logSink || consoleMode == ConsoleMode::FULL; } // Worth building log text
+        static void registerLogName(Character& character); // Give the character a name handle in the attached sink
+        // Binary battle trace (nullptr when no trace is being recorded)
+        static void attachTraceWriter(BattleTraceWriter* writer) { traceWriter = writer; }
+        static void traceEvent(TraceEventType type, const Character* actor, int value, int aux) {
+            if (traceWriter) {
+                traceWriter->record(type, actor, value, aux);
+            }
+        }
+        // Console output (disabled for headless simulation)
+        static void setConsoleMode(ConsoleMode mode) { consoleMode = mode; }
+        static ConsoleMode getConsoleMode() { return consoleMode; }
+        static void setConsoleOutput(bool enabled) { consoleMode = enabled ? ConsoleMode::FULL : ConsoleMode::QUIET; }
+        static bool isConsoleOutputEnabled() { return consoleMode == ConsoleMode::FULL; } // Turn by turn
+        static bool isBattleSummaryEnabled() { return consoleMode != ConsoleMode::QUIET; }
+        static void display(const string& message); // Adds a line to the current frame
         // Check if character is alive
         bool isAlive() const;
         // Operator overloading
@@ -65,50 +147,56 @@ namespace FantasyArena {
     };
 
     class Warrior : public Character {
-    private:
-        bool transparentActive; // Flag to track if invisibility is active
-        int transparentDuration; // Duration counter for invisibility
     public:
         Warrior(const string& name, int level);
         void attackTarget(Character& target) override;
         void useSpecialAbility() override;
         string getClassName() const override;
         string getSpecialAbilityName() const override;
+        Character* clone() const override;
+        bool negatesIncomingAttack(Character& attacker) override;
+        void expireAbilities() override;
+        void displayAbilityStatus(ostream& os) const override;
+        bool isAbilityActive() const override;
         bool isTransparentActive() const; // Check if invisibility is active
         void deactivateTransparent(); // Deactivate invisibility
     };
 
     class Mage : public Character {
-    private:
-        bool mirrorImageActive; // Flag to track if Mirror Image is active
-        int mirrorImageDuration; // Duration counter for Mirror Image
     public:
         Mage(const string& name, int level);
         void attackTarget(Character& target) override;
         void useSpecialAbility() override;
         string getClassName() const override;
         string getSpecialAbilityName() const override;
+        Character* clone() const override;
+        bool negatesIncomingAttack(Character& attacker) override;
+        void expireAbilities() override;
+        void displayAbilityStatus(ostream& os) const override;
+        bool isAbilityActive() const override;
         bool isMirrorImageActive() const; // Check if Mirror Image is active
         void deactivateMirrorImage(); // Deactivate Mirror Image
     };
 
     class Archer : public Character {
-    private:
-        bool evasiveRollActive; // Flag to track if Evasive Roll is active
-        int evasiveRollDuration; // Duration counter for Evasive Roll
     public:
         Archer(const string& name, int level);
         void attackTarget(Character& target) override;
         void useSpecialAbility() override;
         string getClassName() const override;
         string getSpecialAbilityName() const override;
+        Character* clone() const override;
+        bool negatesIncomingAttack(Character& attacker) override;
+        void expireAbilities() override;
+        bool attacksAfterAbility() const override;
+        void displayAbilityStatus(ostream& os) const override;
+        bool isAbilityActive() const override;
         bool isEvasiveRollActive() const; // Check if Evasive Roll is active
         void deactivateEvasiveRoll(); // Deactivate Evasive Roll
     };
 
     class LegendaryCharacter : public Character {
     private:
-        bool revived;
         float resurrectionHealthPercent;
     public:
         LegendaryCharacter(const string& name, int level);
@@ -116,13 +204,15 @@ namespace FantasyArena {
         void useSpecialAbility() override; // Resurrection is passive
         string getClassName() const override;
         string getSpecialAbilityName() const override;
+        Character* clone() const override;
+        bool tryResurrect() override;
+        void displayAbilityStatus(ostream& os) const override;
         bool checkResurrection(); // Check if character should resurrect
         bool hasResurrected() const;
     };
 
     class MirrorStriker : public Character {
     private:
-        bool mirrorStrikeActive;
         float reflectionPercent;
     public:
         MirrorStriker(const string& name, int level);
@@ -130,9 +220,39 @@ namespace FantasyArena {
         void useSpecialAbility() override;
         string getClassName() const override;
         string getSpecialAbilityName() const override;
+        Character* clone() const override;
+        void onDamageTaken(int damage, Character& attacker) override;
+        void expireAbilities() override;
+        void displayAbilityStatus(ostream& os) const override;
+        bool isAbilityActive() const override;
         bool isMirrorStrikeActive() const;
         void reflectDamage(int damage, Character& attacker); // Reflect damage back to attacker
         void deactivateMirrorStrike();
     };
+
+    // A class from a definitions file. Every hook reads the compiled entry,
+    // so there is no per-class code and no lookup on the combat path.
+    class CustomCharacter : public Character {
+    public:
+        CustomCharacter(int classId, const string& name, int level);
+        void attackTarget(Character& target) override;
+        void useSpecialAbility() override;
+        string getClassName() const override;
+        string getSpecialAbilityName() const override;
+        Character* clone() const override;
+        bool negatesIncomingAttack(Character& attacker) override;
+        void onDamageTaken(int damage, Character& attacker) override;
+        void expireAbilities() override;
+        bool tryResurrect() override;
+        bool attacksAfterAbility() const override;
+        void displayAbilityStatus(ostream& os) const override;
+        bool isAbilityActive() const override;
+        void deactivateAbility();
+    };
+
+    // Create a character of the given class; the caller owns the result
+    Character* createCharacter(CharacterKind kind, const string& name, int level);
+    // Likewise for any class id, built-in or custom; nullptr for an unknown id
+    Character* createCharacterOfClass(int classId, const string& name, int level);
 } // namespace FantasyArena
 #endif // CHARACTER_H
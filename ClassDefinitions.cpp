@@ -0,0 +1,295 @@
+#include "ClassDefinitions.h"
+#include "Character.h"
+#include "StatTables.h"
+#include <fstream>
+#include <sstream>
+#include <cctype>
+using namespace std;
+namespace FantasyArena {
+    static_assert(FIRST_CUSTOM_CLASS_ID == CHARACTER_KIND_COUNT, "Custom class ids follow the built-in kinds");
+    static_assert(FIRST_CUSTOM_CLASS_ID + CUSTOM_CLASS_CAPACITY <= 255, "Class ids are stored in a byte");
+
+    // Reserved up front: characters keep pointers to their entry
+    static vector<ClassDefinition>& customClasses() {
+        static vector<ClassDefinition> table = [] {
+            vector<ClassDefinition> reserved;
+            reserved.reserve(CUSTOM_CLASS_CAPACITY);
+            return reserved;
+        }();
+        return table;
+    }
+
+    namespace {
+        string trim(const string& text) {
+            size_t begin = text.find_first_not_of(" \t\r");
+            if (begin == string::npos) {
+                return "";
+            }
+            size_t end = text.find_last_not_of(" \t\r");
+            return text.substr(begin, end - begin + 1);
+        }
+
+        // Lower case without spaces and underscores, as class names are matched
+        string nameKey(const string& name) {
+            string key;
+            for (char c : name) {
+                if (c != ' ' && c != '_') {
+                    key += static_cast<char>(tolower(static_cast<unsigned char>(c)));
+                }
+            }
+            return key;
+        }
+
+        bool parseNumbers(const string& text, int* values, int count) {
+            istringstream in(text);
+            for (int i = 0; i < count; ++i) {
+                if (!(in >> values[i])) {
+                    return false;
+                }
+            }
+            string rest;
+            return !(in >> rest);
+        }
+
+        bool parsePercent(const string& text, int& percent) {
+            return parseNumbers(text, &percent, 1) && percent >= 1 && percent <= 100;
+        }
+
+        // Fields seen in the current section
+        enum DefinitionField {
+            FIELD_ABILITY = 1,
+            FIELD_HEALTH = 2,
+            FIELD_ATTACK = 4,
+            FIELD_DEFENSE = 8,
+            FIELD_COOLDOWN = 16,
+            FIELD_DIVISOR = 32,
+            FIELD_EFFECTS = 64,
+            FIELD_ALL = 127
+        };
+
+        bool parseEffects(const string& text, ClassDefinition& definition, string& reason) {
+            stringstream list(text);
+            string effect;
+            while (getline(list, effect, ',')) {
+                effect = trim(effect);
+                size_t space = effect.find_first_of(" \t");
+                string name = effect.substr(0, space);
+                string argument = space == string::npos ? "" : effect.substr(space + 1);
+                int* percent = nullptr;
+                if (name == "negate_next_hit" && argument.empty()) {
+                    definition.negatesNextHit = true;
+                    continue;
+                }
+                if (name == "reflect_percent") {
+                    percent = &definition.reflectPercent;
+                }
+                else if (name == "ignore_defense_percent") {
+                    percent = &definition.ignoreDefensePercent;
+                }
+                else if (name == "resurrect_percent") {
+                    percent = &definition.resurrectPercent;
+                }
+                else {
+                    reason = "unknown effect \"" + effect + "\"";
+                    return false;
+                }
+                if (!parsePercent(argument, *percent)) {
+                    reason = name + " needs a percentage from 1 to 100";
+                    return false;
+                }
+            }
+            if (!definition.negatesNextHit && definition.reflectPercent == 0 && definition.ignoreDefensePercent == 0 &&
+                definition.resurrectPercent == 0) {
+                reason = "effects must name at least one effect";
+                return false;
+            }
+            return true;
+        }
+
+        // Check a finished section and fill in the derived fields
+        bool compileDefinition(ClassDefinition& definition, int fields, const vector<ClassDefinition>& loaded,
+            string& reason) {
+            if (fields != FIELD_ALL) {
+                reason = definition.className + " needs ability, health, attack, defense, cooldown, damage_divisor and effects";
+                return false;
+            }
+            if (definition.baseHealth + definition.healthPerLevel < 1 || definition.healthPerLevel < 0 ||
+                definition.attackPerLevel < 0 || definition.defensePerLevel < 0 || definition.baseAttack < 0 ||
+                definition.baseDefense < 0) {
+                reason = definition.className + " needs positive health and no negative stats";
+                return false;
+            }
+            if (definition.damageDivisor < 1 || definition.cooldown < 0 || definition.cooldown > 20) {
+                reason = definition.className + " needs damage_divisor >= 1 and a cooldown of 0-20 turns";
+                return false;
+            }
+            string key = nameKey(definition.className);
+            for (int k = 0; k < CHARACTER_KIND_COUNT; ++k) {
+                if (nameKey(CLASS_STATS[k].className) == key) {
+                    reason = definition.className + " is a built-in class";
+                    return false;
+                }
+            }
+            for (const ClassDefinition& other : loaded) {
+                if (nameKey(other.className) == key) {
+                    reason = definition.className + " is defined twice";
+                    return false;
+                }
+            }
+            definition.passive = !definition.negatesNextHit && definition.reflectPercent == 0 &&
+                definition.ignoreDefensePercent == 0;
+            if (definition.passive) {
+                definition.cooldown = 0; // Like Resurrection, nothing to recharge
+            }
+            definition.attacksAfterAbility = definition.ignoreDefensePercent > 0;
+            return true;
+        }
+    }
+
+    bool loadClassDefinitions(const string& path, string& error) {
+        ifstream in(path);
+        if (!in.is_open()) {
+            error = "could not open the file";
+            return false;
+        }
+        vector<ClassDefinition> loaded = customClasses();
+        ClassDefinition current;
+        int fields = 0;
+        bool inSection = false;
+        string line;
+        int lineNumber = 0;
+        string reason;
+        auto fail = [&](const string& why) {
+            error = "line " + to_string(lineNumber) + ": " + why;
+            return false;
+        };
+        auto finishSection = [&]() {
+            if (!inSection) {
+                return true;
+            }
+            if (!compileDefinition(current, fields, loaded, reason)) {
+                return false;
+            }
+            loaded.push_back(current);
+            return true;
+        };
+        while (getline(in, line)) {
+            ++lineNumber;
+            size_t comment = line.find('#');
+            line = trim(comment == string::npos ? line : line.substr(0, comment));
+            if (line.empty()) {
+                continue;
+            }
+            if (line.front() == '[') {
+                if (!finishSection()) {
+                    return fail(reason);
+                }
+                if (line.back() != ']') {
+                    return fail("expected [ClassName]");
+                }
+                string name = trim(line.substr(1, line.size() - 2));
+                if (name.empty() || name.size() > CLASS_NAME_MAX_LENGTH || name.find(',') != string::npos) {
+                    return fail("class names are 1-" + to_string(CLASS_NAME_MAX_LENGTH) + " characters without commas");
+                }
+                if (loaded.size() == static_cast<size_t>(CUSTOM_CLASS_CAPACITY)) {
+                    return fail("at most " + to_string(CUSTOM_CLASS_CAPACITY) + " classes can be defined");
+                }
+                current = ClassDefinition();
+                current.className = name;
+                fields = 0;
+                inSection = true;
+                continue;
+            }
+            size_t equals = line.find('=');
+            if (!inSection || equals == string::npos) {
+                return fail("expected key = value inside a [ClassName] section");
+            }
+            string key = trim(line.substr(0, equals));
+            string value = trim(line.substr(equals + 1));
+            int field;
+            bool valid;
+            if (key == "ability") {
+                field = FIELD_ABILITY;
+                current.abilityName = value;
+                valid = !value.empty() && value.size() <= CLASS_NAME_MAX_LENGTH;
+            }
+            else if (key == "health") {
+                field = FIELD_HEALTH;
+                int values[2];
+                valid = parseNumbers(value, values, 2);
+                current.baseHealth = values[0];
+                current.healthPerLevel = values[1];
+            }
+            else if (key == "attack") {
+                field = FIELD_ATTACK;
+                int values[2];
+                valid = parseNumbers(value, values, 2);
+                current.baseAttack = values[0];
+                current.attackPerLevel = values[1];
+            }
+            else if (key == "defense") {
+                field = FIELD_DEFENSE;
+                int values[2];
+                valid = parseNumbers(value, values, 2);
+                current.baseDefense = values[0];
+                current.defensePerLevel = values[1];
+            }
+            else if (key == "cooldown") {
+                field = FIELD_COOLDOWN;
+                valid = parseNumbers(value, &current.cooldown, 1);
+            }
+            else if (key == "damage_divisor") {
+                field = FIELD_DIVISOR;
+                valid = parseNumbers(value, &current.damageDivisor, 1);
+            }
+            else if (key == "effects") {
+                field = FIELD_EFFECTS;
+                valid = parseEffects(value, current, reason);
+                if (!valid) {
+                    return fail(reason);
+                }
+            }
+            else {
+                return fail("unknown key \"" + key + "\"");
+            }
+            if (!valid) {
+                return fail("bad value for " + key);
+            }
+            if (fields & field) {
+                return fail(key + " is given twice");
+            }
+            fields |= field;
+        }
+        if (!finishSection()) {
+            return fail(reason);
+        }
+        customClasses().assign(loaded.begin(), loaded.end()); // Within the reserved capacity
+        return true;
+    }
+
+    size_t getCustomClassCount() {
+        return customClasses().size();
+    }
+
+    const ClassDefinition& getCustomClass(int classId) {
+        return customClasses()[classId - FIRST_CUSTOM_CLASS_ID];
+    }
+
+    int getClassCount() {
+        return FIRST_CUSTOM_CLASS_ID + static_cast<int>(customClasses().size());
+    }
+
+    string getClassNameForId(int classId) {
+        if (classId >= 0 && classId < CHARACTER_KIND_COUNT) {
+            return CLASS_STATS[classId].className;
+        }
+        return isCustomClassId(classId) ? getCustomClass(classId).className : "Unknown";
+    }
+
+    string getAbilityNameForId(int classId) {
+        if (classId >= 0 && classId < CHARACTER_KIND_COUNT) {
+            return CLASS_STATS[classId].abilityName;
+        }
+        return isCustomClassId(classId) ? getCustomClass(classId).abilityName : "Unknown";
+    }
+} // namespace FantasyArena
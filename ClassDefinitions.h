@@ -0,0 +1,67 @@
+#pragma once
+#ifndef CLASS_DEFINITIONS_H
+#define CLASS_DEFINITIONS_H
+#include <string>
+#include <vector>
+#include <cstdint>
+using namespace std;
+namespace FantasyArena {
+    // Class ids: the CharacterKind values for the built-in classes, then one
+    // per loaded definition, in file order
+    const int FIRST_CUSTOM_CLASS_ID = 5; // CHARACTER_KIND_COUNT, checked in ClassDefinitions.cpp
+    const int CUSTOM_CLASS_CAPACITY = 64;
+    const size_t CLASS_NAME_MAX_LENGTH = 31;
+
+    // One compiled entry of the dispatch table. The ability is a combination
+    // of primitives; everything the combat hooks need is a plain field, so a
+    // custom class costs the same per hit as a built-in one.
+    struct ClassDefinition {
+        string className;
+        string abilityName;
+        int baseHealth;
+        int healthPerLevel;
+        int baseAttack;
+        int attackPerLevel;
+        int baseDefense;
+        int defensePerLevel;
+        int cooldown;
+        int damageDivisor;        // Damage is attack - target defense / divisor, at least 1
+        // Ability primitives, active from the ability's use to the start of the owner's next turn
+        bool negatesNextHit;      // The next incoming attack misses and ends the ability
+        int reflectPercent;       // Share of the damage taken dealt back to the attacker (at least 1)
+        int ignoreDefensePercent; // Using the ability is followed by an attack ignoring this share of defense
+        int resurrectPercent;     // Passive: revive once per battle with this share of maximum health
+        // Derived when the definition is compiled
+        bool passive;             // Resurrection only: nothing to activate, no cooldown
+        bool attacksAfterAbility;
+    };
+
+    // Read class definitions and append them to the table. Must run before
+    // any character of these classes exists. One section per class:
+    //   [Paladin]
+    //   ability = Holy Shield
+    //   health = 110 20          (base, per level; likewise attack and defense)
+    //   attack = 14 3
+    //   defense = 12 2
+    //   cooldown = 3
+    //   damage_divisor = 3
+    //   effects = negate_next_hit, reflect_percent 20
+    // Effects: negate_next_hit, reflect_percent N, ignore_defense_percent N,
+    // resurrect_percent N. False with "line N: reason" in `error`, leaving
+    // the table unchanged, if any definition is invalid.
+    bool loadClassDefinitions(const string& path, string& error);
+
+    size_t getCustomClassCount();
+    // Definition of a custom class id (FIRST_CUSTOM_CLASS_ID and up)
+    const ClassDefinition& getCustomClass(int classId);
+    inline bool isCustomClassId(int classId) {
+        return classId >= FIRST_CUSTOM_CLASS_ID && classId < FIRST_CUSTOM_CLASS_ID + static_cast<int>(getCustomClassCount());
+    }
+    int getClassCount(); // Built-in plus loaded classes
+
+    // Names for any class id; "Unknown" for an id that is not loaded (e.g. a
+    // trace recorded with other definitions)
+    string getClassNameForId(int classId);
+    string getAbilityNameForId(int classId);
+} // namespace FantasyArena
+#endif // CLASS_DEFINITIONS_H
@@ -0,0 +1,162 @@
+#include "CombatModel.h"
+#include "StatTables.h"
+#include <utility>
+using namespace std;
+namespace FantasyArena {
+    ModelFighter makeModelFighter(const Character& character) {
+        const CombatState& state = character.getCombatState();
+        ModelFighter fighter;
+        fighter.health = state.health;
+        fighter.maxHealth = character.getMaxHealth();
+        fighter.attack = state.attack;
+        fighter.defense = state.defense;
+        fighter.cooldown = state.currentCooldown;
+        fighter.cooldownLength = character.getSpecialAbilityCooldown();
+        fighter.kind = character.getKind();
+        fighter.classId = static_cast<uint8_t>(character.getClassId());
+        fighter.customClass = character.getClassDefinition();
+        fighter.abilityReady = state.abilityStatus == SpecialAbilityStatus::READY;
+        fighter.abilityActive = state.abilityActive;
+        fighter.revived = state.revived;
+        return fighter;
+    }
+
+    ModelState makeModelState(const Character& self, const Character& opponent) {
+        return { makeModelFighter(self), makeModelFighter(opponent) };
+    }
+
+    // Transparent, Mirror Image, Evasive Roll and negate_next_hit make incoming attacks miss
+    static bool negatesAttacks(const ModelFighter& fighter) {
+        if (fighter.customClass) {
+            return fighter.abilityActive && fighter.customClass->negatesNextHit;
+        }
+        return fighter.abilityActive && (fighter.kind == CharacterKind::WARRIOR ||
+            fighter.kind == CharacterKind::MAGE || fighter.kind == CharacterKind::ARCHER);
+    }
+
+    // As CustomCharacter::attackTarget; the ability is only active during the owner's turn right after using it
+    static int32_t customDamage(const ModelFighter& attacker, int32_t defense) {
+        const ClassDefinition& definition = *attacker.customClass;
+        if (attacker.abilityActive && definition.ignoreDefensePercent > 0) {
+            defense -= applyPercent(defense, definition.ignoreDefensePercent);
+        }
+        int32_t damage = attacker.attack - defense / definition.damageDivisor;
+        return damage < 1 ? 1 : damage;
+    }
+
+    int32_t modelAttackDamage(const ModelFighter& attacker, const ModelFighter& defender) {
+        return attacker.customClass ? customDamage(attacker, defender.defense) :
+            attackDamage(attacker.kind, attacker.attack, defender.defense, false);
+    }
+
+    int32_t modelResurrectionHealth(const ModelFighter& fighter) {
+        if (fighter.revived) {
+            return 0;
+        }
+        if (fighter.customClass) {
+            int32_t percent = fighter.customClass->resurrectPercent;
+            int32_t health = applyPercent(fighter.maxHealth, percent);
+            return percent == 0 ? 0 : health < 1 ? 1 : health;
+        }
+        return fighter.kind == CharacterKind::LEGENDARY ? fighter.maxHealth / 4 : 0;
+    }
+
+    static int32_t reflectedDamage(const ModelFighter& defender, int32_t dealt) {
+        if (!defender.abilityActive) {
+            return 0;
+        }
+        if (defender.customClass) {
+            return defender.customClass->reflectPercent == 0 ? 0 :
+                max(applyPercent(dealt, defender.customClass->reflectPercent), 1);
+        }
+        return defender.kind == CharacterKind::MIRROR_STRIKER ? max(dealt / 4, 1) : 0;
+    }
+
+    static void strike(ModelFighter& attacker, ModelFighter& defender, bool evasive) {
+        int32_t damage = attacker.customClass ? customDamage(attacker, defender.defense) :
+            attackDamage(attacker.kind, attacker.attack, defender.defense, evasive);
+        int32_t dealt = damage > defender.health ? defender.health : damage;
+        defender.health -= dealt;
+        int32_t reflected = reflectedDamage(defender, dealt);
+        if (reflected > 0) {
+            attacker.health = attacker.health > reflected ? attacker.health - reflected : 0;
+        }
+    }
+
+    ModelOutcome applyModelAction(ModelState& state, BattleAction action) {
+        ModelFighter& actor = state.toMove;
+        ModelFighter& target = state.waiting;
+        if (action == BattleAction::SPECIAL_ABILITY && actor.abilityReady) {
+            // Resurrection is passive: using it only spends the turn
+            actor.abilityActive = actor.customClass ? !actor.customClass->passive : actor.kind != CharacterKind::LEGENDARY;
+            actor.cooldown = actor.cooldownLength;
+            actor.abilityReady = false;
+            if (actor.kind == CharacterKind::ARCHER) {
+                // The evasive attack is not subject to the target's negation and ends the roll
+                strike(actor, target, true);
+                actor.abilityActive = false;
+            }
+            else if (actor.customClass && actor.customClass->attacksAfterAbility) {
+                // Likewise not negated, but the ability stays up until the next turn
+                strike(actor, target, false);
+            }
+        }
+        else if (negatesAttacks(target)) {
+            // Transparent stays up; Mirror Image, Evasive Roll and negate_next_hit are used up
+            if (target.kind != CharacterKind::WARRIOR) {
+                target.abilityActive = false;
+            }
+        }
+        else {
+            strike(actor, target, false);
+        }
+
+        if (target.health <= 0) {
+            int32_t revivedHealth = modelResurrectionHealth(target);
+            if (revivedHealth > 0) {
+                target.health = revivedHealth;
+                target.revived = true;
+            }
+            else {
+                return actor.health > 0 ? ModelOutcome::ACTOR_WINS : ModelOutcome::DRAW;
+            }
+        }
+        if (actor.health <= 0) {
+            return ModelOutcome::ACTOR_LOSES;
+        }
+
+        // Start of the other fighter's turn
+        if (target.cooldown > 0) {
+            target.cooldown--;
+            if (target.cooldown == 0) {
+                target.abilityReady = true;
+            }
+        }
+        target.abilityActive = false;
+        swap(state.toMove, state.waiting);
+        return ModelOutcome::ONGOING;
+    }
+
+    static uint64_t mix(uint64_t hash, uint64_t value) {
+        // splitmix64 finaliser over the running hash
+        hash ^= value + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+        hash ^= hash >> 30;
+        hash *= 0xBF58476D1CE4E5B9ull;
+        hash ^= hash >> 27;
+        hash *= 0x94D049BB133111EBull;
+        return hash ^ (hash >> 31);
+    }
+
+    static uint64_t hashFighter(uint64_t hash, const ModelFighter& fighter) {
+        hash = mix(hash, static_cast<uint32_t>(fighter.health) | static_cast<uint64_t>(static_cast<uint32_t>(fighter.maxHealth)) << 32);
+        hash = mix(hash, static_cast<uint32_t>(fighter.attack) | static_cast<uint64_t>(static_cast<uint32_t>(fighter.defense)) << 32);
+        uint64_t flags = static_cast<uint64_t>(fighter.classId) | (fighter.abilityReady ? 0x100u : 0u) |
+            (fighter.abilityActive ? 0x200u : 0u) | (fighter.revived ? 0x400u : 0u);
+        hash = mix(hash, static_cast<uint32_t>(fighter.cooldown) | static_cast<uint64_t>(static_cast<uint32_t>(fighter.cooldownLength)) << 32);
+        return mix(hash, flags);
+    }
+
+    uint64_t hashModelState(const ModelState& state) {
+        return hashFighter(hashFighter(0, state.toMove), state.waiting);
+    }
+} // namespace FantasyArena
@@ -0,0 +1,56 @@
+#pragma once
+#ifndef COMBAT_MODEL_H
+#define COMBAT_MODEL_H
+#include <cstdint>
+#include "Character.h"
+#include "ActionPolicy.h"
+using namespace std;
+namespace FantasyArena {
+    // One fighter as seen by look-ahead code: the profile values that matter
+    // for combat plus its CombatState, without names, logs or virtual calls
+    struct ModelFighter {
+        int32_t health;
+        int32_t maxHealth;
+        int32_t attack;
+        int32_t defense;
+        int32_t cooldown;        // Turns until the ability is ready
+        int32_t cooldownLength;  // Cooldown after using the ability
+        CharacterKind kind;
+        uint8_t classId;                    // Same as kind for built-in classes
+        const ClassDefinition* customClass; // Compiled rules of a custom class, else nullptr
+        bool abilityReady;
+        bool abilityActive;
+        bool revived;
+    };
+
+    // A battle at the moment `toMove` chooses its action, i.e. after the start
+    // of its turn (cooldown tick and expiry of its one-turn abilities)
+    struct ModelState {
+        ModelFighter toMove;
+        ModelFighter waiting;
+    };
+
+    enum class ModelOutcome {
+        ONGOING,
+        ACTOR_WINS,  // The fighter that just acted won
+        ACTOR_LOSES, // It died to Mirror Strike reflection
+        DRAW         // Both died in the same turn (the arena then names player 2 the winner)
+    };
+
+    ModelFighter makeModelFighter(const Character& character);
+    ModelState makeModelState(const Character& self, const Character& opponent);
+
+    // Damage of a plain attack, and the health an unused resurrection would
+    // restore (0 if there is none left)
+    int32_t modelAttackDamage(const ModelFighter& attacker, const ModelFighter& defender);
+    int32_t modelResurrectionHealth(const ModelFighter& fighter);
+
+    // Play one action exactly as Arena::processTurn and the battle loop do,
+    // including negation, Evasive Roll's attack, Mirror Strike reflection,
+    // Legendary resurrection and the primitives of custom classes, then start the other fighter's turn and swap
+    // the sides. A special ability that is not ready is played as an attack.
+    ModelOutcome applyModelAction(ModelState& state, BattleAction action);
+
+    uint64_t hashModelState(const ModelState& state);
+} // namespace FantasyArena
+#endif // COMBAT_MODEL_H
@@ -0,0 +1,41 @@
+#include "CombatantPool.h"
+using namespace std;
+namespace FantasyArena {
+    CombatantPool::CombatantPool() : allocated(0) {
+    }
+
+    CombatantPool::~CombatantPool() {
+        for (vector<Character*>& fighters : available) {
+            for (Character* fighter : fighters) {
+                delete fighter;
+            }
+        }
+    }
+
+    Character* CombatantPool::acquire(const Character& source) {
+        vector<Character*>& fighters = available[static_cast<int>(source.getKind())];
+        if (fighters.empty()) {
+            allocated++;
+            return source.clone();
+        }
+        Character* fighter = fighters.back();
+        fighters.pop_back();
+        fighter->resetFrom(source);
+        return fighter;
+    }
+
+    void CombatantPool::release(Character* fighter) {
+        if (fighter) {
+            available[static_cast<int>(fighter->getKind())].push_back(fighter);
+        }
+    }
+
+    size_t CombatantPool::getAllocatedCount() const {
+        return allocated;
+    }
+
+    CombatantPool& CombatantPool::forThisThread() {
+        static thread_local CombatantPool pool;
+        return pool;
+    }
+} // namespace FantasyArena
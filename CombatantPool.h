@@ -0,0 +1,30 @@
+#pragma once
+#ifndef COMBATANT_POOL_H
+#define COMBATANT_POOL_H
+#include <vector>
+#include "Character.h"
+using namespace std;
+namespace FantasyArena {
+    // Reusable fighter objects for battles. A battle acquires a fighter for
+    // each roster template, which resets it to the template's profile and
+    // CombatState, and releases it afterwards. Fighters are only allocated
+    // the first time a class is needed, and the roster itself is never touched.
+    class CombatantPool {
+    private:
+        vector<Character*> available[CHARACTER_KIND_COUNT + 1]; // By kind; custom classes share the last
+        size_t allocated;
+    public:
+        CombatantPool();
+        ~CombatantPool();
+        CombatantPool(const CombatantPool&) = delete;
+        CombatantPool& operator=(const CombatantPool&) = delete;
+
+        Character* acquire(const Character& source);
+        void release(Character* fighter);
+        size_t getAllocatedCount() const; // Fighters created so far
+
+        // One pool per thread, so concurrent battles never share fighters
+        static CombatantPool& forThisThread();
+    };
+} // namespace FantasyArena
+#endif // COMBATANT_POOL_H
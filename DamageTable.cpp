@@ -0,0 +1,332 @@
+#include "DamageTable.h"
+#include "StatTables.h"
+#include <fstream>
+#include <cstring>
+using namespace std;
+namespace FantasyArena {
+    static const char DAMAGE_TABLE_MAGIC[4] = { 'F', 'A', 'D', 'T' };
+
+    // FNV-1a over every number the tables are derived from, so a file built
+    // before a balance change is rejected instead of silently used
+    static uint64_t statsFingerprint() {
+        uint64_t hash = 14695981039346656037ull;
+        auto mix = [&hash](int value) {
+            for (int i = 0; i < 4; ++i) {
+                hash ^= static_cast<uint8_t>(static_cast<uint32_t>(value) >> (8 * i));
+                hash *= 1099511628211ull;
+            }
+        };
+        for (const ClassStats& stats : CLASS_STATS) {
+            mix(stats.baseHealth);
+            mix(stats.healthPerLevel);
+            mix(stats.baseAttack);
+            mix(stats.attackPerLevel);
+            mix(stats.baseDefense);
+            mix(stats.defensePerLevel);
+            mix(stats.cooldown);
+        }
+        for (const EnvironmentModifiers& modifiers : ENVIRONMENT_MODIFIERS) {
+            mix(modifiers.attackPercent);
+            mix(modifiers.defensePercent);
+            mix(modifiers.healthPercent);
+        }
+        return hash;
+    }
+
+    DamageTable::DamageTable() : maxLevel(0), fighters(nullptr), damage(nullptr) {
+    }
+
+    size_t DamageTable::fighterIndex(CharacterKind kind, int level, EnvironmentType environment) const {
+        return (static_cast<size_t>(environment) * CHARACTER_KIND_COUNT + static_cast<size_t>(kind)) * maxLevel + (level - 1);
+    }
+
+    size_t DamageTable::damageIndex(CharacterKind attacker, int attackerLevel, CharacterKind defender, int defenderLevel,
+        EnvironmentType environment) const {
+        size_t defenderColumn = static_cast<size_t>(defender) * maxLevel + (defenderLevel - 1);
+        return fighterIndex(attacker, attackerLevel, environment) * CHARACTER_KIND_COUNT * maxLevel + defenderColumn;
+    }
+
+    size_t DamageTable::getEntryCount() const {
+        size_t fighterCount = static_cast<size_t>(ENVIRONMENT_COUNT) * CHARACTER_KIND_COUNT * maxLevel;
+        return fighterCount * CHARACTER_KIND_COUNT * maxLevel;
+    }
+
+    void DamageTable::build(int newMaxLevel) {
+        file.close();
+        maxLevel = newMaxLevel < 1 ? 1 : newMaxLevel;
+        ownedFighters.resize(static_cast<size_t>(ENVIRONMENT_COUNT) * CHARACTER_KIND_COUNT * maxLevel);
+        ownedDamage.resize(getEntryCount());
+        for (int e = 0; e < ENVIRONMENT_COUNT; ++e) {
+            EnvironmentType environment = static_cast<EnvironmentType>(e);
+            const EnvironmentModifiers& modifiers = getEnvironmentModifiers(environment);
+            for (int k = 0; k < CHARACTER_KIND_COUNT; ++k) {
+                CharacterKind kind = static_cast<CharacterKind>(k);
+                for (int level = 1; level <= maxLevel; ++level) {
+                    StatBlock stats = getStatBlock(kind, level);
+                    FighterEntry& fighter = ownedFighters[fighterIndex(kind, level, environment)];
+                    fighter.health = applyPercent(stats.health, modifiers.healthPercent);
+                    fighter.maxHealth = stats.health;
+                    fighter.attack = applyPercent(stats.attack, modifiers.attackPercent);
+                    fighter.defense = applyPercent(stats.defense, modifiers.defensePercent);
+                    fighter.cooldown = stats.cooldown;
+                }
+            }
+        }
+        for (int e = 0; e < ENVIRONMENT_COUNT; ++e) {
+            EnvironmentType environment = static_cast<EnvironmentType>(e);
+            for (int a = 0; a < CHARACTER_KIND_COUNT; ++a) {
+                CharacterKind attackerKind = static_cast<CharacterKind>(a);
+                for (int attackerLevel = 1; attackerLevel <= maxLevel; ++attackerLevel) {
+                    const FighterEntry& attacker = ownedFighters[fighterIndex(attackerKind, attackerLevel, environment)];
+                    for (int d = 0; d < CHARACTER_KIND_COUNT; ++d) {
+                        CharacterKind defenderKind = static_cast<CharacterKind>(d);
+                        for (int defenderLevel = 1; defenderLevel <= maxLevel; ++defenderLevel) {
+                            const FighterEntry& defender = ownedFighters[fighterIndex(defenderKind, defenderLevel, environment)];
+                            DamageEntry& entry = ownedDamage[damageIndex(attackerKind, attackerLevel, defenderKind, defenderLevel, environment)];
+                            entry.damage = attackDamage(attackerKind, attacker.attack, defender.defense, false);
+                            entry.evasiveDamage = attackerKind == CharacterKind::ARCHER ?
+                                attackDamage(attackerKind, attacker.attack, defender.defense, true) : entry.damage;
+                            entry.hitsToKill = (defender.health + entry.damage - 1) / entry.damage;
+                        }
+                    }
+                }
+            }
+        }
+        fighters = ownedFighters.data();
+        damage = ownedDamage.data();
+    }
+
+    bool DamageTable::save(const string& path) const {
+        if (!fighters) {
+            return false;
+        }
+        ofstream out(path, ios::binary | ios::trunc);
+        if (!out.is_open()) {
+            return false;
+        }
+        DamageTableHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, DAMAGE_TABLE_MAGIC, sizeof(DAMAGE_TABLE_MAGIC));
+        header.version = DAMAGE_TABLE_FORMAT_VERSION;
+        header.maxLevel = static_cast<uint32_t>(maxLevel);
+        header.kindCount = CHARACTER_KIND_COUNT;
+        header.environmentCount = ENVIRONMENT_COUNT;
+        header.statsFingerprint = statsFingerprint();
+        size_t fighterCount = static_cast<size_t>(ENVIRONMENT_COUNT) * CHARACTER_KIND_COUNT * maxLevel;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(fighters), static_cast<streamsize>(fighterCount * sizeof(FighterEntry)));
+        out.write(reinterpret_cast<const char*>(damage), static_cast<streamsize>(getEntryCount() * sizeof(DamageEntry)));
+        return out.good();
+    }
+
+    bool DamageTable::load(const string& path) {
+        ownedFighters.clear();
+        ownedDamage.clear();
+        fighters = nullptr;
+        damage = nullptr;
+        maxLevel = 0;
+        if (!file.open(path) || file.size() < sizeof(DamageTableHeader)) {
+            file.close();
+            return false;
+        }
+        const DamageTableHeader* header = reinterpret_cast<const DamageTableHeader*>(file.getData());
+        if (memcmp(header->magic, DAMAGE_TABLE_MAGIC, sizeof(DAMAGE_TABLE_MAGIC)) != 0 ||
+            header->version != DAMAGE_TABLE_FORMAT_VERSION || header->kindCount != CHARACTER_KIND_COUNT ||
+            header->environmentCount != ENVIRONMENT_COUNT || header->maxLevel < 1 ||
+            header->statsFingerprint != statsFingerprint()) {
+            file.close();
+            return false;
+        }
+        uint64_t fighterCount = static_cast<uint64_t>(ENVIRONMENT_COUNT) * CHARACTER_KIND_COUNT * header->maxLevel;
+        uint64_t entryCount = fighterCount * CHARACTER_KIND_COUNT * header->maxLevel;
+        if (file.size() != sizeof(DamageTableHeader) + fighterCount * sizeof(FighterEntry) + entryCount * sizeof(DamageEntry)) {
+            file.close();
+            return false;
+        }
+        // Lookups are served straight from the mapping
+        maxLevel = static_cast<int>(header->maxLevel);
+        fighters = reinterpret_cast<const FighterEntry*>(file.getData() + sizeof(DamageTableHeader));
+        damage = reinterpret_cast<const DamageEntry*>(fighters + fighterCount);
+        return true;
+    }
+
+    // Per-side state of a table duel
+    struct TableFighter {
+        CharacterKind kind;
+        int32_t health;
+        int32_t maxHealth;
+        int32_t cooldown;
+        int32_t cooldownLength;
+        bool abilityReady;
+        bool abilityActive;
+        bool revived;
+        bool usesAbility;
+    };
+
+    BattleResult DamageTable::simulateDuel(CharacterKind kind1, int level1, CharacterKind kind2, int level2,
+        EnvironmentType environment, BatchPolicy policy1, BatchPolicy policy2) const {
+        TableFighter sides[2];
+        const CharacterKind kinds[2] = { kind1, kind2 };
+        const int levels[2] = { level1, level2 };
+        const BatchPolicy policies[2] = { policy1, policy2 };
+        for (int s = 0; s < 2; ++s) {
+            const FighterEntry& entry = getFighter(kinds[s], levels[s], environment);
+            sides[s] = { kinds[s], entry.health, entry.maxHealth, 0, entry.cooldown, true, false, false,
+                policies[s] == BatchPolicy::ABILITY_WHEN_READY };
+        }
+        // Both directions of the matchup are fixed for the whole duel
+        const DamageEntry* hits[2] = {
+            &getDamage(kind1, level1, kind2, level2, environment),
+            &getDamage(kind2, level2, kind1, level1, environment)
+        };
+
+        BattleResult result;
+        if (sides[0].health <= 0 || sides[1].health <= 0) {
+            result.winner = sides[0].health > 0 ? 1 : 2;
+            result.turns = 1;
+            result.winnerHealth = sides[result.winner - 1].health;
+            return result;
+        }
+        for (int turnNumber = 1; ; ++turnNumber) {
+            int attackerSide = (turnNumber % 2 == 1) ? 0 : 1;
+            TableFighter& a = sides[attackerSide];
+            TableFighter& d = sides[1 - attackerSide];
+            if (turnNumber > 1 && a.cooldown > 0) {
+                a.cooldown--;
+                if (a.cooldown == 0) {
+                    a.abilityReady = true;
+                }
+            }
+            // One-turn abilities end at the start of their owner's turn
+            a.abilityActive = false;
+
+            bool attacking = false;
+            bool evasive = false;
+            if (a.usesAbility && a.abilityReady) {
+                a.abilityActive = a.kind != CharacterKind::LEGENDARY;
+                a.cooldown = a.cooldownLength;
+                a.abilityReady = false;
+                // The Archer attacks from the evasive stance in the same turn
+                attacking = evasive = a.kind == CharacterKind::ARCHER;
+            }
+            else if (d.abilityActive && (d.kind == CharacterKind::WARRIOR || d.kind == CharacterKind::MAGE ||
+                d.kind == CharacterKind::ARCHER)) {
+                // Transparent stays up; Mirror Image and Evasive Roll are used up
+                if (d.kind != CharacterKind::WARRIOR) {
+                    d.abilityActive = false;
+                }
+            }
+            else {
+                attacking = true;
+            }
+
+            if (attacking) {
+                int32_t hit = evasive ? hits[attackerSide]->evasiveDamage : hits[attackerSide]->damage;
+                int32_t dealt = hit > d.health ? d.health : hit;
+                d.health -= dealt;
+                if (d.kind == CharacterKind::MIRROR_STRIKER && d.abilityActive) {
+                    int32_t reflected = dealt / 4;
+                    if (reflected < 1) reflected = 1;
+                    a.health = a.health > reflected ? a.health - reflected : 0;
+                }
+            }
+            if (evasive) {
+                a.abilityActive = false;
+            }
+
+            int endTurn = 0;
+            if (d.health <= 0) {
+                if (d.kind == CharacterKind::LEGENDARY && !d.revived) {
+                    d.health = d.maxHealth / 4;
+                    d.revived = true;
+                }
+                else {
+                    endTurn = turnNumber;
+                }
+            }
+            if (endTurn == 0 && (a.health <= 0 || d.health <= 0)) {
+                endTurn = turnNumber + 1;
+            }
+            if (endTurn != 0) {
+                result.winner = sides[0].health > 0 ? 1 : 2;
+                result.turns = endTurn;
+                result.winnerHealth = sides[result.winner - 1].health;
+                return result;
+            }
+        }
+    }
+
+    static bool sameFighter(const FighterEntry& entry, const Character& character) {
+        return entry.health == character.getHealth() && entry.maxHealth == character.getMaxHealth() &&
+            entry.attack == character.getAttack() && entry.defense == character.getDefense() &&
+            entry.cooldown == character.getSpecialAbilityCooldown();
+    }
+
+    // Health the defender loses to one attackTarget call; the defender's health
+    // is raised first so the hit is never clamped
+    static int32_t liveDamage(Character& attacker, Character& defender, bool evasive) {
+        CombatState attackerState = attacker.getCombatState();
+        CombatState defenderState = defender.getCombatState();
+        CombatState attacking = attackerState;
+        attacking.abilityActive = evasive;
+        attacker.setCombatState(attacking);
+        const int32_t fullHealth = 1 << 30;
+        defender.setHealth(fullHealth);
+        attacker.attackTarget(defender);
+        int32_t dealt = fullHealth - defender.getHealth();
+        attacker.setCombatState(attackerState);
+        defender.setCombatState(defenderState);
+        return dealt;
+    }
+
+    size_t verifyDamageTable(const DamageTable& table, ostream& os) {
+        const size_t MAX_REPORTED = 5;
+        int maxLevel = table.getMaxLevel();
+        size_t mismatches = 0;
+        ConsoleMode consoleMode = Character::getConsoleMode();
+        Character::setConsoleOutput(false);
+        auto report = [&](const string& message) {
+            if (++mismatches <= MAX_REPORTED) {
+                os << "Mismatch: " << message << endl;
+            }
+        };
+        for (int e = 0; e < ENVIRONMENT_COUNT; ++e) {
+            EnvironmentType environment = static_cast<EnvironmentType>(e);
+            Arena arena("Verification", environment);
+            // Live characters of every class and level in this environment
+            vector<Character*> live;
+            for (int k = 0; k < CHARACTER_KIND_COUNT; ++k) {
+                for (int level = 1; level <= maxLevel; ++level) {
+                    Character* character = createCharacter(static_cast<CharacterKind>(k), "Fighter", level);
+                    arena.applyEnvironmentModifiers(*character);
+                    if (!sameFighter(table.getFighter(character->getKind(), level, environment), *character)) {
+                        report(character->getClassName() + " level " + to_string(level) + " stats in " + arena.getEnvironmentName());
+                    }
+                    live.push_back(character);
+                }
+            }
+            for (Character* attacker : live) {
+                for (Character* defender : live) {
+                    const DamageEntry& entry = table.getDamage(attacker->getKind(), attacker->getLevel(),
+                        defender->getKind(), defender->getLevel(), environment);
+                    int32_t expected = liveDamage(*attacker, *defender, false);
+                    int32_t expectedEvasive = attacker->getKind() == CharacterKind::ARCHER ?
+                        liveDamage(*attacker, *defender, true) : expected;
+                    int32_t health = table.getFighter(defender->getKind(), defender->getLevel(), environment).health;
+                    if (entry.damage != expected || entry.evasiveDamage != expectedEvasive ||
+                        entry.hitsToKill != (health + expected - 1) / expected) {
+                        report(attacker->getClassName() + " level " + to_string(attacker->getLevel()) + " against " +
+                            defender->getClassName() + " level " + to_string(defender->getLevel()) + " in " +
+                            arena.getEnvironmentName() + ": table " + to_string(entry.damage) + "/" +
+                            to_string(entry.evasiveDamage) + ", live " + to_string(expected) + "/" + to_string(expectedEvasive));
+                    }
+                }
+            }
+            for (Character* character : live) {
+                delete character;
+            }
+        }
+        Character::setConsoleMode(consoleMode);
+        return mismatches;
+    }
+} // namespace FantasyArena
@@ -0,0 +1,95 @@
+#pragma once
+#ifndef DAMAGE_TABLE_H
+#define DAMAGE_TABLE_H
+#include <string>
+#include <vector>
+#include <iostream>
+#include <cstdint>
+#include "Character.h"
+#include "Arena.h"
+#include "BatchCombat.h"
+#include "MappedFile.h"
+using namespace std;
+namespace FantasyArena {
+    // A fresh character of one class and level after an environment's modifiers
+    struct FighterEntry {
+        int32_t health;
+        int32_t maxHealth;
+        int32_t attack;
+        int32_t defense;
+        int32_t cooldown;  // Cooldown after using the ability
+    };
+    static_assert(sizeof(FighterEntry) == 20, "FighterEntry layout changed");
+
+    // One attacker hitting one defender in one environment
+    struct DamageEntry {
+        int32_t damage;        // Plain attack
+        int32_t evasiveDamage; // Attack from Evasive Roll (Archer only, otherwise equal to damage)
+        int32_t hitsToKill;    // Plain attacks needed from the defender's full health, ignoring abilities
+    };
+    static_assert(sizeof(DamageEntry) == 12, "DamageEntry layout changed");
+
+    // File layout: header, fighter table, damage table
+    struct DamageTableHeader {
+        char magic[4];          // "FADT"
+        uint32_t version;
+        uint32_t maxLevel;
+        uint32_t kindCount;
+        uint32_t environmentCount;
+        uint32_t reserved;
+        uint64_t statsFingerprint; // Hash of the class and environment tables the file was built from
+    };
+    static_assert(sizeof(DamageTableHeader) == 32, "DamageTableHeader layout changed");
+
+    const uint32_t DAMAGE_TABLE_FORMAT_VERSION = 1;
+
+    // Fighter stats and damage for every (attacker class, attacker level,
+    // defender class, defender level, environment) with levels 1..maxLevel.
+    // Built from StatTables.h and the damage formulas of the attackTarget
+    // overrides, or mapped read-only from a file written by save().
+    class DamageTable {
+    private:
+        int maxLevel;
+        vector<FighterEntry> ownedFighters;
+        vector<DamageEntry> ownedDamage;
+        MappedFile file;
+        const FighterEntry* fighters; // Owned vectors or the mapped file
+        const DamageEntry* damage;
+
+        size_t fighterIndex(CharacterKind kind, int level, EnvironmentType environment) const;
+        size_t damageIndex(CharacterKind attacker, int attackerLevel, CharacterKind defender, int defenderLevel,
+            EnvironmentType environment) const;
+    public:
+        DamageTable();
+        DamageTable(const DamageTable&) = delete;
+        DamageTable& operator=(const DamageTable&) = delete;
+
+        void build(int maxLevel);
+        bool save(const string& path) const;
+        // Fails, leaving the table empty, if the file is damaged or was built
+        // from different class or environment stats
+        bool load(const string& path);
+        int getMaxLevel() const { return maxLevel; }
+        bool covers(int level) const { return level >= 1 && level <= maxLevel; }
+        size_t getEntryCount() const;
+
+        const FighterEntry& getFighter(CharacterKind kind, int level, EnvironmentType environment) const {
+            return fighters[fighterIndex(kind, level, environment)];
+        }
+        const DamageEntry& getDamage(CharacterKind attacker, int attackerLevel, CharacterKind defender,
+            int defenderLevel, EnvironmentType environment) const {
+            return damage[damageIndex(attacker, attackerLevel, defender, defenderLevel, environment)];
+        }
+
+        // One duel between fresh characters using only table lookups; same
+        // rules and results as BatchCombat and Arena::simulateBattle
+        BattleResult simulateDuel(CharacterKind kind1, int level1, CharacterKind kind2, int level2,
+            EnvironmentType environment, BatchPolicy policy1, BatchPolicy policy2) const;
+    };
+
+    // Cross-check every entry against characters built by createCharacter and
+    // the live attackTarget implementations. Prints the first few mismatches
+    // and returns how many entries differ.
+    size_t verifyDamageTable(const DamageTable& table, ostream& os);
+} // namespace FantasyArena
+#endif // DAMAGE_TABLE_H
@@ -0,0 +1,50 @@
+#include "FrameRenderer.h"
+#include "BattleInstrumentation.h"
+using namespace std;
+namespace FantasyArena {
+    FrameBuffer::FrameBuffer() : text(4096, '\0') {
+        clear();
+    }
+
+    FrameBuffer::int_type FrameBuffer::overflow(int_type c) {
+        if (traits_type::eq_int_type(c, traits_type::eof())) {
+            return traits_type::not_eof(c);
+        }
+        // Double the storage and carry on where the frame left off
+        size_t used = size();
+        text.resize(text.size() * 2);
+        setp(&text[0], &text[0] + text.size());
+        pbump(static_cast<int>(used));
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+        return c;
+    }
+
+    namespace {
+        struct Frame {
+            FrameBuffer buffer;
+            ostream stream;
+            Frame() : stream(&buffer) {
+            }
+        };
+
+        Frame& frameForThisThread() {
+            thread_local Frame frame;
+            return frame;
+        }
+    }
+
+    ostream& FrameRenderer::out() {
+        return frameForThisThread().stream;
+    }
+
+    void FrameRenderer::endFrame() {
+        FrameBuffer& buffer = frameForThisThread().buffer;
+        if (buffer.size() == 0) {
+            return;
+        }
+        PhaseTimer timer(BattlePhase::LOGGING);
+        cout.write(buffer.data(), static_cast<streamsize>(buffer.size()));
+        buffer.clear();
+    }
+} // namespace FantasyArena
@@ -0,0 +1,41 @@
+#pragma once
+#ifndef FRAME_RENDERER_H
+#define FRAME_RENDERER_H
+#include <string>
+#include <iostream>
+#include <streambuf>
+using namespace std;
+namespace FantasyArena {
+    // How much of a battle reaches the console
+    enum class ConsoleMode {
+        QUIET,    // Nothing
+        SUMMARY,  // Start and result of each battle
+        FULL      // Every turn
+    };
+
+    // Stream buffer that appends to memory and keeps its capacity between
+    // frames, so composing a frame stops allocating after the first few turns
+    class FrameBuffer : public streambuf {
+    private:
+        string text;
+    protected:
+        int_type overflow(int_type c) override;
+    public:
+        FrameBuffer();
+        const char* data() const { return pbase(); }
+        size_t size() const { return static_cast<size_t>(pptr() - pbase()); }
+        void clear() { setp(&text[0], &text[0] + text.size()); }
+    };
+
+    // Battle console output of the calling thread. A frame (the start of a
+    // battle, one turn, the result) is composed in memory and written to the
+    // console in one piece when it ends, instead of flushing every line.
+    // Input prompts go straight to cout after the pending frame is ended;
+    // cin is tied to cout, so it is flushed before every read.
+    class FrameRenderer {
+    public:
+        static ostream& out(); // The frame being composed
+        static void endFrame(); // Write the pending frame, if any
+    };
+} // namespace FantasyArena
+#endif // FRAME_RENDERER_H
@@ -4,14 +4,32 @@
 #include <limits>
 #include <cstdlib>
 #include <fstream>
+#include <chrono>
+#include <ctime>
+#include <algorithm>
+#include <cctype>
+#include "BatchCombat.h"
+#include "Tournament.h"
+#include "WinRateMatrix.h"
+#include "StatTables.h"
+#include "SearchPolicy.h"
+#include <iomanip>
 using namespace std;
 namespace FantasyArena {
-    GameManager::GameManager() : gameRunning(false) {
+    static const string SAVE_STORE_FILE = "fantasy_arena_saves.dat";
+    static const size_t SAVE_SLOTS_SHOWN = 20;
+    static const size_t CHARACTERS_PER_PAGE = 20;
+    static const size_t LEADERBOARD_ROWS = 20;
+    static const size_t LEADERBOARD_TOURNAMENT_ROWS = 10;
+    static const size_t LEADERBOARD_NEAR_ROWS = 5; // On each side of a rating
+    GameManager::GameManager() : gameRunning(false), instrumentBattles(false) {
         // Initialize save data
         saveData.player1Index = -1;
         saveData.player2Index = -1;
         saveData.arenaIndex = -1;
         saveData.battleCount = 0;
+        saveData.seed = 0;
+        saveData.inBattle = false;
     }
     GameManager::~GameManager() {
         // Clean up dynamically allocated characters
@@ -19,24 +37,162 @@ namespace FantasyArena {
             delete character;
         }
         characters.clear();
+        for (auto& entry : imageCharacters) {
+            delete entry.second;
+        }
     }
     void GameManager::addCharacter(Character* character) {
         characters.push_back(character);
     }
     void GameManager::displayCharacters() const {
         cout << "\n=== Available Characters ===" << endl;
-        for (size_t i = 0; i < characters.size(); ++i) {
-            cout << i + 1 << ". " << characters[i]->getName()
-                << " (Level " << characters[i]->getLevel() << " "
-                << characters[i]->getClassName() << ")" << endl;
+        size_t shown = min(getRosterSize(), CHARACTERS_PER_PAGE);
+        for (size_t i = 0; i < shown; ++i) {
+            cout << i + 1 << ". ";
+            printRosterEntry(i);
+        }
+        if (shown < getRosterSize()) {
+            cout << "... and " << getRosterSize() - shown << " more" << endl;
         }
         std::cout << "===========================" << std::endl;
     }
-    Character* GameManager::selectCharacter(int index) const {
+    int GameManager::chooseCharacter(int excluded) const {
+        if (getRosterSize() <= CHARACTERS_PER_PAGE) {
+            displayCharacters();
+            cout << "Enter your choice (1-" << getRosterSize() << "): ";
+            int choice;
+            do {
+                choice = getValidInput(1, getRosterSize()) - 1;
+                if (choice == excluded) {
+                    cout << "Please select a different character than Player 1." << endl;
+                }
+            } while (choice == excluded);
+            return choice;
+        }
+        cout << getRosterSize() << " characters in the roster." << endl;
+        vector<uint32_t> results;
+        size_t page = 0;
+        bool searching = true;
+        string input;
+        while (true) {
+            if (searching) {
+                cout << "Search by name prefix, class:C and level:N-M (Enter for everyone): ";
+                if (!getline(cin, input)) {
+                    return -1;
+                }
+                RosterQuery query;
+                string error;
+                if (!parseRosterQuery(input, query, error)) {
+                    cout << "Error: " << error << endl;
+                    continue;
+                }
+                rosterIndex.search(query, results);
+                if (excluded >= 0) {
+                    results.erase(remove(results.begin(), results.end(), static_cast<uint32_t>(excluded)), results.end());
+                }
+                if (results.empty()) {
+                    cout << "No characters match." << endl;
+                    continue;
+                }
+                page = 0;
+                searching = false;
+            }
+            size_t first = page * CHARACTERS_PER_PAGE;
+            size_t last = min(first + CHARACTERS_PER_PAGE, results.size());
+            cout << "\n=== Characters " << first + 1 << "-" << last << " of " << results.size() << " ===" << endl;
+            for (size_t i = first; i < last; ++i) {
+                cout << i - first + 1 << ". ";
+                printRosterEntry(results[i]);
+            }
+            cout << "Enter 1-" << last - first << " to choose";
+            if (last < results.size()) {
+                cout << ", n for the next page";
+            }
+            if (page > 0) {
+                cout << ", p for the previous page";
+            }
+            cout << ", s to search again: ";
+            if (!getline(cin, input)) {
+                return -1;
+            }
+            if (input == "n" && last < results.size()) {
+                ++page;
+            }
+            else if (input == "p" && page > 0) {
+                --page;
+            }
+            else if (input == "s") {
+                searching = true;
+            }
+            else if (!input.empty() && input.size() <= 2 && all_of(input.begin(), input.end(), ::isdigit) &&
+                stoi(input) >= 1 && static_cast<size_t>(stoi(input)) <= last - first) {
+                return static_cast<int>(results[first + stoi(input) - 1]);
+            }
+            else {
+                cout << "Invalid input." << endl;
+            }
+        }
+    }
+    const Character* GameManager::selectCharacter(int index) {
         if (index >= 0 && static_cast<size_t>(index) < characters.size()) {
             return characters[index];
         }
-        return nullptr;
+        if (index < 0 || static_cast<size_t>(index) >= getRosterSize()) {
+            return nullptr;
+        }
+        // Only the characters actually played are built from the image
+        Character*& character = imageCharacters[static_cast<uint32_t>(index)];
+        if (!character) {
+            character = rosterImage.createCharacter(index);
+        }
+        return character;
+    }
+    size_t GameManager::getRosterSize() const {
+        return rosterImage.isOpen() ? rosterImage.getCharacterCount() : characters.size();
+    }
+    bool GameManager::loadFullRoster() {
+        if (!rosterImage.isOpen() || characters.size() == rosterImage.getCharacterCount()) {
+            return true;
+        }
+        characters.reserve(rosterImage.getCharacterCount());
+        for (size_t i = characters.size(); i < rosterImage.getCharacterCount(); ++i) {
+            auto built = imageCharacters.find(static_cast<uint32_t>(i));
+            Character* character = nullptr;
+            if (built != imageCharacters.end()) {
+                character = built->second;
+                imageCharacters.erase(built);
+            }
+            else {
+                character = rosterImage.createCharacter(i);
+            }
+            if (!character) {
+                cout << "Error: Roster image " << rosterImageFile << " has a damaged character record (" << i + 1 << ")." << endl;
+                return false;
+            }
+            characters.push_back(character);
+        }
+        return true;
+    }
+    bool GameManager::requireBuiltInClasses(const string& mode) const {
+        for (const Character* character : characters) {
+            if (character->getKind() == CharacterKind::CUSTOM) {
+                cout << "Error: " << mode << " supports the built-in classes only (" << character->getName()
+                    << " is a " << character->getClassName() << ")." << endl;
+                return false;
+            }
+        }
+        return true;
+    }
+    void GameManager::printRosterEntry(size_t position) const {
+        if (position < characters.size()) {
+            const Character* character = characters[position];
+            cout << character->getName() << " (Level " << character->getLevel() << " " << character->getClassName()
+                << ")" << endl;
+            return;
+        }
+        const RosterImageCharacter& record = rosterImage.getCharacter(position);
+        cout << rosterImage.getCharacterName(position) << " (Level " << static_cast<int>(record.level) << " "
+            << getClassNameForKind(static_cast<CharacterKind>(record.kind % CHARACTER_KIND_COUNT)) << ")" << endl;
     }
     void GameManager::addArena(const Arena& arena) {
         arenas.push_back(arena);
@@ -55,14 +211,66 @@ namespace FantasyArena {
         }
         return nullptr;
     }
-    void GameManager::initializeGame() {
-        // Create default characters
-        addCharacter(new Warrior("Aragorn", 5));
-        addCharacter(new Warrior("Gimli", 4));
-        addCharacter(new Mage("Gandalf", 6));
-        addCharacter(new Mage("Saruman", 5));
-        addCharacter(new Archer("Legolas", 5));
-        addCharacter(new Archer("Hawkeye", 4));
+    bool GameManager::initializeGame() {
+        auto start = chrono::steady_clock::now();
+        if (!rosterImageFile.empty()) {
+            // Nothing is parsed or built per character: templates come later, on request
+            if (!rosterImage.open(rosterImageFile)) {
+                cout << "Error: Could not read roster image " << rosterImageFile << endl;
+                return false;
+            }
+            rosterIndex.attach(rosterImage.getIndex());
+            for (size_t i = 0; i < rosterImage.getArenaCount(); ++i) {
+                string name;
+                EnvironmentType environment;
+                if (!rosterImage.getArena(i, name, environment)) {
+                    cout << "Error: Roster image " << rosterImageFile << " has a damaged arena." << endl;
+                    return false;
+                }
+                addArena(Arena(name, environment));
+            }
+            cout << "Mapped " << rosterImage.getCharacterCount() << " characters and " << arenas.size()
+                << " arenas from " << rosterImageFile << " in " << fixed << setprecision(1)
+                << 1000.0 * chrono::duration<double>(chrono::steady_clock::now() - start).count() << " ms" << endl;
+            cout.unsetf(ios::fixed);
+            cout << setprecision(6);
+            gameRunning = true;
+            return true;
+        }
+        if (!rosterFile.empty()) {
+            RosterImportResult imported;
+            if (!importRoster(rosterFile, characters, imported)) {
+                cout << "Error: Could not read roster file " << rosterFile << endl;
+                return false;
+            }
+            for (const string& error : imported.errors) {
+                cout << "Warning: " << rosterFile << " " << error << endl;
+            }
+            if (imported.skipped > imported.errors.size()) {
+                cout << "Warning: " << imported.skipped - imported.errors.size() << " more lines skipped" << endl;
+            }
+            if (characters.size() < 2) {
+                cout << "Error: The roster needs at least two characters." << endl;
+                return false;
+            }
+        }
+        else {
+            // Create default characters
+            addCharacter(new Warrior("Aragorn", 5));
+            addCharacter(new Warrior("Gimli", 4));
+            addCharacter(new Mage("Gandalf", 6));
+            addCharacter(new Mage("Saruman", 5));
+            addCharacter(new Archer("Legolas", 5));
+            addCharacter(new Archer("Hawkeye", 4));
+        }
+        rosterIndex.build(characters);
+        if (!rosterFile.empty()) {
+            cout << "Imported and indexed " << characters.size() << " characters from " << rosterFile << " in "
+                << fixed << setprecision(1) << 1000.0 * chrono::duration<double>(chrono::steady_clock::now() - start).count()
+                << " ms" << endl;
+            cout.unsetf(ios::fixed);
+            cout << setprecision(6);
+        }
         // Create arenas
         addArena(Arena("Mordor", EnvironmentType::FIRE));
         addArena(Arena("Frozen Wastes", EnvironmentType::ICE));
@@ -70,36 +278,22 @@ namespace FantasyArena {
         addArena(Arena("Harad Desert", EnvironmentType::DESERT));
         addArena(Arena("Misty Mountains", EnvironmentType::MOUNTAIN));
         gameRunning = true;
+        return true;
     }
     void GameManager::runGame() {
-        initializeGame();
+        if (!initializeGame()) {
+            return;
+        }
         while (gameRunning) {
             clearScreen();
             displayMainMenu();
-            int choice = getValidInput(1, 4);
+            int choice = getValidInput(1, 6);
             switch (choice) {
             case 1:
                 battleMode();
                 break;
             case 2:
-                // Display game information
-                clearScreen();
-                cout << "\n=== Fantasy Arena Game Information ===" << endl;
-                cout << "Fantasy Arena is a turn-based battle game where you can choose characters" << endl;
-                cout << "from different classes and battle in various environments." << endl;
-                cout << endl;
-                cout << "Each character has unique abilities:" << endl;
-                cout << "- Warriors: Tough fighters with Transparency ability to boost defense" << endl;
-                cout << "- Mages: Powerful spellcasters with Mirror Image ability to boost defense" << endl;
-                cout << "- Archers: Agile fighters with Precise Aim for guaranteed critical hits" << endl;
-                cout << endl;
-                cout << "Different arenas provide different environmental effects:" << endl;
-                cout << "- Fire: Boosts attack, reduces defense" << endl;
-                cout << "- Ice: Reduces attack, boosts defense" << endl;
-                cout << "- Jungle: Balanced boost to attack and defense" << endl;
-                cout << "- Desert: Major attack boost, slight health reduction" << endl;
-                cout << "- Mountain: Major defense boost, attack reduction" << endl;
-                cout << "======================================" << endl;
+                displayGameInformation();
                 pauseScreen();
                 break;
             case 3:
@@ -112,7 +306,23 @@ namespace FantasyArena {
                     pauseScreen();
                 }
                 break;
-            case 4:
+            case 4: {
+                clearScreen();
+                cout << "\n=== TOURNAMENT ===" << endl;
+                cout << "Every character fights every other character in every arena." << endl;
+                cout << "Battles per matchup (1-10000): ";
+                SimulationOptions options = defaultSimulationOptions();
+                options.tournament = getValidInput(1, 10000);
+                options.policy1 = "random";
+                options.policy2 = "random";
+                tournamentMode(options);
+                pauseScreen();
+                break;
+            }
+            case 5:
+                leaderboardMode();
+                break;
+            case 6:
                 gameRunning = false;
                 cout << "Thank you for playing Fantasy Arena!" << endl;
                 break;
@@ -124,29 +334,34 @@ namespace FantasyArena {
         cout << "1. Battle Mode" << endl;
         cout << "2. Game Information" << endl;
         cout << "3. Load Saved Game" << endl;
-        cout << "4. Exit Game" << endl;
+        cout << "4. Tournament" << endl;
+        cout << "5. Leaderboard" << endl;
+        cout << "6. Exit Game" << endl;
         cout << "===================" << endl;
-        cout << "Enter your choice (1-4): ";
+        cout << "Enter your choice (1-6): ";
     }
     void GameManager::battleMode() {
         clearScreen();
         cout << "\n=== BATTLE MODE ===" << endl;
         cout << "\nPlayer 1, select your character:" << endl;
-        displayCharacters();
-        cout << "Enter your choice (1-" << characters.size() << "): ";
-        int player1Choice = getValidInput(1, characters.size()) - 1;
-        Character* player1Character = selectCharacter(player1Choice);
+        int player1Choice = chooseCharacter(-1);
+        if (player1Choice < 0) {
+            return;
+        }
+        const Character* player1Character = selectCharacter(player1Choice);
         cout << "\nPlayer 2, select your character:" << endl;
-        displayCharacters();
-        cout << "Enter your choice (1-" << characters.size() << "): ";
-        int player2Choice;
-        do {
-            player2Choice = getValidInput(1, characters.size()) - 1;
-            if (player2Choice == player1Choice) {
-                cout << "Please select a different character than Player 1." << endl;
-            }
-        } while (player2Choice == player1Choice);
-        Character* player2Character = selectCharacter(player2Choice);
+        int player2Choice = chooseCharacter(player1Choice);
+        if (player2Choice < 0) {
+            return;
+        }
+        const Character* player2Character = selectCharacter(player2Choice);
+        if (!player1Character || !player2Character) {
+            cout << "Error: The roster image has a damaged character record." << endl;
+            pauseScreen();
+            return;
+        }
+        ActionPolicy* player1Policy = selectController(1);
+        ActionPolicy* player2Policy = selectController(2);
         cout << "\nSelect battle arena:" << endl;
         displayArenas();
         cout << "Enter your choice (1-" << arenas.size() << "): ";
@@ -156,11 +371,18 @@ namespace FantasyArena {
         saveData.player2Index = player2Choice;
         saveData.arenaIndex = arenaChoice;
         saveData.battleCount++;
+        saveData.seed = BattleRandom::seedFromClock();
+        saveData.inBattle = false;
         cout << "\nDo you want to save this battle setup? (1: Yes, 2: No): ";
         int saveChoice = getValidInput(1, 2);
         if (saveChoice == 1) {
-            saveGame();
-            cout << "Game saved successfully!" << endl;
+            string slotName = selectSlotName();
+            if (!slotName.empty() && saveGame(slotName)) {
+                cout << "Game saved to slot " << slotName << "!" << endl;
+            }
+            else if (slotName.empty()) {
+                cout << "Error: Save file " << SAVE_STORE_FILE << " is damaged; not overwriting it." << endl;
+            }
             pauseScreen();
         }
         clearScreen();
@@ -172,9 +394,594 @@ namespace FantasyArena {
         cout << "Press Enter to start the battle...";
         cin.ignore(numeric_limits<streamsize>::max(), '\n');
         clearScreen();
-        selectedArena->startBattle(player1Character, player2Character);
+        selectedArena->setBattleSeed(saveData.seed);
+        selectedArena->setTablebase(tablebase.isOpen() ? &tablebase : nullptr);
+        BattleInstrumentation instrumentation;
+        BattleInstrumentation::attach(instrumentBattles ? &instrumentation : nullptr);
+        BattleResult result = selectedArena->startBattle(*player1Character, *player2Character, *player1Policy, *player2Policy);
+        BattleInstrumentation::attach(nullptr);
+        recordRating(player1Choice, player2Choice, result);
+        if (instrumentBattles) {
+            reportInstrumentation(instrumentation, "BATTLE INSTRUMENTATION");
+        }
+        delete player1Policy;
+        delete player2Policy;
+        saveSuspendedBattle(*selectedArena);
         pauseScreen();
     }
+    ActionPolicy* GameManager::selectController(int player) const {
+        cout << "\nWho controls Player " << player << "? (1: Human, 2: Computer): ";
+        if (getValidInput(1, 2) == 1) {
+            return new ConsolePolicy();
+        }
+        cout << "Computer thinking time per move in milliseconds (1-1000): ";
+        SearchPolicy* computer = new SearchPolicy(getValidInput(1, 1000));
+        if (tablebase.isOpen()) {
+            computer->setTablebase(&tablebase);
+        }
+        return computer;
+    }
+    bool GameManager::simulationMode(const SimulationOptions& options) {
+        if (options.batch || options.damageTables) {
+            return batchMode(options);
+        }
+        setRosterFiles(options.rosterFile, options.rosterImageFile);
+        if (!initializeGame()) {
+            return false;
+        }
+        const Character* player1Character = selectCharacter(options.player1Index - 1);
+        const Character* player2Character = selectCharacter(options.player2Index - 1);
+        Arena* selectedArena = selectArena(options.arenaIndex - 1);
+        if (!player1Character || !player2Character || !selectedArena) {
+            cout << "Error: Invalid character or arena index for simulation." << endl;
+            displayCharacters();
+            displayArenas();
+            return false;
+        }
+        ActionPolicy* policy1 = createPolicy(options.policy1);
+        ActionPolicy* policy2 = createPolicy(options.policy2);
+        if (!policy1 || !policy2) {
+            cout << "Error: Unknown policy. Use attack, ability, random or search." << endl;
+            delete policy1;
+            delete policy2;
+            return false;
+        }
+        if (!options.tablebaseFile.empty()) {
+            if (!loadTablebase(options.tablebaseFile)) {
+                delete policy1;
+                delete policy2;
+                return false;
+            }
+            for (ActionPolicy* policy : { policy1, policy2 }) {
+                if (SearchPolicy* search = dynamic_cast<SearchPolicy*>(policy)) {
+                    search->setTablebase(&tablebase);
+                }
+            }
+            selectedArena->setTablebase(&tablebase);
+        }
+        cout << "Simulating " << options.battles << " battles: " << player1Character->getName()
+            << " (" << policy1->getPolicyName() << ") vs " << player2Character->getName()
+            << " (" << policy2->getPolicyName() << ") in " << selectedArena->getName() << endl;
+        BattleTraceWriter trace;
+        if (!options.traceFile.empty()) {
+            if (!trace.open(options.traceFile)) {
+                cout << "Error: Could not create trace file " << options.traceFile << endl;
+                delete policy1;
+                delete policy2;
+                return false;
+            }
+            selectedArena->setTraceWriter(&trace);
+        }
+        uint64_t seed = options.hasSeed ? options.seed : BattleRandom::seedFromClock();
+        cout << "Seed: " << seed << endl;
+        selectedArena->setBattleSeed(seed);
+        if (options.instrument) {
+            enableInstrumentation(options.instrumentFile);
+        }
+        Character::setConsoleMode(options.consoleMode);
+        BattleInstrumentation instrumentation;
+        BattleInstrumentation::attach(instrumentBattles ? &instrumentation : nullptr);
+        SimulationSummary summary = runSimulation(*selectedArena, *player1Character, *player2Character,
+            *policy1, *policy2, options.battles);
+        BattleInstrumentation::attach(nullptr);
+        Character::setConsoleOutput(true);
+        if (trace.isOpen()) {
+            selectedArena->setTraceWriter(nullptr);
+            cout << "Recorded " << trace.getBattleCount() << " battles to " << options.traceFile << endl;
+            trace.close();
+        }
+        selectedArena->setTablebase(nullptr);
+        printSimulationSummary(summary, *player1Character, *player2Character);
+        if (instrumentBattles) {
+            reportInstrumentation(instrumentation, "SIMULATION INSTRUMENTATION");
+        }
+        delete policy1;
+        delete policy2;
+        return true;
+    }
+    bool GameManager::teamBattleMode(const SimulationOptions& options) {
+        setRosterFiles(options.rosterFile, options.rosterImageFile);
+        if (!initializeGame()) {
+            return false;
+        }
+        Arena* selectedArena = selectArena(options.arenaIndex - 1);
+        if (!selectedArena || getRosterSize() == 0) {
+            cout << "Error: Invalid arena index for team battles." << endl;
+            displayArenas();
+            return false;
+        }
+        if (!options.traceFile.empty()) {
+            cout << "Error: Traces record two-fighter battles only." << endl;
+            return false;
+        }
+        ActionPolicy* policy1 = createPolicy(options.policy1);
+        ActionPolicy* policy2 = createPolicy(options.policy2);
+        if (!policy1 || !policy2) {
+            cout << "Error: Unknown policy. Use attack, ability, random or search." << endl;
+            delete policy1;
+            delete policy2;
+            return false;
+        }
+        // Team t is fighters t * size to (t + 1) * size - 1, cycling through the roster;
+        // the first team plays policy1 and every other team policy2
+        size_t fighterCount = static_cast<size_t>(options.teamCount) * options.teamSize;
+        vector<const Character*> fighters(fighterCount);
+        vector<int> teams(fighterCount);
+        vector<ActionPolicy*> policies(fighterCount);
+        for (size_t i = 0; i < fighterCount; ++i) {
+            fighters[i] = selectCharacter(static_cast<int>(i % getRosterSize()));
+            teams[i] = static_cast<int>(i / options.teamSize);
+            policies[i] = teams[i] == 0 ? policy1 : policy2;
+            if (!fighters[i]) {
+                cout << "Error: The roster image has a damaged character record." << endl;
+                delete policy1;
+                delete policy2;
+                return false;
+            }
+        }
+        cout << "Simulating " << options.teamBattles << " battles: ";
+        if (options.teamSize == 1) {
+            cout << "free-for-all of " << fighterCount << " fighters";
+        }
+        else {
+            cout << options.teamCount << " teams of " << options.teamSize << " fighters";
+        }
+        cout << " (" << policy1->getPolicyName() << " vs " << policy2->getPolicyName() << ") in "
+            << selectedArena->getName() << ", attacking the " << getTargetRuleName(options.targetRule) << " enemy" << endl;
+        uint64_t seed = options.hasSeed ? options.seed : BattleRandom::seedFromClock();
+        cout << "Seed: " << seed << endl;
+        selectedArena->setBattleSeed(seed);
+        if (options.instrument) {
+            enableInstrumentation(options.instrumentFile);
+        }
+        Character::setConsoleMode(options.consoleMode);
+        BattleInstrumentation instrumentation;
+        BattleInstrumentation::attach(instrumentBattles ? &instrumentation : nullptr);
+        TeamSimulationSummary summary = runTeamSimulation(*selectedArena, fighters, teams, policies,
+            options.targetRule, options.teamBattles);
+        BattleInstrumentation::attach(nullptr);
+        Character::setConsoleOutput(true);
+        printTeamSimulationSummary(summary, fighters, teams);
+        if (instrumentBattles) {
+            reportInstrumentation(instrumentation, "TEAM BATTLE INSTRUMENTATION");
+        }
+        delete policy1;
+        delete policy2;
+        return true;
+    }
+    bool GameManager::batchMode(const SimulationOptions& options) {
+        setRosterFiles(options.rosterFile, options.rosterImageFile);
+        if (!initializeGame()) {
+            return false;
+        }
+        if (!loadFullRoster() || !requireBuiltInClasses("The batch engine")) {
+            return false;
+        }
+        BatchPolicy batchPolicy1;
+        BatchPolicy batchPolicy2;
+        if (!toBatchPolicy(options.policy1, batchPolicy1) || !toBatchPolicy(options.policy2, batchPolicy2)) {
+            cout << "Error: The batch engine supports the attack and ability policies only." << endl;
+            return false;
+        }
+        // Duel i uses the i-th (player1, player2, arena) combination, cycling
+        struct Matchup {
+            int player1;
+            int player2;
+            int arena;
+        };
+        vector<Matchup> matchups;
+        for (size_t p1 = 0; p1 < characters.size(); ++p1) {
+            for (size_t p2 = 0; p2 < characters.size(); ++p2) {
+                for (size_t a = 0; a < arenas.size(); ++a) {
+                    if (p1 != p2) {
+                        matchups.push_back({ static_cast<int>(p1), static_cast<int>(p2), static_cast<int>(a) });
+                    }
+                }
+            }
+        }
+        vector<BattleResult> results;
+        double seconds = 0.0;
+        DamageTable table;
+        if (options.damageTables) {
+            // The roster templates are fresh characters, so class and level select their table rows
+            int maxLevel = 1;
+            for (const Character* character : characters) {
+                maxLevel = max(maxLevel, character->getLevel());
+            }
+            if (!loadDamageTable(table, options.damageTableFile, maxLevel)) {
+                return false;
+            }
+            cout << "Running " << options.battles << " table duels over " << matchups.size() << " matchups..." << endl;
+            results.reserve(options.battles);
+            auto start = chrono::steady_clock::now();
+            for (int i = 0; i < options.battles; ++i) {
+                const Matchup& m = matchups[i % matchups.size()];
+                const Character& player1 = *characters[m.player1];
+                const Character& player2 = *characters[m.player2];
+                results.push_back(table.simulateDuel(player1.getKind(), player1.getLevel(), player2.getKind(),
+                    player2.getLevel(), arenas[m.arena].getEnvironmentType(), batchPolicy1, batchPolicy2));
+            }
+            seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        }
+        else {
+            BatchCombat batch;
+            for (int i = 0; i < options.battles; ++i) {
+                const Matchup& m = matchups[i % matchups.size()];
+                batch.addDuel(arenas[m.arena], *characters[m.player1], *characters[m.player2], batchPolicy1, batchPolicy2);
+            }
+            cout << "Running " << batch.size() << " batch duels over " << matchups.size() << " matchups..." << endl;
+            auto start = chrono::steady_clock::now();
+            batch.run();
+            seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            results = batch.getResults();
+        }
+        long long totalTurns = 0;
+        int player1Wins = 0;
+        for (const BattleResult& result : results) {
+            totalTurns += result.turns;
+            player1Wins += (result.winner == 1) ? 1 : 0;
+        }
+        cout << "Player 1 side wins: " << player1Wins << "/" << results.size() << endl;
+        cout << "Average turns: " << static_cast<double>(totalTurns) / results.size() << endl;
+        cout << "Elapsed: " << seconds << " s (" << static_cast<long long>(results.size() / seconds) << " battles/s)" << endl;
+
+        if (options.verify) {
+            size_t tableMismatches = 0;
+            if (options.damageTables) {
+                tableMismatches = verifyDamageTable(table, cout);
+                cout << "Damage table check: " << tableMismatches << " mismatching entries out of "
+                    << table.getEntryCount() << endl;
+            }
+            // Replay every duel through Arena::simulateBattle and compare
+            ActionPolicy* policy1 = createPolicy(options.policy1);
+            ActionPolicy* policy2 = createPolicy(options.policy2);
+            Character::setConsoleOutput(false);
+            int mismatches = 0;
+            for (size_t i = 0; i < results.size(); ++i) {
+                const Matchup& m = matchups[i % matchups.size()];
+                BattleResult expected = arenas[m.arena].simulateBattle(*characters[m.player1], *characters[m.player2], *policy1, *policy2);
+                if (expected.winner != results[i].winner || expected.turns != results[i].turns ||
+                    expected.winnerHealth != results[i].winnerHealth) {
+                    mismatches++;
+                }
+            }
+            Character::setConsoleOutput(true);
+            delete policy1;
+            delete policy2;
+            cout << "Verification: " << mismatches << " mismatching duels out of " << results.size() << endl;
+            return mismatches == 0 && tableMismatches == 0;
+        }
+        return true;
+    }
+    bool GameManager::loadDamageTable(DamageTable& table, const string& path, int maxLevel) {
+        if (!path.empty() && table.load(path) && table.covers(maxLevel)) {
+            cout << "Loaded damage tables for levels 1-" << table.getMaxLevel() << " from " << path << endl;
+            return true;
+        }
+        auto start = chrono::steady_clock::now();
+        table.build(maxLevel);
+        double milliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        cout << "Built damage tables for levels 1-" << maxLevel << " (" << table.getEntryCount() << " entries) in "
+            << milliseconds << " ms" << endl;
+        if (!path.empty()) {
+            if (!table.save(path)) {
+                cout << "Error: Could not write damage table file " << path << endl;
+                return false;
+            }
+            cout << "Saved damage tables to " << path << endl;
+        }
+        return true;
+    }
+    bool GameManager::solveMode(const SimulationOptions& options) {
+        setRosterFiles(options.rosterFile, options.rosterImageFile);
+        if (!initializeGame()) {
+            return false;
+        }
+        if (!loadFullRoster() || !requireBuiltInClasses("The solver")) {
+            return false;
+        }
+        cout << "Solving " << characters.size() * (characters.size() - 1) / 2 << " roster pairings in "
+            << arenas.size() << " arenas" << endl;
+        auto start = chrono::steady_clock::now();
+        if (!buildTablebase(characters, arenas, options.solveFile, cout)) {
+            cout << "Error: Could not write tablebase file " << options.solveFile << endl;
+            return false;
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if (!loadTablebase(options.solveFile)) {
+            return false;
+        }
+        cout << "Solved " << tablebase.getStateCount() << " states in " << seconds << " s" << endl;
+        return true;
+    }
+    bool GameManager::loadTablebase(const string& path) {
+        if (!tablebase.open(path)) {
+            cout << "Error: Could not read tablebase file " << path << endl;
+            return false;
+        }
+        cout << "Loaded tablebase with " << tablebase.getMatchupCount() << " matchups ("
+            << tablebase.getStateCount() << " states) from " << path << endl;
+        return true;
+    }
+    bool GameManager::rosterImageMode(const SimulationOptions& options) {
+        setRosterFiles(options.rosterFile, "");
+        if (!initializeGame()) {
+            return false;
+        }
+        string error;
+        if (!writeRosterImage(options.rosterImageOutput, characters, arenas, error)) {
+            cout << "Error: Could not write roster image " << options.rosterImageOutput << ": " << error << endl;
+            return false;
+        }
+        cout << "Wrote " << characters.size() << " characters and " << arenas.size() << " arenas to "
+            << options.rosterImageOutput << endl;
+        return true;
+    }
+    bool GameManager::tournamentMode(const SimulationOptions& options) {
+        if (getRosterSize() == 0) {
+            setRosterFiles(options.rosterFile, options.rosterImageFile);
+            if (!initializeGame()) {
+                return false;
+            }
+        }
+        if (!loadFullRoster()) {
+            return false;
+        }
+        ActionPolicy* policy1 = createPolicy(options.policy1);
+        ActionPolicy* policy2 = createPolicy(options.policy2);
+        bool validPolicies = policy1 && policy2;
+        delete policy1;
+        delete policy2;
+        if (!validPolicies) {
+            cout << "Error: Unknown policy. Use attack, ability, random or search." << endl;
+            return false;
+        }
+        uint64_t seed = options.hasSeed ? options.seed : BattleRandom::seedFromClock();
+        cout << "Running tournament: " << characters.size() << " characters, " << arenas.size()
+            << " arenas, " << options.tournament << " battles per matchup..." << endl;
+        // Workers must not print; the flag is only read while they run
+        ConsoleMode consoleMode = Character::getConsoleMode();
+        Character::setConsoleOutput(false);
+        if (options.instrument) {
+            enableInstrumentation(options.instrumentFile);
+        }
+        BattleInstrumentation instrumentation;
+        openRatings();
+        TournamentResult result = runTournament(characters, arenas, options.policy1, options.policy2,
+            options.tournament, options.threads, seed, instrumentBattles ? &instrumentation : nullptr, &ratings);
+        Character::setConsoleMode(consoleMode);
+        printTournamentTable(cout, result, characters);
+        vector<uint32_t> leaders;
+        ratings.getTop(LEADERBOARD_TOURNAMENT_ROWS, leaders);
+        cout << "\nLeaderboard (" << ratings.getRatedCount() << " rated):" << endl;
+        printLeaderboard(leaders);
+        saveRatings();
+        if (instrumentBattles) {
+            // Phase times are summed over all worker threads
+            reportInstrumentation(instrumentation, "TOURNAMENT INSTRUMENTATION");
+        }
+        return true;
+    }
+    void GameManager::openRatings() {
+        if (ratings.size() == getRosterSize()) {
+            return; // Opened on first use, so a large roster image still maps instantly
+        }
+        ratings.reset(getRosterSize());
+        if (ratingsFile.empty()) {
+            return;
+        }
+        ifstream existing(ratingsFile);
+        if (!existing.is_open()) {
+            return; // Created by the first save
+        }
+        existing.close();
+        if (!ratings.load(ratingsFile, fingerprintRoster(rosterIndex.getData()))) {
+            cout << "Warning: Ratings file " << ratingsFile
+                << " is damaged or belongs to another roster; not using it." << endl;
+            ratingsFile.clear(); // Never overwrite it
+        }
+    }
+    void GameManager::saveRatings() const {
+        if (!ratingsFile.empty() && !ratings.save(ratingsFile, fingerprintRoster(rosterIndex.getData()))) {
+            cout << "Error: Could not write ratings file " << ratingsFile << endl;
+        }
+    }
+    void GameManager::recordRating(int player1, int player2, const BattleResult& result) {
+        if (result.winner == 0 || player1 < 0 || player2 < 0) {
+            return; // Saved and quit; rated when it is finished
+        }
+        openRatings();
+        uint32_t first = static_cast<uint32_t>(player1);
+        uint32_t second = static_cast<uint32_t>(player2);
+        ratings.recordBattle(result.winner == 1 ? first : second, result.winner == 1 ? second : first);
+        saveRatings();
+    }
+    void GameManager::printLeaderboard(const vector<uint32_t>& ids) const {
+        cout << fixed << setprecision(0);
+        for (uint32_t id : ids) {
+            const CharacterRating& entry = ratings.getRating(id);
+            cout << right << setw(6) << ratings.getRank(id) + 1 << ". " << setw(5) << entry.rating << " +/-" << left
+                << setw(4) << entry.deviation << right << setw(8) << entry.battles << " battles " << setw(4)
+                << 100.0 * entry.wins / entry.battles << "% won  ";
+            printRosterEntry(id);
+        }
+        cout.unsetf(ios::fixed);
+        cout << setprecision(6);
+    }
+    void GameManager::leaderboardMode() {
+        clearScreen();
+        cout << "\n=== LEADERBOARD ===" << endl;
+        openRatings();
+        if (ratings.getRatedCount() == 0) {
+            cout << "No rated battles yet. Every finished battle and tournament rates its characters." << endl;
+            pauseScreen();
+            return;
+        }
+        vector<uint32_t> ids;
+        ratings.getTop(LEADERBOARD_ROWS, ids);
+        cout << ratings.getRatedCount() << " rated characters (Glicko rating +/- deviation)" << endl;
+        printLeaderboard(ids);
+        string input;
+        while (true) {
+            cout << "\nEnter a rating to see the characters near it, a character name for its rank, or press Enter to return: ";
+            if (!getline(cin, input) || input.empty()) {
+                return;
+            }
+            char* end = nullptr;
+            double rating = strtod(input.c_str(), &end);
+            if (end != input.c_str() && *end == '\0') {
+                ratings.getNear(rating, LEADERBOARD_NEAR_ROWS, ids);
+                printLeaderboard(ids);
+                continue;
+            }
+            long position = rosterIndex.findByName(input);
+            if (position < 0) {
+                cout << "No character named " << input << "." << endl;
+            }
+            else if (!ratings.isRated(static_cast<uint32_t>(position))) {
+                cout << input << " has no rated battles yet." << endl;
+            }
+            else {
+                printLeaderboard({ static_cast<uint32_t>(position) });
+            }
+        }
+    }
+    void GameManager::enableInstrumentation(const string& reportFile) {
+        instrumentBattles = true;
+        instrumentationFile = reportFile;
+    }
+    void GameManager::reportInstrumentation(const BattleInstrumentation& instrumentation, const string& title) const {
+        instrumentation.printReport(cout, title);
+        if (!instrumentationFile.empty()) {
+            ofstream report(instrumentationFile, ios::app);
+            if (report.is_open()) {
+                instrumentation.printReport(report, title);
+            }
+            else {
+                cout << "Error: Could not write instrumentation report " << instrumentationFile << endl;
+            }
+        }
+    }
+    bool GameManager::winRateMode(const SimulationOptions& options) {
+        WinRateConfig config = defaultWinRateConfig();
+        config.policy1 = options.policy1;
+        config.policy2 = options.policy2;
+        config.levels = options.levels;
+        config.targetHalfWidth = options.confidenceHalfWidth;
+        config.maxBattles = options.maxBattles;
+        config.threads = options.threads;
+        config.seed = options.hasSeed ? options.seed : BattleRandom::seedFromClock();
+        ActionPolicy* policy1 = createPolicy(config.policy1);
+        ActionPolicy* policy2 = createPolicy(config.policy2);
+        bool validPolicies = policy1 && policy2;
+        delete policy1;
+        delete policy2;
+        if (!validPolicies) {
+            cout << "Error: Unknown policy. Use attack, ability, random or search." << endl;
+            return false;
+        }
+        if (config.policy1 != "random" && config.policy2 != "random") {
+            cout << "Note: with two deterministic policies every battle of a cell is identical." << endl;
+        }
+        ConsoleMode consoleMode = Character::getConsoleMode();
+        Character::setConsoleOutput(false);
+        WinRateMatrix matrix = computeWinRateMatrix(config);
+        Character::setConsoleMode(consoleMode);
+        printWinRateMatrix(cout, matrix);
+        return true;
+    }
+    void GameManager::displayGameInformation() const {
+        clearScreen();
+        cout << "\n=== Fantasy Arena Game Information ===" << endl;
+        cout << "Fantasy Arena is a turn-based battle game where you can choose characters" << endl;
+        cout << "from different classes and battle in various environments." << endl;
+        cout << endl;
+        cout << "Each character has a special ability:" << endl;
+        cout << "- Warriors: Transparent, immune to every attack for one turn" << endl;
+        cout << "- Mages: Mirror Image, the next attack against them misses" << endl;
+        cout << "- Archers: Evasive Roll, dodge the next attack and shoot at once, ignoring half the target's defense" << endl;
+        cout << endl;
+        cout << "Measuring class balance..." << endl;
+
+        // Small, fixed-seed matrix so the numbers are the same on every run
+        const CharacterKind classes[] = { CharacterKind::WARRIOR, CharacterKind::MAGE, CharacterKind::ARCHER };
+        WinRateConfig config = defaultWinRateConfig();
+        config.classes.assign(begin(classes), end(classes));
+        config.levels = { 5 };
+        config.targetHalfWidth = 0.03;
+        config.maxBattles = 4000;
+        config.seed = 1;
+        ConsoleMode consoleMode = Character::getConsoleMode();
+        Character::setConsoleOutput(false);
+        WinRateMatrix matrix = computeWinRateMatrix(config);
+        Character::setConsoleMode(consoleMode);
+
+        // Battles won by each class against the other classes, overall and per environment
+        const int environments = ENVIRONMENT_COUNT;
+        const int classCount = 3;
+        long long wins[environments + 1][classCount] = {};
+        long long battles[environments + 1][classCount] = {};
+        double turns[environments] = {};
+        long long cellBattles[environments] = {};
+        for (const WinRateCell& cell : matrix.cells) {
+            int e = static_cast<int>(cell.environment);
+            turns[e] += cell.meanTurns * cell.battles;
+            cellBattles[e] += cell.battles;
+            if (cell.kind1 == cell.kind2) {
+                continue;
+            }
+            int c1 = static_cast<int>(cell.kind1);
+            int c2 = static_cast<int>(cell.kind2);
+            for (int row : { e, environments }) {
+                wins[row][c1] += cell.player1Wins;
+                wins[row][c2] += cell.battles - cell.player1Wins;
+                battles[row][c1] += cell.battles;
+                battles[row][c2] += cell.battles;
+            }
+        }
+
+        cout << fixed << setprecision(1);
+        cout << "\nMeasured balance, level 5 against level 5 with random play (95% confidence):" << endl;
+        for (int c = 0; c < classCount; ++c) {
+            ConfidenceInterval interval = wilsonInterval(wins[environments][c], battles[environments][c], config.z);
+            cout << "- " << getClassNameForKind(classes[c]) << ": wins " << 100.0 * wins[environments][c] / battles[environments][c]
+                << "% [" << 100.0 * interval.low << "-" << 100.0 * interval.high << "] against the other classes" << endl;
+        }
+        cout << endl;
+        cout << "Different arenas change the fighters' stats (win % against the other classes):" << endl;
+        for (int e = 0; e < environments; ++e) {
+            cout << "- " << getEnvironmentNameForType(static_cast<EnvironmentType>(e)) << " (" << formatEnvironmentMultipliers(static_cast<EnvironmentType>(e)) << "): ";
+            for (int c = 0; c < classCount; ++c) {
+                cout << getClassNameForKind(classes[c]) << " " << 100.0 * wins[e][c] / battles[e][c] << "%"
+                    << (c + 1 < classCount ? " | " : "");
+            }
+            cout << ", " << turns[e] / cellBattles[e] << " turns on average" << endl;
+        }
+        cout << "(" << matrix.totalBattles << " simulated battles)" << endl;
+        cout << "======================================" << endl;
+        cout.unsetf(ios::fixed);
+        cout << setprecision(6);
+    }
     int GameManager::getValidInput(int min, int max) const {
         int choice;
         while (!(cin >> choice) || choice < min || choice > max) {
@@ -198,53 +1005,140 @@ namespace FantasyArena {
         cout << "\nPress Enter to continue...";
         cin.ignore(numeric_limits<streamsize>::max(), '\n');
     }
-    void GameManager::saveGame() const {
-        ofstream saveFile("fantasy_arena_save.dat", ios::binary);
-        if (saveFile.is_open()) {
-            // Validate data before saving
-            if (saveData.player1Index >= 0 && static_cast<size_t>(saveData.player1Index) < characters.size() &&
-                saveData.player2Index >= 0 && static_cast<size_t>(saveData.player2Index) < characters.size() &&
-                saveData.arenaIndex >= 0 && static_cast<size_t>(saveData.arenaIndex) < arenas.size()) {
-                saveFile.write(reinterpret_cast<const char*>(&saveData), sizeof(SaveData));
-                saveFile.close();
+    bool GameManager::saveGame(const string& slotName) {
+        // Validate data before saving
+        if (saveData.player1Index < 0 || static_cast<size_t>(saveData.player1Index) >= getRosterSize() ||
+            saveData.player2Index < 0 || static_cast<size_t>(saveData.player2Index) >= getRosterSize() ||
+            saveData.arenaIndex < 0 || static_cast<size_t>(saveData.arenaIndex) >= arenas.size()) {
+            cout << "Error: Invalid save data." << endl;
+            return false;
+        }
+        if (!saveStore.open(SAVE_STORE_FILE)) {
+            cout << "Error: Save file " << SAVE_STORE_FILE << " is damaged; not overwriting it." << endl;
+            return false;
+        }
+        SaveSlotRecord slot = SaveStore::makeSlot(slotName, saveData.player1Index, saveData.player2Index,
+            saveData.arenaIndex, saveData.battleCount, saveData.seed);
+        if (saveData.inBattle) {
+            SaveStore::setCheckpoint(slot, saveData.checkpoint);
+        }
+        if (!saveStore.save(slot)) {
+            cout << "Error: Could not write save file " << SAVE_STORE_FILE << endl;
+            return false;
+        }
+        return true;
+    }
+    void GameManager::saveSuspendedBattle(const Arena& arena) {
+        if (!arena.isBattleSuspended()) {
+            return;
+        }
+        saveData.inBattle = true;
+        saveData.checkpoint = arena.getSuspendedBattle();
+        cout << "\nSaving the battle before turn " << saveData.checkpoint.turnNumber << "." << endl;
+        string slotName = selectSlotName();
+        if (slotName.empty()) {
+            cout << "Error: Save file " << SAVE_STORE_FILE << " is damaged; not overwriting it." << endl;
+        }
+        else if (saveGame(slotName)) {
+            cout << "Battle saved to slot " << slotName << "!" << endl;
+        }
+        saveData.inBattle = false;
+    }
+    string GameManager::selectSlotName() {
+        if (!saveStore.open(SAVE_STORE_FILE)) {
+            return "";
+        }
+        // First unused "battle-N" as the default
+        size_t number = saveStore.getSlotCount() + 1;
+        while (saveStore.contains("battle-" + to_string(number))) {
+            ++number;
+        }
+        string defaultName = "battle-" + to_string(number);
+        while (true) {
+            cout << "Slot name (Enter for " << defaultName << "): ";
+            string name;
+            if (!getline(cin, name)) {
+                return defaultName;
             }
-            else {
-                cout << "Error: Invalid save data." << endl;
-                saveFile.close();
+            if (name.empty()) {
+                return defaultName;
+            }
+            if (!SaveStore::isValidSlotName(name)) {
+                cout << "Slot names are 1-" << SAVE_SLOT_NAME_SIZE - 1 << " printable characters." << endl;
+                continue;
+            }
+            if (!saveStore.contains(name)) {
+                return name;
+            }
+            cout << "Slot " << name << " exists. Overwrite it? (1: Yes, 2: No): ";
+            if (getValidInput(1, 2) == 1) {
+                return name;
             }
-        }
-        else {
-            cout << "Error: Could not create save file." << endl;
         }
     }
     bool GameManager::loadGame() {
-        ifstream saveFile("fantasy_arena_save.dat", ios::binary);
-        if (saveFile.is_open()) {
-            // Check if file is empty
-            saveFile.seekg(0, ios::end);
-            if (saveFile.tellg() < static_cast<std::streampos>(sizeof(SaveData))) {
-                cout << "Error: Save file is corrupted or incomplete." << endl;
-                saveFile.close();
-                return false;
-            }
-            // Reset to beginning of file and read data
-            saveFile.seekg(0, ios::beg);
-            saveFile.read(reinterpret_cast<char*>(&saveData), sizeof(SaveData));
-            saveFile.close();
-            // Validate the loaded data
-            if (saveData.player1Index >= 0 && static_cast<size_t>(saveData.player1Index) < characters.size() &&
-                saveData.player2Index >= 0 && static_cast<size_t>(saveData.player2Index) < characters.size() &&
-                saveData.arenaIndex >= 0 && static_cast<size_t>(saveData.arenaIndex) < arenas.size() &&
-                saveData.battleCount > 0) {
-                return true;
+        if (!saveStore.open(SAVE_STORE_FILE)) {
+            cout << "Error: Save file " << SAVE_STORE_FILE << " is damaged." << endl;
+            return false;
+        }
+        size_t slotCount = saveStore.getSlotCount();
+        if (slotCount == 0) {
+            return false;
+        }
+        // Newest first; older slots are loaded by name
+        size_t shown = min(slotCount, SAVE_SLOTS_SHOWN);
+        cout << "\n=== SAVED GAMES (" << slotCount << ") ===" << endl;
+        for (size_t i = 0; i < shown; ++i) {
+            SaveSlotRecord slot;
+            cout << i + 1 << ". ";
+            if (!saveStore.getSlot(slotCount - 1 - i, slot)) {
+                cout << "(damaged slot)" << endl;
+                continue;
             }
-            else {
-                cout << "Error: Save file contains invalid data." << endl;
+            time_t savedAt = static_cast<time_t>(slot.savedAt);
+            char savedTime[32];
+            strftime(savedTime, sizeof(savedTime), "%Y-%m-%d %H:%M", localtime(&savedAt));
+            cout << slot.name << " - battle #" << slot.battleCount;
+            if (slot.flags & SAVE_SLOT_IN_BATTLE) {
+                cout << " (in progress, turn " << slot.turnNumber << ")";
             }
+            cout << ", saved " << savedTime << endl;
+        }
+        cout << "Enter a slot number (1-" << shown << "), or 0 to type a slot name: ";
+        int choice = getValidInput(0, static_cast<int>(shown));
+        SaveSlotRecord slot;
+        bool found;
+        if (choice == 0) {
+            cout << "Slot name: ";
+            string name;
+            getline(cin, name);
+            found = saveStore.find(name, slot);
         }
         else {
-            cout << "Error: Could not open save file." << endl;
+            found = saveStore.getSlot(slotCount - choice, slot);
+        }
+        if (!found) {
+            cout << "Error: Slot not found or damaged." << endl;
+            return false;
         }
+        // Validate the loaded data
+        if (slot.player1Index >= 0 && static_cast<size_t>(slot.player1Index) < getRosterSize() &&
+            slot.player2Index >= 0 && static_cast<size_t>(slot.player2Index) < getRosterSize() &&
+            slot.arenaIndex >= 0 && static_cast<size_t>(slot.arenaIndex) < arenas.size() &&
+            slot.battleCount > 0) {
+            saveData.player1Index = slot.player1Index;
+            saveData.player2Index = slot.player2Index;
+            saveData.arenaIndex = slot.arenaIndex;
+            saveData.battleCount = slot.battleCount;
+            saveData.seed = slot.seed;
+            saveData.inBattle = SaveStore::getCheckpoint(slot, saveData.checkpoint);
+            if ((slot.flags & SAVE_SLOT_IN_BATTLE) && !saveData.inBattle) {
+                cout << "Error: Save slot contains an invalid battle." << endl;
+                return false;
+            }
+            return true;
+        }
+        cout << "Error: Save slot contains invalid data." << endl;
         return false;
     }
     void GameManager::saveGameMode() {
@@ -252,17 +1146,52 @@ namespace FantasyArena {
         cout << "\n=== SAVED GAME ===" << endl;
         // Display saved battle information
         cout << "\nLoaded saved battle #" << saveData.battleCount << ":" << endl;
-        cout << "Player 1: " << characters[saveData.player1Index]->getName() <<
-            " (" << characters[saveData.player1Index]->getClassName() << ")" << endl;
-        cout << "Player 2: " << characters[saveData.player2Index]->getName() <<
-            " (" << characters[saveData.player2Index]->getClassName() << ")" << endl;
+        const Character* player1Character = selectCharacter(saveData.player1Index);
+        const Character* player2Character = selectCharacter(saveData.player2Index);
+        if (!player1Character || !player2Character) {
+            cout << "Error: The roster image has a damaged character record." << endl;
+            pauseScreen();
+            return;
+        }
+        cout << "Player 1: " << player1Character->getName() <<
+            " (" << player1Character->getClassName() << ")" << endl;
+        cout << "Player 2: " << player2Character->getName() <<
+            " (" << player2Character->getClassName() << ")" << endl;
         cout << "Arena: " << arenas[saveData.arenaIndex].getName() <<
             " (" << arenas[saveData.arenaIndex].getEnvironmentName() << ")" << endl;
+        cout << "Seed: " << saveData.seed << endl;
+        if (saveData.inBattle) {
+            const BattleCheckpoint& checkpoint = saveData.checkpoint;
+            cout << "Battle in progress: turn " << checkpoint.turnNumber << ", Player " << checkpoint.attacker << " to move" << endl;
+            cout << player1Character->getName() << ": " << checkpoint.fighters[0].health << " HP, "
+                << player2Character->getName() << ": " << checkpoint.fighters[1].health << " HP" << endl;
+            cout << "\nDo you want to resume this battle? (1: Yes, 2: No): ";
+            if (getValidInput(1, 2) == 1) {
+                Arena* selectedArena = selectArena(saveData.arenaIndex);
+                ActionPolicy* player1Policy = selectController(1);
+                ActionPolicy* player2Policy = selectController(2);
+                clearScreen();
+                selectedArena->setBattleSeed(saveData.seed);
+                selectedArena->setTablebase(tablebase.isOpen() ? &tablebase : nullptr);
+                BattleInstrumentation instrumentation;
+                BattleInstrumentation::attach(instrumentBattles ? &instrumentation : nullptr);
+                BattleResult result = selectedArena->resumeBattle(*player1Character, *player2Character, *player1Policy,
+                    *player2Policy, checkpoint);
+                BattleInstrumentation::attach(nullptr);
+                recordRating(saveData.player1Index, saveData.player2Index, result);
+                if (instrumentBattles) {
+                    reportInstrumentation(instrumentation, "BATTLE INSTRUMENTATION");
+                }
+                delete player1Policy;
+                delete player2Policy;
+                saveSuspendedBattle(*selectedArena);
+                pauseScreen();
+            }
+            return;
+        }
         cout << "\nDo you want to start this battle? (1: Yes, 2: No): ";
         int choice = getValidInput(1, 2);
         if (choice == 1) {
-            Character* player1Character = selectCharacter(saveData.player1Index);
-            Character* player2Character = selectCharacter(saveData.player2Index);
             Arena* selectedArena = selectArena(saveData.arenaIndex);
             // Display selected characters and arena
             clearScreen();
@@ -275,7 +1204,16 @@ namespace FantasyArena {
             cin.ignore(numeric_limits<streamsize>::max(), '\n');
             // Start the battle
             clearScreen();
-            selectedArena->startBattle(player1Character, player2Character);
+            selectedArena->setBattleSeed(saveData.seed);
+            BattleInstrumentation instrumentation;
+            BattleInstrumentation::attach(instrumentBattles ? &instrumentation : nullptr);
+            BattleResult result = selectedArena->startBattle(*player1Character, *player2Character);
+            BattleInstrumentation::attach(nullptr);
+            recordRating(saveData.player1Index, saveData.player2Index, result);
+            if (instrumentBattles) {
+                reportInstrumentation(instrumentation, "BATTLE INSTRUMENTATION");
+            }
+            saveSuspendedBattle(*selectedArena);
             pauseScreen();
         }
     }
@@ -2,13 +2,29 @@
 #ifndef GAME_MANAGER_H
 #define GAME_MANAGER_H
 #include <vector>
+#include <unordered_map>
 #include "Character.h"
 #include "Arena.h"
+#include "Simulation.h"
+#include "DamageTable.h"
+#include "Tablebase.h"
+#include "SaveStore.h"
+#include "BattleInstrumentation.h"
+#include "Roster.h"
+#include "RosterImage.h"
+#include "Ratings.h"
 using namespace std;
 namespace FantasyArena {
     class GameManager {
     private:
-        vector<Character*> characters;
+        vector<Character*> characters; // Whole roster; with an image, only after loadFullRoster
+        RosterIndex rosterIndex; // Rebuilt by initializeGame, or attached to the image
+        string rosterFile; // Import the roster from here instead of the default characters
+        string rosterImageFile; // Map the roster and arenas from here instead (takes precedence)
+        RosterImage rosterImage;
+        unordered_map<uint32_t, Character*> imageCharacters; // Templates built from the image on request
+        void printRosterEntry(size_t position) const; // "Name (Level N Class)"
+        bool requireBuiltInClasses(const string& mode) const; // For engines with the built-in rules compiled in
         vector<Arena> arenas;
         bool gameRunning;
         // Save game data
@@ -17,31 +33,83 @@ namespace FantasyArena {
             int player2Index;
             int arenaIndex;
             int battleCount;
+            uint64_t seed; // Replays the saved battle exactly
+            bool inBattle; // Saved mid-fight; resumes from checkpoint
+            BattleCheckpoint checkpoint;
         };
         SaveData saveData;
+        SaveStore saveStore; // Named save slots on disk
+        Tablebase tablebase; // Perfect-play outcomes for the computer opponent, if loaded
+        RatingTable ratings; // Glicko ratings by roster position, sized on first use
+        string ratingsFile; // Keep the ratings here between runs, if set
+        void openRatings(); // Size the table to the roster and load the ratings file, once
+        void saveRatings() const;
+        void recordRating(int player1, int player2, const BattleResult& result); // Completed battles only
+        void printLeaderboard(const vector<uint32_t>& ids) const;
+        bool instrumentBattles; // Report counters and phase timers after every battle and tournament
+        string instrumentationFile; // Also append the reports here, if set
+        void reportInstrumentation(const BattleInstrumentation& instrumentation, const string& title) const;
     public:
         GameManager();
         ~GameManager();
 
         // Character management
         void addCharacter(Character* character);
-        void displayCharacters() const;
-        Character* selectCharacter(int index) const;
+        void displayCharacters() const; // The first page for a large roster
+        const Character* selectCharacter(int index); // Roster entries are never modified by battles
+        size_t getRosterSize() const;
+        bool loadFullRoster(); // Build every template of an image for the whole-roster modes
+        // Pick from the list, or search and page through a large roster; -1 at end of input
+        int chooseCharacter(int excluded) const;
+        void setRosterFiles(const string& csvPath, const string& imagePath) {
+            rosterFile = csvPath;
+            rosterImageFile = imagePath;
+        }
 
         // Arena management
         void addArena(const Arena& arena);
         void displayArenas() const;
         Arena* selectArena(int index);
 
+        void setRatingsFile(const string& path) { ratingsFile = path; }
+        // Instrument the following battles; reports also go to reportFile if not empty
+        void enableInstrumentation(const string& reportFile);
+
         // Game flow
-        void initializeGame();
+        bool initializeGame(); // False if the roster file or image cannot be read
         void runGame();
         void displayMainMenu() const;
         void battleMode();
+        // Ask whether a player is a human or the computer; the caller owns the result
+        ActionPolicy* selectController(int player) const;
+        // Headless simulation selected from the command line
+        bool simulationMode(const SimulationOptions& options);
+        // Headless team or free-for-all battles of fighters taken from the roster in order
+        bool teamBattleMode(const SimulationOptions& options);
+        // Every roster pairing in every arena on the batch engine or the damage tables
+        bool batchMode(const SimulationOptions& options);
+        // Load the damage tables from a file, or build them (and save them if a path is given)
+        bool loadDamageTable(DamageTable& table, const string& path, int maxLevel);
+        // Solve every roster pairing in every arena and write the tablebase
+        bool solveMode(const SimulationOptions& options);
+        // Memory-map a tablebase written by solveMode for the following battles
+        bool loadTablebase(const string& path);
+        // Write the roster (default or imported) and the arenas as a roster image
+        bool rosterImageMode(const SimulationOptions& options);
+        // Round robin of the whole roster in every arena on all cores
+        bool tournamentMode(const SimulationOptions& options);
+        // Win rates with confidence intervals for every class, level and environment
+        bool winRateMode(const SimulationOptions& options);
+        // Game information with measured class balance
+        void displayGameInformation() const;
+        // Top of the ratings, characters near a rating and the rank of a character
+        void leaderboardMode();
 
         // Save/Load game
-        void saveGame() const;
-        bool loadGame();
+        bool saveGame(const string& slotName); // Adds or replaces the slot, with the battle if saveData.inBattle
+        void saveSuspendedBattle(const Arena& arena); // After a battle the player saved and quit
+        bool loadGame(); // Pick a slot into saveData
+        string selectSlotName(); // Ask for a slot name for saveGame
         void saveGameMode();
 
         // Helper methods
@@ -0,0 +1,183 @@
+#include "LogEvent.h"
+#include "StatTables.h"
+#include "ClassDefinitions.h"
+using namespace std;
+namespace FantasyArena {
+    namespace {
+        // Class-specific wording; {a} is the actor, {t} the target, {v} the
+        // value, {x} the aux value and {s} the actor's ability name.
+        // nullptr: the class never logs the event.
+        struct ClassLogText {
+            bool attackShown;           // Attacks also appear on the console
+            const char* activeAttack;   // Attack while the ability is active
+            const char* abilityUsed;
+            const char* cooldownStarted;
+            const char* onCooldown;
+            const char* negatedConsole;
+            const char* negatedFile;
+            const char* ended;
+        };
+
+        // Indexed by CharacterKind
+        const ClassLogText CLASS_LOG_TEXT[CHARACTER_KIND_COUNT] = {
+            { true, "{a} attacks {t} for {v} damage (Transparent active!)",
+                "{a} becomes Transparent! Immune to attacks for 1 turn.",
+                "{a}'s Transparent ability is now on cooldown for {v} turns.",
+                "{a}'s Transparent ability is on cooldown ({v} turns remaining)",
+                "{t}'s attack passes through {a}'s transparent form!",
+                "{t}'s attack missed due to Transparent.",
+                "{a}'s Transparent ability ends. No longer immune to attacks." },
+            { false, "{a} attacks {t} for {v} damage (Mirror Image active!)",
+                "{a} creates a Mirror Image! The next attack will miss completely.",
+                "{a}'s Mirror Image ability is now on cooldown for {v} turns.",
+                "{a}'s Mirror Image is on cooldown ({v} turns remaining)",
+                "{t}'s attack is fooled by {a}'s mirror image!",
+                "{t}'s attack missed due to Mirror Image.",
+                "{a}'s Mirror Image fades away. No longer protected from attacks." },
+            { false, "{a} attacks {t} for {v} damage (Evasive Roll active!)",
+                "{a} performs an Evasive Roll! Will dodge the next attack completely.",
+                "{a}'s Evasive Roll ability is now on cooldown for {v} turns.",
+                "{a}'s Evasive Roll is on cooldown ({v} turns remaining)",
+                "{a} dodges the attack with an Evasive Roll!",
+                "{t}'s attack missed due to Evasive Roll.",
+                "{a}'s Evasive Roll ends. No longer able to dodge attacks." },
+            { false, nullptr,
+                "{a}'s Resurrection ability is passive and will trigger automatically upon death.",
+                nullptr, nullptr, nullptr, nullptr, nullptr },
+            { false, "{a} attacks {t} for {v} damage (Mirror Strike active!)",
+                "{a} activates Mirror Strike! Will reflect {v}% of incoming damage back to attackers.",
+                nullptr,
+                "{a}'s Mirror Strike is on cooldown ({v} turns remaining)",
+                nullptr, nullptr,
+                "{a}'s Mirror Strike ends." }
+        };
+
+        // Classes from a definitions file, worded from the ability name
+        const ClassLogText CUSTOM_LOG_TEXT = { true, "{a} attacks {t} for {v} damage ({s} active!)",
+            "{a} activates {s}!",
+            "{a}'s {s} is now on cooldown for {v} turns.",
+            "{a}'s {s} is on cooldown ({v} turns remaining)",
+            "{t}'s attack is negated by {a}'s {s}!",
+            "{t}'s attack missed due to {s}.",
+            "{a}'s {s} ends." };
+        const ClassLogText PASSIVE_CUSTOM_LOG_TEXT = { true, nullptr,
+            "{a}'s {s} is passive and will trigger automatically upon death.",
+            nullptr, nullptr, nullptr, nullptr, nullptr };
+
+        const char* abilityNameFor(uint8_t classId) {
+            return classId < CHARACTER_KIND_COUNT ? CLASS_STATS[classId].abilityName
+                : getCustomClass(classId).abilityName.c_str();
+        }
+
+        void appendInt(string& out, int32_t value) {
+            char digits[12];
+            int count = 0;
+            uint32_t magnitude = value < 0 ? 0u - static_cast<uint32_t>(value) : static_cast<uint32_t>(value);
+            do {
+                digits[count++] = static_cast<char>('0' + magnitude % 10);
+                magnitude /= 10;
+            } while (magnitude != 0);
+            if (value < 0) {
+                out += '-';
+            }
+            while (count > 0) {
+                out += digits[--count];
+            }
+        }
+
+        bool expand(const char* pattern, const LogEvent& event, const string& actorName, const string& targetName,
+            string& out) {
+            if (!pattern) {
+                return false;
+            }
+            for (const char* c = pattern; *c; ++c) {
+                if (c[0] == '{' && c[1] && c[2] == '}') {
+                    switch (c[1]) {
+                    case 'a':
+                        out += actorName;
+                        break;
+                    case 't':
+                        out += targetName;
+                        break;
+                    case 'v':
+                        appendInt(out, event.value);
+                        break;
+                    case 'x':
+                        appendInt(out, event.aux);
+                        break;
+                    case 's':
+                        out += abilityNameFor(event.kind);
+                        break;
+                    default:
+                        out.append(c, 3);
+                        break;
+                    }
+                    c += 2;
+                }
+                else {
+                    out += *c;
+                }
+            }
+            return true;
+        }
+    }
+
+    bool formatLogEvent(const LogEvent& event, LogView view, const string& actorName, const string& targetName,
+        string& out) {
+        // The kind byte holds the class id, so custom classes get their own names
+        const bool custom = event.kind >= CHARACTER_KIND_COUNT;
+        if (custom && !isCustomClassId(event.kind)) {
+            return false;
+        }
+        const ClassLogText& text = !custom ? CLASS_LOG_TEXT[event.kind] :
+            getCustomClass(event.kind).passive ? PASSIVE_CUSTOM_LOG_TEXT : CUSTOM_LOG_TEXT;
+        const bool console = view == LogView::CONSOLE;
+        const char* pattern = nullptr;
+        switch (event.type) {
+        case LogEventType::TURN_START:
+            pattern = console ? nullptr : "Turn {v}: {a}'s turn";
+            break;
+        case LogEventType::ATTACK:
+            if (!console || text.attackShown) {
+                pattern = event.aux && text.activeAttack ? text.activeAttack : "{a} attacks {t} for {v} damage";
+            }
+            break;
+        case LogEventType::ABILITY_USED:
+            pattern = text.abilityUsed;
+            break;
+        case LogEventType::COOLDOWN_STARTED:
+            pattern = text.cooldownStarted;
+            break;
+        case LogEventType::ON_COOLDOWN:
+            pattern = text.onCooldown;
+            break;
+        case LogEventType::ATTACK_NEGATED:
+            pattern = console ? text.negatedConsole : text.negatedFile;
+            break;
+        case LogEventType::ABILITY_ENDED:
+            pattern = text.ended;
+            break;
+        case LogEventType::RESURRECTED:
+            pattern = console ? "\n*** {a} RESURRECTS with {v} health! ***\n" : "{a} RESURRECTS with {v} health!";
+            break;
+        case LogEventType::REFLECTED:
+            pattern = custom ? "{a}'s {s} reflects {v} damage back to {t}!" : "{a}'s Mirror Strike reflects {v} damage back to {t}!";
+            break;
+        case LogEventType::SPECIAL_ABILITY:
+            pattern = console ? "{a} uses {s}!" : "{a} uses special ability: {s}";
+            break;
+        case LogEventType::EVASIVE_ATTACK:
+            pattern = !console ? nullptr : custom ? "{a} attacks with {s}!" : "{a} attacks while in evasive stance!";
+            break;
+        case LogEventType::COOLDOWN_RESET:
+            pattern = console ? nullptr : "{a}'s ability is now on cooldown ({v} turns).";
+            break;
+        case LogEventType::HEALTH:
+            pattern = console ? nullptr : "{a} HP: {v}/{x}";
+            break;
+        default:
+            break;
+        }
+        return expand(pattern, event, actorName, targetName, out);
+    }
+} // namespace FantasyArena
@@ -0,0 +1,51 @@
+#pragma once
+#ifndef LOG_EVENT_H
+#define LOG_EVENT_H
+#include <string>
+#include <cstdint>
+using namespace std;
+namespace FantasyArena {
+    // What happened; the wording comes from the templates in LogEvent.cpp
+    enum class LogEventType : uint8_t {
+        TEXT,              // Preformatted line (battle start and end, seeds, environment)
+        TURN_START,        // value: turn number
+        ATTACK,            // value: damage, aux: 1 if the attacker's ability is active
+        ABILITY_USED,      // value: reflected percentage for Mirror Strike
+        COOLDOWN_STARTED,  // value: turns
+        ON_COOLDOWN,       // value: turns remaining
+        ATTACK_NEGATED,    // actor: the defender whose ability negated it, target: the attacker
+        ABILITY_ENDED,
+        RESURRECTED,       // value: health
+        REFLECTED,         // value: damage, target: the attacker hit by it
+        SPECIAL_ABILITY,   // The arena announces an ability use
+        EVASIVE_ATTACK,    // The Archer attacks from the evasive stance
+        COOLDOWN_RESET,    // value: turns
+        HEALTH             // value: health, aux: maximum health
+    };
+
+    // Where a formatted event goes; some events read differently on the
+    // console, and some only appear in one of them
+    enum class LogView {
+        CONSOLE,
+        FILE
+    };
+
+    const uint8_t LOG_NAME_UNKNOWN = 0xFF; // Name handle of a character the sink does not know
+
+    // One log call, recorded without building any text. Names are handles
+    // into the sink's name table, so an event can be formatted after the
+    // character it names has moved on.
+    struct LogEvent {
+        LogEventType type;
+        uint8_t kind;      // Class id of the actor (its CharacterKind if built-in), selects the wording
+        uint8_t actor;     // Name handles
+        uint8_t target;
+        int32_t value;
+        int32_t aux;
+    };
+
+    // Append the text of an event for the view; false if it has none there
+    bool formatLogEvent(const LogEvent& event, LogView view, const string& actorName, const string& targetName,
+        string& out);
+} // namespace FantasyArena
+#endif // LOG_EVENT_H
@@ -0,0 +1,109 @@
+#include "MappedFile.h"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+using namespace std;
+namespace FantasyArena {
+#ifdef _WIN32
+    MappedFile::MappedFile() : data(nullptr), length(0), fileHandle(INVALID_HANDLE_VALUE), mappingHandle(nullptr) {
+    }
+
+    bool MappedFile::open(const string& path) {
+        close();
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+            CloseHandle(file);
+            return false;
+        }
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) {
+            CloseHandle(file);
+            return false;
+        }
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!view) {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+        fileHandle = file;
+        mappingHandle = mapping;
+        data = static_cast<const unsigned char*>(view);
+        length = static_cast<size_t>(fileSize.QuadPart);
+        return true;
+    }
+
+    void MappedFile::close() {
+        if (data) {
+            UnmapViewOfFile(data);
+            CloseHandle(static_cast<HANDLE>(mappingHandle));
+            CloseHandle(static_cast<HANDLE>(fileHandle));
+        }
+        data = nullptr;
+        length = 0;
+        fileHandle = INVALID_HANDLE_VALUE;
+        mappingHandle = nullptr;
+    }
+#else
+    MappedFile::MappedFile() : data(nullptr), length(0), fileDescriptor(-1) {
+    }
+
+    bool MappedFile::open(const string& path) {
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size == 0) {
+            ::close(fd);
+            return false;
+        }
+        void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        if (view == MAP_FAILED) {
+            ::close(fd);
+            return false;
+        }
+        fileDescriptor = fd;
+        data = static_cast<const unsigned char*>(view);
+        length = static_cast<size_t>(info.st_size);
+        return true;
+    }
+
+    void MappedFile::close() {
+        if (data) {
+            munmap(const_cast<unsigned char*>(data), length);
+            ::close(fileDescriptor);
+        }
+        data = nullptr;
+        length = 0;
+        fileDescriptor = -1;
+    }
+#endif
+
+    MappedFile::~MappedFile() {
+        close();
+    }
+
+    bool MappedFile::isOpen() const {
+        return data != nullptr;
+    }
+
+    const unsigned char* MappedFile::getData() const {
+        return data;
+    }
+
+    size_t MappedFile::size() const {
+        return length;
+    }
+} // namespace FantasyArena
@@ -0,0 +1,32 @@
+#pragma once
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+#include <string>
+#include <cstddef>
+using namespace std;
+namespace FantasyArena {
+    // Read-only memory mapping of a whole file (mmap on POSIX, file mapping on Windows)
+    class MappedFile {
+    private:
+        const unsigned char* data;
+        size_t length;
+#ifdef _WIN32
+        void* fileHandle;
+        void* mappingHandle;
+#else
+        int fileDescriptor;
+#endif
+    public:
+        MappedFile();
+        ~MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool open(const string& path);
+        void close();
+        bool isOpen() const;
+        const unsigned char* getData() const;
+        size_t size() const;
+    };
+} // namespace FantasyArena
+#endif // MAPPED_FILE_H
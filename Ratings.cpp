@@ -0,0 +1,378 @@
+#include "Ratings.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+using namespace std;
+namespace FantasyArena {
+    static const double RATING_Q = 0.0057565; // ln(10) / 400
+    static const double PI = 3.14159265358979323846;
+    static const double RATING_FIXED_POINT = 4294967296.0; // 2^32; a character can take 2^31 results per period
+    static const char RATINGS_MAGIC[4] = { 'F', 'A', 'R', 'R' };
+    static const uint32_t RATINGS_FORMAT_VERSION = 1;
+
+    struct RatingsFileHeader {
+        char magic[4];         // "FARR"
+        uint32_t version;
+        uint32_t count;        // CharacterRating records that follow
+        uint32_t period;
+        uint64_t fingerprint;  // Of the roster the ratings belong to
+    };
+    static_assert(sizeof(RatingsFileHeader) == 24, "RatingsFileHeader layout changed");
+
+    static uint32_t priorityOf(uint32_t id) {
+        // Fixed pseudo-random heap priorities keep the treap shape independent of the update order
+        uint32_t x = id * 0x9E3779B9u;
+        x ^= x >> 16;
+        x *= 0x85EBCA6Bu;
+        x ^= x >> 13;
+        x *= 0xC2B2AE35u;
+        return x ^ (x >> 16);
+    }
+
+    // RatingIndex implementation
+    RatingIndex::RatingIndex() : root(NONE) {
+    }
+
+    void RatingIndex::resize(size_t characterCount) {
+        left.assign(characterCount, NONE);
+        right.assign(characterCount, NONE);
+        subtreeSize.assign(characterCount, 0);
+        keys.assign(characterCount, 0.0);
+        root = NONE;
+    }
+
+    bool RatingIndex::before(uint32_t a, uint32_t b) const {
+        return keys[a] != keys[b] ? keys[a] > keys[b] : a < b;
+    }
+
+    void RatingIndex::update(uint32_t node) {
+        subtreeSize[node] = 1 + sizeOf(left[node]) + sizeOf(right[node]);
+    }
+
+    void RatingIndex::split(uint32_t node, uint32_t key, uint32_t& low, uint32_t& high) {
+        if (node == NONE) {
+            low = high = NONE;
+            return;
+        }
+        if (before(node, key)) {
+            split(right[node], key, right[node], high);
+            low = node;
+        }
+        else {
+            split(left[node], key, low, left[node]);
+            high = node;
+        }
+        update(node);
+    }
+
+    uint32_t RatingIndex::merge(uint32_t low, uint32_t high) {
+        if (low == NONE) {
+            return high;
+        }
+        if (high == NONE) {
+            return low;
+        }
+        if (priorityOf(low) > priorityOf(high)) {
+            right[low] = merge(right[low], high);
+            update(low);
+            return low;
+        }
+        left[high] = merge(low, left[high]);
+        update(high);
+        return high;
+    }
+
+    void RatingIndex::insert(uint32_t id, double rating) {
+        keys[id] = rating;
+        left[id] = right[id] = NONE;
+        subtreeSize[id] = 1;
+        uint32_t low;
+        uint32_t high;
+        split(root, id, low, high);
+        root = merge(merge(low, id), high);
+    }
+
+    uint32_t RatingIndex::eraseFrom(uint32_t node, uint32_t id) {
+        if (node == id) {
+            uint32_t joined = merge(left[id], right[id]);
+            left[id] = right[id] = NONE;
+            subtreeSize[id] = 0;
+            return joined;
+        }
+        if (before(id, node)) {
+            left[node] = eraseFrom(left[node], id);
+        }
+        else {
+            right[node] = eraseFrom(right[node], id);
+        }
+        update(node);
+        return node;
+    }
+
+    void RatingIndex::erase(uint32_t id) {
+        if (contains(id)) {
+            root = eraseFrom(root, id);
+        }
+    }
+
+    uint32_t RatingIndex::fillSizes(uint32_t node) {
+        if (node == NONE) {
+            return 0;
+        }
+        subtreeSize[node] = 1 + fillSizes(left[node]) + fillSizes(right[node]);
+        return subtreeSize[node];
+    }
+
+    void RatingIndex::build(vector<uint32_t>& ids, const vector<CharacterRating>& ratings) {
+        resize(ratings.size());
+        for (uint32_t id : ids) {
+            keys[id] = ratings[id].rating;
+        }
+        sort(ids.begin(), ids.end(), [this](uint32_t a, uint32_t b) { return before(a, b); });
+        // Cartesian tree of the sorted ids by priority, in one pass with a stack of the right spine
+        vector<uint32_t> spine;
+        for (uint32_t id : ids) {
+            uint32_t last = NONE;
+            while (!spine.empty() && priorityOf(spine.back()) < priorityOf(id)) {
+                last = spine.back();
+                spine.pop_back();
+            }
+            left[id] = last;
+            if (!spine.empty()) {
+                right[spine.back()] = id;
+            }
+            spine.push_back(id);
+        }
+        root = spine.empty() ? NONE : spine.front();
+        fillSizes(root);
+    }
+
+    size_t RatingIndex::rankOf(uint32_t id) const {
+        size_t rank = 0;
+        uint32_t node = root;
+        while (node != id) {
+            if (before(id, node)) {
+                node = left[node];
+            }
+            else {
+                rank += sizeOf(left[node]) + 1;
+                node = right[node];
+            }
+        }
+        return rank + sizeOf(left[id]);
+    }
+
+    uint32_t RatingIndex::select(size_t rank) const {
+        uint32_t node = root;
+        while (node != NONE) {
+            size_t leftSize = sizeOf(left[node]);
+            if (rank < leftSize) {
+                node = left[node];
+            }
+            else if (rank == leftSize) {
+                return node;
+            }
+            else {
+                rank -= leftSize + 1;
+                node = right[node];
+            }
+        }
+        return NONE;
+    }
+
+    size_t RatingIndex::countAbove(double rating) const {
+        size_t count = 0;
+        uint32_t node = root;
+        while (node != NONE) {
+            if (keys[node] > rating) {
+                count += sizeOf(left[node]) + 1;
+                node = right[node];
+            }
+            else {
+                node = left[node];
+            }
+        }
+        return count;
+    }
+
+    // RatingBatch implementation
+    static double ratingImpact(double deviation) {
+        return 1.0 / sqrt(1.0 + 3.0 * RATING_Q * RATING_Q * deviation * deviation / (PI * PI));
+    }
+
+    void RatingBatch::score(uint32_t player, uint32_t opponent, double result, const RatingTable& table) {
+        double g = ratingImpact(table.currentDeviation(opponent));
+        double expected = 1.0 / (1.0 + pow(10.0, -g * (table.getRating(player).rating - table.getRating(opponent).rating) / 400.0));
+        Sums& entry = sums[player];
+        entry.variance += llround(g * g * expected * (1.0 - expected) * RATING_FIXED_POINT);
+        entry.delta += llround(g * (result - expected) * RATING_FIXED_POINT);
+        entry.battles++;
+        entry.wins += result > 0.5 ? 1 : 0;
+    }
+
+    void RatingBatch::addResult(uint32_t winner, uint32_t loser, const RatingTable& table) {
+        score(winner, loser, 1.0, table);
+        score(loser, winner, 0.0, table);
+    }
+
+    // RatingTable implementation
+    RatingTable::RatingTable() : period(0) {
+    }
+
+    void RatingTable::reset(size_t characterCount) {
+        ratings.assign(characterCount, { RATING_INITIAL, RATING_INITIAL_DEVIATION, 0, 0, 0, 0 });
+        index.resize(characterCount);
+        period = 0;
+        pending.assign(characterCount, RatingBatch::Sums());
+        pendingIds.clear();
+    }
+
+    double RatingTable::currentDeviation(uint32_t id) const {
+        const CharacterRating& entry = ratings[id];
+        if (entry.battles == 0) {
+            return RATING_INITIAL_DEVIATION;
+        }
+        double idle = static_cast<double>(period - entry.lastPeriod);
+        return min(sqrt(entry.deviation * entry.deviation + RATING_DEVIATION_GROWTH * RATING_DEVIATION_GROWTH * idle),
+            RATING_INITIAL_DEVIATION);
+    }
+
+    void RatingTable::submit(const RatingBatch& batch) {
+        lock_guard<mutex> lock(pendingLock);
+        for (const auto& entry : batch.sums) {
+            RatingBatch::Sums& total = pending[entry.first];
+            if (total.battles == 0) {
+                pendingIds.push_back(entry.first);
+            }
+            total.variance += entry.second.variance;
+            total.delta += entry.second.delta;
+            total.battles += entry.second.battles;
+            total.wins += entry.second.wins;
+        }
+    }
+
+    void RatingTable::closePeriod() {
+        // The opponents' ratings are already in the sums, so each character
+        // is updated from its own entry alone
+        // Past a quarter of the index, one rebuild beats moving every character
+        bool rebuild = pendingIds.size() * 4 > index.size();
+        for (uint32_t id : pendingIds) {
+            RatingBatch::Sums& sums = pending[id];
+            double deviation = currentDeviation(id);
+            CharacterRating& entry = ratings[id];
+            double inverseD2 = RATING_Q * RATING_Q * (sums.variance / RATING_FIXED_POINT);
+            double precision = 1.0 / (deviation * deviation) + inverseD2;
+            entry.rating += RATING_Q / precision * (sums.delta / RATING_FIXED_POINT);
+            entry.deviation = max(sqrt(1.0 / precision), RATING_MIN_DEVIATION);
+            entry.battles += sums.battles;
+            entry.wins += sums.wins;
+            entry.lastPeriod = period;
+            sums = RatingBatch::Sums();
+            if (!rebuild) {
+                index.erase(id);
+                index.insert(id, entry.rating);
+            }
+        }
+        if (rebuild) {
+            vector<uint32_t> rated;
+            for (uint32_t id = 0; id < ratings.size(); ++id) {
+                if (ratings[id].battles > 0) {
+                    rated.push_back(id);
+                }
+            }
+            index.build(rated, ratings);
+        }
+        pendingIds.clear();
+        period++;
+    }
+
+    void RatingTable::recordBattle(uint32_t winner, uint32_t loser) {
+        RatingBatch batch;
+        batch.addResult(winner, loser, *this);
+        submit(batch);
+        closePeriod();
+    }
+
+    void RatingTable::getTop(size_t count, vector<uint32_t>& ids) const {
+        ids.clear();
+        for (size_t rank = 0; rank < count && rank < index.size(); ++rank) {
+            ids.push_back(index.select(rank));
+        }
+    }
+
+    void RatingTable::getNear(double rating, size_t count, vector<uint32_t>& ids) const {
+        ids.clear();
+        size_t position = index.countAbove(rating);
+        size_t first = position > count ? position - count : 0;
+        size_t last = min(position + count, index.size());
+        for (size_t rank = first; rank < last; ++rank) {
+            ids.push_back(index.select(rank));
+        }
+    }
+
+    bool RatingTable::save(const string& path, uint64_t rosterFingerprint) const {
+        RatingsFileHeader header;
+        memcpy(header.magic, RATINGS_MAGIC, sizeof(RATINGS_MAGIC));
+        header.version = RATINGS_FORMAT_VERSION;
+        header.count = static_cast<uint32_t>(ratings.size());
+        header.period = period;
+        header.fingerprint = rosterFingerprint;
+        // A complete new file replaces the old one, so a failed write never loses the ratings
+        string temporaryPath = path + ".tmp";
+        {
+            ofstream out(temporaryPath, ios::binary | ios::trunc);
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(ratings.data()), static_cast<streamsize>(ratings.size() * sizeof(CharacterRating)));
+            if (!out.good()) {
+                out.close();
+                std::remove(temporaryPath.c_str());
+                return false;
+            }
+        }
+#ifdef _WIN32
+        bool renamed = MoveFileExA(temporaryPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+        bool renamed = rename(temporaryPath.c_str(), path.c_str()) == 0;
+#endif
+        if (!renamed) {
+            std::remove(temporaryPath.c_str());
+        }
+        return renamed;
+    }
+
+    bool RatingTable::load(const string& path, uint64_t rosterFingerprint) {
+        ifstream in(path, ios::binary);
+        RatingsFileHeader header;
+        if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+            memcmp(header.magic, RATINGS_MAGIC, sizeof(RATINGS_MAGIC)) != 0 || header.version != RATINGS_FORMAT_VERSION ||
+            header.count != ratings.size() || header.fingerprint != rosterFingerprint) {
+            return false;
+        }
+        vector<CharacterRating> loaded(header.count);
+        if (!in.read(reinterpret_cast<char*>(loaded.data()), static_cast<streamsize>(loaded.size() * sizeof(CharacterRating)))) {
+            return false;
+        }
+        for (const CharacterRating& entry : loaded) {
+            if (!isfinite(entry.rating) || !(entry.deviation > 0.0) || entry.lastPeriod > header.period) {
+                return false;
+            }
+        }
+        ratings.swap(loaded);
+        period = header.period;
+        pending.assign(ratings.size(), RatingBatch::Sums());
+        pendingIds.clear();
+        vector<uint32_t> rated;
+        for (uint32_t id = 0; id < ratings.size(); ++id) {
+            if (ratings[id].battles > 0) {
+                rated.push_back(id);
+            }
+        }
+        index.build(rated, ratings);
+        return true;
+    }
+} // namespace FantasyArena
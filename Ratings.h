@@ -0,0 +1,128 @@
+#pragma once
+#ifndef RATINGS_H
+#define RATINGS_H
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+using namespace std;
+namespace FantasyArena {
+    // Glicko-1: every character has a rating and a rating deviation (RD),
+    // the uncertainty of the rating. Results are rated in periods; within a
+    // period every result is scored against the ratings at its start.
+    const double RATING_INITIAL = 1500.0;
+    const double RATING_INITIAL_DEVIATION = 350.0;
+    const double RATING_MIN_DEVIATION = 30.0;
+    const double RATING_DEVIATION_GROWTH = 34.6; // Per idle period: RD 50 is back to 350 after 100 periods
+
+    struct CharacterRating {
+        double rating;
+        double deviation; // At the end of the character's last rated period
+        uint32_t battles;
+        uint32_t wins;
+        uint32_t lastPeriod;
+        uint32_t reserved;
+    };
+    static_assert(sizeof(CharacterRating) == 32, "CharacterRating layout changed");
+
+    // Order-statistic treap over the rated characters, highest rating first
+    // (ties by id). Node i is character i, so the arrays are allocated once and
+    // every operation is O(log n) expected: insert, erase, rank, select, and
+    // the position of a rating.
+    class RatingIndex {
+    private:
+        static constexpr uint32_t NONE = 0xFFFFFFFFu;
+        vector<uint32_t> left;
+        vector<uint32_t> right;
+        vector<uint32_t> subtreeSize; // 0 = not in the index
+        vector<double> keys;
+        uint32_t root;
+
+        bool before(uint32_t a, uint32_t b) const; // a ranks above b
+        uint32_t sizeOf(uint32_t node) const { return node == NONE ? 0 : subtreeSize[node]; }
+        void update(uint32_t node);
+        void split(uint32_t node, uint32_t key, uint32_t& low, uint32_t& high); // low: nodes before key
+        uint32_t merge(uint32_t low, uint32_t high);
+        uint32_t eraseFrom(uint32_t node, uint32_t id);
+        uint32_t fillSizes(uint32_t node);
+    public:
+        RatingIndex();
+        void resize(size_t characterCount); // Empties the index
+        size_t size() const { return sizeOf(root); }
+        bool contains(uint32_t id) const { return subtreeSize[id] != 0; }
+        void insert(uint32_t id, double rating);
+        void erase(uint32_t id);
+        // Replace the contents with these characters in O(n log n), cheaper
+        // than moving a large share of them one by one
+        void build(vector<uint32_t>& ids, const vector<CharacterRating>& ratings);
+        size_t rankOf(uint32_t id) const;  // 0-based; the character must be in the index
+        uint32_t select(size_t rank) const; // Character at a 0-based rank
+        size_t countAbove(double rating) const; // Characters rated strictly higher
+    };
+
+    class RatingTable;
+
+    // Results collected by one worker without taking any lock. Each result is
+    // scored as it is added, against the ratings at the start of the period,
+    // into per-character sums kept in fixed point: adding the batches of
+    // several workers in any order then gives exactly the same ratings.
+    class RatingBatch {
+    private:
+        friend class RatingTable;
+        struct Sums {
+            int64_t variance; // Sum of g^2 E (1 - E), in units of 2^-32
+            int64_t delta;    // Sum of g (s - E), likewise
+            uint32_t battles;
+            uint32_t wins;
+        };
+        unordered_map<uint32_t, Sums> sums;
+        void score(uint32_t player, uint32_t opponent, double result, const RatingTable& table);
+    public:
+        void addResult(uint32_t winner, uint32_t loser, const RatingTable& table);
+        bool empty() const { return sums.empty(); }
+        void clear() { sums.clear(); }
+    };
+
+    // Ratings by roster position. submit() may be called from many threads at
+    // once and holds the lock only to add a batch's sums; closePeriod() then
+    // updates the ratings and the index and must not overlap anything else.
+    class RatingTable {
+    private:
+        vector<CharacterRating> ratings;
+        RatingIndex index;
+        uint32_t period; // Periods closed so far
+        mutex pendingLock;
+        vector<RatingBatch::Sums> pending; // By character
+        vector<uint32_t> pendingIds;       // Characters with pending sums
+    public:
+        RatingTable();
+        RatingTable(const RatingTable&) = delete;
+        RatingTable& operator=(const RatingTable&) = delete;
+
+        void reset(size_t characterCount); // Everyone unrated
+        size_t size() const { return ratings.size(); }
+        const CharacterRating& getRating(uint32_t id) const { return ratings[id]; }
+        // RD at the start of the current period, grown for the idle periods
+        double currentDeviation(uint32_t id) const;
+
+        void submit(const RatingBatch& batch);
+        void closePeriod();
+        // A single battle as its own period
+        void recordBattle(uint32_t winner, uint32_t loser);
+
+        // Leaderboard queries over the characters with at least one battle
+        size_t getRatedCount() const { return index.size(); }
+        bool isRated(uint32_t id) const { return ratings[id].battles > 0; }
+        size_t getRank(uint32_t id) const { return index.rankOf(id); } // 0-based, rated characters only
+        void getTop(size_t count, vector<uint32_t>& ids) const;
+        // Up to `count` characters on each side of a rating, best first
+        void getNear(double rating, size_t count, vector<uint32_t>& ids) const;
+
+        // The file records a fingerprint of the roster; loading fails for
+        // another roster or a damaged file and leaves the table unchanged
+        bool save(const string& path, uint64_t rosterFingerprint) const;
+        bool load(const string& path, uint64_t rosterFingerprint);
+    };
+} // namespace FantasyArena
+#endif // RATINGS_H
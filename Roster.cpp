@@ -0,0 +1,516 @@
+#include "Roster.h"
+#include "MappedFile.h"
+#include "StatTables.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cctype>
+using namespace std;
+namespace FantasyArena {
+    namespace {
+        char fold(char c) {
+            return static_cast<char>(tolower(static_cast<unsigned char>(c)));
+        }
+
+        string foldName(const string& name) {
+            string folded(name);
+            for (char& c : folded) {
+                c = fold(c);
+            }
+            return folded;
+        }
+
+        bool startsWithFolded(const string& text, const char* prefix) {
+            size_t length = strlen(prefix);
+            return text.size() >= length && foldName(text.substr(0, length)) == prefix;
+        }
+
+        // A field of a line, without its quotes; `quoted` fields may hold ""
+        struct Field {
+            const char* begin;
+            size_t length;
+            bool quoted;
+        };
+
+        bool isBlank(char c) {
+            return c == ' ' || c == '\t';
+        }
+
+        // Split "a, b ,\"c, d\"" into at most `capacity` fields; false if a
+        // quote is not closed or there are more fields
+        bool splitLine(const char* begin, const char* end, Field* fields, size_t capacity, size_t& count) {
+            count = 0;
+            const char* p = begin;
+            for (;;) {
+                while (p < end && isBlank(*p)) {
+                    ++p;
+                }
+                if (count == capacity) {
+                    return false;
+                }
+                Field& field = fields[count++];
+                field.quoted = p < end && *p == '"';
+                if (field.quoted) {
+                    field.begin = ++p;
+                    while (p < end && !(*p == '"' && (p + 1 == end || p[1] != '"'))) {
+                        p += *p == '"' ? 2 : 1;
+                    }
+                    if (p == end) {
+                        return false;
+                    }
+                    field.length = static_cast<size_t>(p - field.begin);
+                    ++p;
+                    while (p < end && isBlank(*p)) {
+                        ++p;
+                    }
+                    if (p < end && *p != ',') {
+                        return false;
+                    }
+                }
+                else {
+                    field.begin = p;
+                    while (p < end && *p != ',') {
+                        ++p;
+                    }
+                    const char* fieldEnd = p;
+                    while (fieldEnd > field.begin && isBlank(fieldEnd[-1])) {
+                        --fieldEnd;
+                    }
+                    field.length = static_cast<size_t>(fieldEnd - field.begin);
+                }
+                if (p == end) {
+                    return true;
+                }
+                ++p; // Comma
+            }
+        }
+
+        bool fieldEquals(const Field& field, const char* text) {
+            size_t length = strlen(text);
+            if (field.length != length) {
+                return false;
+            }
+            for (size_t i = 0; i < length; ++i) {
+                if (fold(field.begin[i]) != text[i]) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Whether the folded `wanted` is the start of a class name, which may
+        // itself contain spaces or underscores ("Storm Caller")
+        bool classNamePrefix(const char* name, const char* wanted, size_t wantedLength, bool& exact) {
+            size_t matched = 0;
+            for (; *name; ++name) {
+                if (*name == ' ' || *name == '_') {
+                    continue;
+                }
+                if (matched == wantedLength) {
+                    exact = false;
+                    return true;
+                }
+                if (fold(*name) != wanted[matched++]) {
+                    return false;
+                }
+            }
+            exact = true;
+            return matched == wantedLength;
+        }
+
+        const char* classNameFor(int classId) {
+            return classId < CHARACTER_KIND_COUNT ? CLASS_STATS[classId].className
+                : getCustomClass(classId).className.c_str();
+        }
+
+        bool parseClassId(const char* text, size_t length, int& classId) {
+            char wanted[32];
+            size_t wantedLength = 0;
+            for (size_t i = 0; i < length; ++i) {
+                if (text[i] == ' ' || text[i] == '_') {
+                    continue;
+                }
+                if (wantedLength == sizeof(wanted)) {
+                    return false;
+                }
+                wanted[wantedLength++] = fold(text[i]);
+            }
+            if (wantedLength == 0) {
+                return false;
+            }
+            int match = -1;
+            bool ambiguous = false;
+            int classCount = getClassCount();
+            for (int id = 0; id < classCount; ++id) {
+                bool exact;
+                if (!classNamePrefix(classNameFor(id), wanted, wantedLength, exact)) {
+                    continue;
+                }
+                if (exact) {
+                    classId = id;
+                    return true;
+                }
+                ambiguous = match >= 0; // e.g. "m"; an exact name later still wins
+                match = id;
+            }
+            if (match < 0 || ambiguous) {
+                return false;
+            }
+            classId = match;
+            return true;
+        }
+
+        bool parseLevel(const char* text, size_t length, int& level) {
+            if (length == 0 || length > 3) {
+                return false;
+            }
+            level = 0;
+            for (size_t i = 0; i < length; ++i) {
+                if (text[i] < '0' || text[i] > '9') {
+                    return false;
+                }
+                level = level * 10 + (text[i] - '0');
+            }
+            return level >= 1 && level <= ROSTER_MAX_LEVEL;
+        }
+
+        // Reads one line into a new character; the reason is set on failure
+        Character* parseRosterLine(const char* begin, const char* end, bool& header, const char*& reason) {
+            Field fields[3];
+            size_t count;
+            header = false;
+            if (!splitLine(begin, end, fields, 3, count) || count != 3) {
+                reason = "expected name,class,level";
+                return nullptr;
+            }
+            if (fieldEquals(fields[0], "name") && fieldEquals(fields[1], "class") && fieldEquals(fields[2], "level")) {
+                header = true;
+                return nullptr;
+            }
+            int classId;
+            if (!parseClassId(fields[1].begin, fields[1].length, classId)) {
+                reason = "unknown class";
+                return nullptr;
+            }
+            int level;
+            if (!parseLevel(fields[2].begin, fields[2].length, level)) {
+                reason = "level must be 1-100";
+                return nullptr;
+            }
+            string name;
+            if (fields[0].quoted) {
+                name.reserve(fields[0].length);
+                for (size_t i = 0; i < fields[0].length; ++i) {
+                    name += fields[0].begin[i];
+                    if (fields[0].begin[i] == '"') {
+                        ++i; // Second quote of ""
+                    }
+                }
+            }
+            else {
+                name.assign(fields[0].begin, fields[0].length);
+            }
+            if (name.empty() || name.size() > ROSTER_MAX_NAME_LENGTH) {
+                reason = "name must be 1-64 characters";
+                return nullptr;
+            }
+            return createCharacterOfClass(classId, name, level);
+        }
+    }
+
+    bool importRoster(const string& path, vector<Character*>& roster, RosterImportResult& result) {
+        auto start = chrono::steady_clock::now();
+        result.lines = 0;
+        result.imported = 0;
+        result.skipped = 0;
+        result.errors.clear();
+        result.seconds = 0.0;
+        MappedFile file;
+        if (!file.open(path)) {
+            return false;
+        }
+        const char* data = reinterpret_cast<const char*>(file.getData());
+        const char* end = data + file.size();
+        roster.reserve(roster.size() + static_cast<size_t>(count(data, end, '\n')) + 1);
+        for (const char* line = data; line < end;) {
+            const char* lineEnd = static_cast<const char*>(memchr(line, '\n', static_cast<size_t>(end - line)));
+            const char* next = lineEnd ? lineEnd + 1 : end;
+            if (!lineEnd) {
+                lineEnd = end;
+            }
+            if (lineEnd > line && lineEnd[-1] == '\r') {
+                --lineEnd;
+            }
+            ++result.lines;
+            const char* first = line;
+            while (first < lineEnd && isBlank(*first)) {
+                ++first;
+            }
+            if (first < lineEnd && *first != '#') {
+                bool header;
+                const char* reason = nullptr;
+                Character* character = parseRosterLine(first, lineEnd, header, reason);
+                if (character) {
+                    roster.push_back(character);
+                    ++result.imported;
+                }
+                else if (!header) {
+                    ++result.skipped;
+                    if (result.errors.size() < ROSTER_ERRORS_KEPT) {
+                        result.errors.push_back("line " + to_string(result.lines) + ": " + reason);
+                    }
+                }
+            }
+            line = next;
+        }
+        result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        return true;
+    }
+
+    bool parseClassName(const string& text, int& classId) {
+        return parseClassId(text.data(), text.size(), classId);
+    }
+
+    RosterQuery anyCharacterQuery() {
+        RosterQuery query;
+        query.classId = -1;
+        query.minLevel = 1;
+        query.maxLevel = ROSTER_MAX_LEVEL;
+        return query;
+    }
+
+    bool parseRosterQuery(const string& text, RosterQuery& query, string& error) {
+        query = anyCharacterQuery();
+        size_t position = 0;
+        while (position < text.size()) {
+            size_t begin = text.find_first_not_of(" \t", position);
+            if (begin == string::npos) {
+                break;
+            }
+            size_t end = text.find_first_of(" \t", begin);
+            if (end == string::npos) {
+                end = text.size();
+            }
+            string word = text.substr(begin, end - begin);
+            position = end;
+            if (startsWithFolded(word, "class:") && word.size() > 6) {
+                if (!parseClassName(word.substr(6), query.classId)) {
+                    error = "Unknown class " + word.substr(6);
+                    return false;
+                }
+            }
+            else if (startsWithFolded(word, "level:") && word.size() > 6) {
+                string range = word.substr(6);
+                size_t dash = range.find('-');
+                int low;
+                int high;
+                if (!parseLevel(range.data(), dash == string::npos ? range.size() : dash, low) ||
+                    !parseLevel(range.data() + (dash == string::npos ? 0 : dash + 1),
+                        dash == string::npos ? range.size() : range.size() - dash - 1, high) || low > high) {
+                    error = "Levels are level:N or level:N-M with 1 <= N <= M <= " + to_string(ROSTER_MAX_LEVEL);
+                    return false;
+                }
+                query.minLevel = low;
+                query.maxLevel = high;
+            }
+            else {
+                // Names may contain spaces
+                if (!query.namePrefix.empty()) {
+                    query.namePrefix += ' ';
+                }
+                query.namePrefix += word;
+            }
+        }
+        return true;
+    }
+
+    RosterIndex::RosterIndex() {
+        data = RosterIndexData();
+    }
+
+    void RosterIndex::build(const vector<Character*>& characters) {
+        uint32_t count = static_cast<uint32_t>(characters.size());
+        ownedLevels.resize(count);
+        ownedKinds.resize(count);
+        ownedByName.resize(count);
+        ownedByLevel.resize(count);
+        ownedByClass.resize(count);
+        int classCount = getClassCount();
+        ownedClassStart.assign(classCount + 1, 0);
+        for (uint32_t i = 0; i < count; ++i) {
+            // Out of range levels (never from importRoster) sort after the highest
+            ownedLevels[i] = static_cast<uint8_t>(min(max(characters[i]->getLevel(), 0), ROSTER_MAX_LEVEL + 1));
+            ownedKinds[i] = static_cast<uint8_t>(characters[i]->getClassId());
+            ownedByName[i] = i;
+        }
+        // Fold every name once; comparing through the characters costs a
+        // cache miss and a tolower per character on each of the n log n steps
+        vector<string> folded(count);
+        size_t textSize = 0;
+        for (uint32_t i = 0; i < count; ++i) {
+            folded[i] = foldName(characters[i]->getName());
+            textSize += folded[i].size();
+        }
+        sort(ownedByName.begin(), ownedByName.end(), [&folded](uint32_t a, uint32_t b) {
+            int order = folded[a].compare(folded[b]);
+            return order != 0 ? order < 0 : a < b;
+        });
+        ownedNameOffsets.resize(count + 1);
+        ownedNameText.clear();
+        ownedNameText.reserve(textSize);
+        for (uint32_t i = 0; i < count; ++i) {
+            ownedNameOffsets[i] = static_cast<uint32_t>(ownedNameText.size());
+            ownedNameText += folded[ownedByName[i]];
+        }
+        ownedNameOffsets[count] = static_cast<uint32_t>(ownedNameText.size());
+        // Levels are small integers: a stable counting pass keeps roster order within a level
+        vector<uint32_t> levelStart(ROSTER_MAX_LEVEL + 2, 0);
+        for (uint8_t level : ownedLevels) {
+            ++levelStart[level];
+        }
+        uint32_t total = 0;
+        for (uint32_t& start : levelStart) {
+            uint32_t levelCount = start;
+            start = total;
+            total += levelCount;
+        }
+        for (uint32_t i = 0; i < count; ++i) {
+            ownedByLevel[levelStart[ownedLevels[i]]++] = i;
+        }
+        // Class groups in level order: a stable split of byLevel
+        for (uint8_t kind : ownedKinds) {
+            ++ownedClassStart[kind + 1];
+        }
+        for (int k = 0; k < classCount; ++k) {
+            ownedClassStart[k + 1] += ownedClassStart[k];
+        }
+        vector<uint32_t> classNext(ownedClassStart.begin(), ownedClassStart.end() - 1);
+        for (uint32_t i : ownedByLevel) {
+            ownedByClass[classNext[ownedKinds[i]]++] = i;
+        }
+
+        data.count = count;
+        data.classCount = static_cast<uint32_t>(classCount);
+        data.levels = ownedLevels.data();
+        data.kinds = ownedKinds.data();
+        data.byName = ownedByName.data();
+        data.byLevel = ownedByLevel.data();
+        data.byClass = ownedByClass.data();
+        data.classStart = ownedClassStart.data();
+        data.nameOffsets = ownedNameOffsets.data();
+        data.nameText = ownedNameText.data();
+    }
+
+    void RosterIndex::attach(const RosterIndexData& mapped) {
+        ownedLevels.clear();
+        ownedKinds.clear();
+        ownedByName.clear();
+        ownedByLevel.clear();
+        ownedByClass.clear();
+        ownedClassStart.clear();
+        ownedNameOffsets.clear();
+        ownedNameText.clear();
+        data = mapped;
+    }
+
+    int RosterIndex::compareName(size_t position, const string& key, bool prefixOnly) const {
+        const char* name = data.nameText + data.nameOffsets[position];
+        size_t length = data.nameOffsets[position + 1] - data.nameOffsets[position];
+        if (prefixOnly && length > key.size()) {
+            length = key.size();
+        }
+        int order = memcmp(name, key.data(), min(length, key.size()));
+        if (order != 0) {
+            return order;
+        }
+        return length < key.size() ? -1 : (length > key.size() ? 1 : 0);
+    }
+
+    size_t RosterIndex::firstName(const string& key) const {
+        size_t first = 0;
+        size_t count = data.count;
+        while (count > 0) {
+            size_t half = count / 2;
+            if (compareName(first + half, key, false) < 0) {
+                first += half + 1;
+                count -= half + 1;
+            }
+            else {
+                count = half;
+            }
+        }
+        return first;
+    }
+
+    void RosterIndex::levelRange(const uint32_t* list, size_t size, int minLevel, int maxLevel,
+        size_t& first, size_t& last) const {
+        first = static_cast<size_t>(partition_point(list, list + size, [&](uint32_t i) {
+            return data.levels[i] < minLevel;
+        }) - list);
+        last = static_cast<size_t>(partition_point(list + first, list + size, [&](uint32_t i) {
+            return data.levels[i] <= maxLevel;
+        }) - list);
+    }
+
+    long RosterIndex::findByName(const string& name) const {
+        if (data.count == 0 || name.empty()) {
+            return -1;
+        }
+        string key = foldName(name);
+        size_t found = firstName(key);
+        if (found == data.count || compareName(found, key, false) != 0) {
+            return -1;
+        }
+        return static_cast<long>(data.byName[found]);
+    }
+
+    void RosterIndex::search(const RosterQuery& query, vector<uint32_t>& results) const {
+        results.clear();
+        if (data.count == 0) {
+            return;
+        }
+        size_t first;
+        size_t last;
+        if (!query.namePrefix.empty()) {
+            string key = foldName(query.namePrefix);
+            first = firstName(key);
+            for (size_t i = first; i < data.count && compareName(i, key, true) == 0; ++i) {
+                uint32_t position = data.byName[i];
+                if ((query.classId < 0 || data.kinds[position] == query.classId) &&
+                    data.levels[position] >= query.minLevel && data.levels[position] <= query.maxLevel) {
+                    results.push_back(position);
+                }
+            }
+            return;
+        }
+        const uint32_t* list = data.byLevel;
+        size_t size = data.count;
+        if (query.classId >= static_cast<int>(data.classCount)) {
+            results.clear(); // A class nobody in this roster can have
+            return;
+        }
+        if (query.classId >= 0) {
+            list = data.byClass + data.classStart[query.classId];
+            size = data.classStart[query.classId + 1] - data.classStart[query.classId];
+        }
+        levelRange(list, size, query.minLevel, query.maxLevel, first, last);
+        results.assign(list + first, list + last);
+    }
+
+    uint64_t fingerprintRoster(const RosterIndexData& data) {
+        // FNV-1a over the index arrays, which hold everything by position
+        uint64_t hash = 0xCBF29CE484222325ull;
+        auto add = [&hash](const void* bytes, size_t size) {
+            const unsigned char* p = static_cast<const unsigned char*>(bytes);
+            for (size_t i = 0; i < size; ++i) {
+                hash = (hash ^ p[i]) * 0x100000001B3ull;
+            }
+        };
+        add(&data.count, sizeof(data.count));
+        add(data.levels, data.count);
+        add(data.kinds, data.count);
+        add(data.byName, data.count * sizeof(uint32_t));
+        add(data.nameText, data.nameOffsets[data.count]);
+        return hash;
+    }
+} // namespace FantasyArena
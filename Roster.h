@@ -0,0 +1,101 @@
+#pragma once
+#ifndef ROSTER_H
+#define ROSTER_H
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "Character.h"
+using namespace std;
+namespace FantasyArena {
+    const int ROSTER_MAX_LEVEL = 100;
+    const size_t ROSTER_MAX_NAME_LENGTH = 64;
+    const size_t ROSTER_ERRORS_KEPT = 10; // Bad lines reported in detail
+
+    struct RosterImportResult {
+        size_t lines;
+        size_t imported;
+        size_t skipped;        // Malformed lines, reported in errors
+        vector<string> errors; // "line N: reason" for the first ROSTER_ERRORS_KEPT skipped lines
+        double seconds;
+    };
+
+    // Append the characters of a roster file to `roster`; the caller owns them.
+    // One "name,class,level" line per character, e.g. "Aragorn,Warrior,5".
+    // Names may be quoted ("Smith, John") with "" for a quote; blank lines,
+    // lines starting with '#' and a "name,class,level" header are ignored.
+    // The file is read in one pass over a memory mapping, so no line is
+    // copied and a bad line only skips that line.
+    // False if the file cannot be read.
+    bool importRoster(const string& path, vector<Character*>& roster, RosterImportResult& result);
+
+    // Class id (ClassDefinitions.h) from a built-in or loaded class name or an
+    // unambiguous prefix, ignoring case, spaces and underscores ("war",
+    // "Mirror Striker")
+    bool parseClassName(const string& text, int& classId);
+
+    struct RosterQuery {
+        string namePrefix; // Case-insensitive, empty = any name
+        int classId;       // -1 = any class
+        int minLevel;
+        int maxLevel;
+    };
+
+    RosterQuery anyCharacterQuery();
+    // "Ara class:warrior level:3-6": words are the name prefix, plus
+    // optional class:C and level:N or level:N-M filters
+    bool parseRosterQuery(const string& text, RosterQuery& query, string& error);
+
+    // The flat arrays behind a RosterIndex, so an index can be served from
+    // memory or straight from a mapped roster image (RosterImage.h)
+    struct RosterIndexData {
+        uint32_t count;
+        uint32_t classCount;         // Class ids covered by classStart
+        const uint8_t* levels;       // By roster position
+        const uint8_t* kinds;        // Class id by roster position
+        const uint32_t* byName;      // Case-insensitive name order, then roster order
+        const uint32_t* byLevel;     // Level order, then roster order
+        const uint32_t* byClass;     // Grouped by class, each group in level order
+        const uint32_t* classStart;  // classCount + 1 group boundaries in byClass
+        const uint32_t* nameOffsets; // count + 1 offsets into nameText, in byName order
+        const char* nameText;        // Lower-case names back to back
+    };
+
+    // Sorted views of a roster for lookups by name, name prefix, class and
+    // level range. Indexes are roster positions; rebuild after the roster changes.
+    class RosterIndex {
+    private:
+        vector<uint8_t> ownedLevels;
+        vector<uint8_t> ownedKinds;
+        vector<uint32_t> ownedByName;
+        vector<uint32_t> ownedByLevel;
+        vector<uint32_t> ownedByClass;
+        vector<uint32_t> ownedClassStart;
+        vector<uint32_t> ownedNameOffsets;
+        string ownedNameText;
+        RosterIndexData data; // Owned vectors or attached arrays
+
+        int compareName(size_t position, const string& key, bool prefixOnly) const; // position in byName order
+        size_t firstName(const string& key) const;
+        void levelRange(const uint32_t* list, size_t size, int minLevel, int maxLevel, size_t& first, size_t& last) const;
+    public:
+        RosterIndex();
+        RosterIndex(const RosterIndex&) = delete;
+        RosterIndex& operator=(const RosterIndex&) = delete;
+
+        void build(const vector<Character*>& roster);
+        // Serve lookups from arrays owned by someone else, e.g. a mapped image
+        void attach(const RosterIndexData& mapped);
+        const RosterIndexData& getData() const { return data; }
+        size_t size() const { return data.count; }
+
+        // First roster position with exactly this name (ignoring case), or -1
+        long findByName(const string& name) const;
+        // Roster positions matching the query: by name when a prefix is given, else by level
+        void search(const RosterQuery& query, vector<uint32_t>& results) const;
+    };
+
+    // Hash of the names, classes and levels by roster position, to tell
+    // whether data saved by position (e.g. ratings) belongs to this roster
+    uint64_t fingerprintRoster(const RosterIndexData& data);
+} // namespace FantasyArena
+#endif // ROSTER_H
@@ -0,0 +1,228 @@
+#include "RosterImage.h"
+#include "StatTables.h"
+#include <fstream>
+#include <cstring>
+using namespace std;
+namespace FantasyArena {
+    static const char ROSTER_IMAGE_MAGIC[4] = { 'F', 'A', 'R', 'I' };
+
+    // File offsets of the sections for the counts in a header
+    struct RosterImageLayout {
+        uint64_t characters;
+        uint64_t arenas;
+        uint64_t levels;
+        uint64_t kinds;
+        uint64_t byName;
+        uint64_t byLevel;
+        uint64_t byClass;
+        uint64_t classStart;
+        uint64_t nameOffsets;
+        uint64_t nameText;
+        uint64_t end;
+    };
+
+    static uint64_t padded(uint64_t bytes) {
+        return (bytes + 3) & ~static_cast<uint64_t>(3);
+    }
+
+    static RosterImageLayout layoutFor(uint64_t characterCount, uint64_t arenaCount, uint64_t nameTextSize) {
+        RosterImageLayout layout;
+        layout.characters = sizeof(RosterImageHeader);
+        layout.arenas = layout.characters + characterCount * sizeof(RosterImageCharacter);
+        layout.levels = layout.arenas + arenaCount * sizeof(RosterImageArena);
+        layout.kinds = layout.levels + padded(characterCount);
+        layout.byName = layout.kinds + padded(characterCount);
+        layout.byLevel = layout.byName + characterCount * sizeof(uint32_t);
+        layout.byClass = layout.byLevel + characterCount * sizeof(uint32_t);
+        layout.classStart = layout.byClass + characterCount * sizeof(uint32_t);
+        layout.nameOffsets = layout.classStart + (CHARACTER_KIND_COUNT + 1) * sizeof(uint32_t);
+        layout.nameText = layout.nameOffsets + (characterCount + 1) * sizeof(uint32_t);
+        layout.end = layout.nameText + nameTextSize;
+        return layout;
+    }
+
+    template <typename T>
+    static void writeSection(ofstream& out, const T* values, uint64_t count) {
+        out.write(reinterpret_cast<const char*>(values), static_cast<streamsize>(count * sizeof(T)));
+    }
+
+    // The index arrays must keep every lookup inside the mapping: positions
+    // below the count, and offsets and class boundaries that never go back
+    static bool isValidIndex(const RosterIndexData& index, uint32_t nameTextSize) {
+        if (index.nameOffsets[0] != 0 || index.nameOffsets[index.count] != nameTextSize ||
+            index.classStart[0] != 0 || index.classStart[index.classCount] != index.count) {
+            return false;
+        }
+        for (uint32_t i = 0; i < index.classCount; ++i) {
+            if (index.classStart[i] > index.classStart[i + 1]) {
+                return false;
+            }
+        }
+        for (uint32_t i = 0; i < index.count; ++i) {
+            if (index.nameOffsets[i] > index.nameOffsets[i + 1] || index.byName[i] >= index.count ||
+                index.byLevel[i] >= index.count || index.byClass[i] >= index.count || index.kinds[i] >= index.classCount) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static void writePadding(ofstream& out, uint64_t bytes) {
+        static const char zeros[4] = { 0, 0, 0, 0 };
+        out.write(zeros, static_cast<streamsize>(padded(bytes) - bytes));
+    }
+
+    bool writeRosterImage(const string& path, const vector<Character*>& roster, const vector<Arena>& arenas,
+        string& error) {
+        vector<RosterImageCharacter> characterRecords(roster.size());
+        for (size_t i = 0; i < roster.size(); ++i) {
+            const Character& character = *roster[i];
+            if (character.getLevel() < 1 || character.getLevel() > ROSTER_MAX_LEVEL) {
+                error = character.getName() + ": levels must be 1-" + to_string(ROSTER_MAX_LEVEL);
+                return false;
+            }
+            if (character.getName().empty() || character.getName().size() > ROSTER_MAX_NAME_LENGTH) {
+                error = character.getName() + ": names must be 1-" + to_string(ROSTER_MAX_NAME_LENGTH) + " characters";
+                return false;
+            }
+            if (character.getKind() == CharacterKind::CUSTOM) {
+                error = character.getName() + ": images hold built-in classes only";
+                return false;
+            }
+            RosterImageCharacter& record = characterRecords[i];
+            memset(&record, 0, sizeof(record));
+            record.kind = static_cast<uint8_t>(character.getKind());
+            record.level = static_cast<uint8_t>(character.getLevel());
+            record.nameLength = static_cast<uint8_t>(character.getName().size());
+            memcpy(record.name, character.getName().data(), record.nameLength);
+        }
+        vector<RosterImageArena> arenaRecords(arenas.size());
+        for (size_t i = 0; i < arenas.size(); ++i) {
+            RosterImageArena& record = arenaRecords[i];
+            memset(&record, 0, sizeof(record));
+            const string& name = arenas[i].getName();
+            if (name.empty() || name.size() > sizeof(record.name)) {
+                error = name + ": arena names must be 1-" + to_string(sizeof(record.name)) + " characters";
+                return false;
+            }
+            record.nameLength = static_cast<uint8_t>(name.size());
+            memcpy(record.name, name.data(), name.size());
+            record.environment = static_cast<uint8_t>(arenas[i].getEnvironmentType());
+        }
+
+        RosterIndex index;
+        index.build(roster);
+        const RosterIndexData& data = index.getData();
+        uint64_t count = data.count;
+        RosterImageHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, ROSTER_IMAGE_MAGIC, sizeof(ROSTER_IMAGE_MAGIC));
+        header.version = ROSTER_IMAGE_FORMAT_VERSION;
+        header.kindCount = CHARACTER_KIND_COUNT;
+        header.characterCount = data.count;
+        header.arenaCount = static_cast<uint32_t>(arenas.size());
+        header.nameTextSize = data.nameOffsets[count];
+        header.fileSize = layoutFor(count, arenas.size(), header.nameTextSize).end;
+
+        ofstream out(path, ios::binary | ios::trunc);
+        if (!out.is_open()) {
+            error = "could not create the file";
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        writeSection(out, characterRecords.data(), count);
+        writeSection(out, arenaRecords.data(), arenaRecords.size());
+        writeSection(out, data.levels, count);
+        writePadding(out, count);
+        writeSection(out, data.kinds, count);
+        writePadding(out, count);
+        writeSection(out, data.byName, count);
+        writeSection(out, data.byLevel, count);
+        writeSection(out, data.byClass, count);
+        writeSection(out, data.classStart, CHARACTER_KIND_COUNT + 1);
+        writeSection(out, data.nameOffsets, count + 1);
+        writeSection(out, data.nameText, header.nameTextSize);
+        if (!out.good()) {
+            error = "could not write the file";
+            return false;
+        }
+        return true;
+    }
+
+    RosterImage::RosterImage() : header(nullptr), characters(nullptr), arenas(nullptr) {
+        index = RosterIndexData();
+    }
+
+    bool RosterImage::open(const string& path) {
+        close();
+        if (!file.open(path) || file.size() < sizeof(RosterImageHeader)) {
+            file.close();
+            return false;
+        }
+        const unsigned char* base = file.getData();
+        const RosterImageHeader* candidate = reinterpret_cast<const RosterImageHeader*>(base);
+        if (memcmp(candidate->magic, ROSTER_IMAGE_MAGIC, sizeof(ROSTER_IMAGE_MAGIC)) != 0 ||
+            candidate->version != ROSTER_IMAGE_FORMAT_VERSION || candidate->kindCount != CHARACTER_KIND_COUNT ||
+            candidate->characterCount < 2 || candidate->arenaCount < 1 || candidate->fileSize != file.size()) {
+            file.close();
+            return false;
+        }
+        RosterImageLayout layout = layoutFor(candidate->characterCount, candidate->arenaCount, candidate->nameTextSize);
+        if (layout.end != file.size()) {
+            file.close();
+            return false;
+        }
+        // Everything below points into the mapping; nothing is copied
+        index.count = candidate->characterCount;
+        index.classCount = candidate->kindCount;
+        index.levels = base + layout.levels;
+        index.kinds = base + layout.kinds;
+        index.byName = reinterpret_cast<const uint32_t*>(base + layout.byName);
+        index.byLevel = reinterpret_cast<const uint32_t*>(base + layout.byLevel);
+        index.byClass = reinterpret_cast<const uint32_t*>(base + layout.byClass);
+        index.classStart = reinterpret_cast<const uint32_t*>(base + layout.classStart);
+        index.nameOffsets = reinterpret_cast<const uint32_t*>(base + layout.nameOffsets);
+        index.nameText = reinterpret_cast<const char*>(base + layout.nameText);
+        if (!isValidIndex(index, candidate->nameTextSize)) {
+            close();
+            return false;
+        }
+        header = candidate;
+        characters = reinterpret_cast<const RosterImageCharacter*>(base + layout.characters);
+        arenas = reinterpret_cast<const RosterImageArena*>(base + layout.arenas);
+        return true;
+    }
+
+    void RosterImage::close() {
+        file.close();
+        header = nullptr;
+        characters = nullptr;
+        arenas = nullptr;
+        index = RosterIndexData();
+    }
+
+    string RosterImage::getCharacterName(size_t position) const {
+        const RosterImageCharacter& record = characters[position];
+        return string(record.name, min<size_t>(record.nameLength, sizeof(record.name)));
+    }
+
+    Character* RosterImage::createCharacter(size_t position) const {
+        const RosterImageCharacter& record = characters[position];
+        if (record.kind >= CHARACTER_KIND_COUNT || record.level < 1 || record.level > ROSTER_MAX_LEVEL ||
+            record.nameLength == 0 || record.nameLength > sizeof(record.name)) {
+            return nullptr;
+        }
+        return FantasyArena::createCharacter(static_cast<CharacterKind>(record.kind), getCharacterName(position),
+            record.level);
+    }
+
+    bool RosterImage::getArena(size_t position, string& name, EnvironmentType& environment) const {
+        const RosterImageArena& record = arenas[position];
+        if (record.environment >= ENVIRONMENT_COUNT || record.nameLength == 0 || record.nameLength > sizeof(record.name)) {
+            return false;
+        }
+        name.assign(record.name, record.nameLength);
+        environment = static_cast<EnvironmentType>(record.environment);
+        return true;
+    }
+} // namespace FantasyArena
@@ -0,0 +1,84 @@
+#pragma once
+#ifndef ROSTER_IMAGE_H
+#define ROSTER_IMAGE_H
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "Character.h"
+#include "Arena.h"
+#include "MappedFile.h"
+#include "Roster.h"
+using namespace std;
+namespace FantasyArena {
+    struct RosterImageCharacter {
+        uint8_t kind;       // CharacterKind
+        uint8_t level;
+        uint8_t nameLength;
+        uint8_t reserved;
+        char name[ROSTER_MAX_NAME_LENGTH]; // Not terminated
+    };
+    static_assert(sizeof(RosterImageCharacter) == 68, "RosterImageCharacter layout changed");
+
+    struct RosterImageArena {
+        char name[60];      // Not terminated
+        uint8_t nameLength;
+        uint8_t environment; // EnvironmentType
+        uint16_t reserved;
+    };
+    static_assert(sizeof(RosterImageArena) == 64, "RosterImageArena layout changed");
+
+    // File layout: header, character records, arena records, then the
+    // RosterIndexData arrays in declaration order (levels and kinds padded
+    // to 4 bytes). Every section follows from the counts, so the file holds
+    // no pointers and is used in place wherever it is mapped.
+    struct RosterImageHeader {
+        char magic[4];          // "FARI"
+        uint32_t version;
+        uint32_t kindCount;
+        uint32_t characterCount;
+        uint32_t arenaCount;
+        uint32_t nameTextSize;  // Bytes of lower-case names in the name index
+        uint64_t fileSize;
+    };
+    static_assert(sizeof(RosterImageHeader) == 32, "RosterImageHeader layout changed");
+
+    const uint32_t ROSTER_IMAGE_FORMAT_VERSION = 1;
+
+    // Write a roster and its arenas as an image; false with `error` set if a
+    // character or arena does not fit the format or the file cannot be written
+    bool writeRosterImage(const string& path, const vector<Character*>& roster, const vector<Arena>& arenas,
+        string& error);
+
+    // A roster image mapped read-only. Opening it checks the header, the size
+    // and one pass over the index arrays, and processes that map the same
+    // image share its pages. Characters are built on request.
+    class RosterImage {
+    private:
+        MappedFile file;
+        const RosterImageHeader* header;
+        const RosterImageCharacter* characters;
+        const RosterImageArena* arenas;
+        RosterIndexData index;
+    public:
+        RosterImage();
+        RosterImage(const RosterImage&) = delete;
+        RosterImage& operator=(const RosterImage&) = delete;
+
+        // Fails if the file is damaged or from another format version
+        bool open(const string& path);
+        void close();
+        bool isOpen() const { return header != nullptr; }
+
+        size_t getCharacterCount() const { return header ? header->characterCount : 0; }
+        size_t getArenaCount() const { return header ? header->arenaCount : 0; }
+        const RosterImageCharacter& getCharacter(size_t position) const { return characters[position]; }
+        string getCharacterName(size_t position) const;
+        // New roster template for the record, owned by the caller; nullptr if the record is damaged
+        Character* createCharacter(size_t position) const;
+        // False if the record is damaged
+        bool getArena(size_t position, string& name, EnvironmentType& environment) const;
+        // Prebuilt lookups, served from the mapping (RosterIndex::attach)
+        const RosterIndexData& getIndex() const { return index; }
+    };
+} // namespace FantasyArena
+#endif // ROSTER_IMAGE_H
@@ -0,0 +1,323 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include "SaveStore.h"
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <vector>
+#include <fstream>
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+using namespace std;
+namespace FantasyArena {
+    static const char SAVE_STORE_MAGIC[4] = { 'F', 'A', 'S', 'V' };
+    static const uint32_t MIN_BUCKET_COUNT = 16;
+
+    // CRC-32 (IEEE 802.3, reflected) lookup table, built at compile time
+    struct Crc32Table {
+        uint32_t values[256];
+    };
+
+    static constexpr Crc32Table makeCrc32Table() {
+        Crc32Table table = {};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+            }
+            table.values[i] = crc;
+        }
+        return table;
+    }
+
+    static constexpr Crc32Table CRC32_TABLE = makeCrc32Table();
+
+    // Start from 0xFFFFFFFF and invert the final value
+    static uint32_t crc32Update(uint32_t crc, const void* data, size_t length) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < length; ++i) {
+            crc = CRC32_TABLE.values[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return crc;
+    }
+
+    // Over the first `size` bytes, i.e. the record of one format version
+    static uint32_t recordChecksum(const SaveSlotRecord& record, size_t size = sizeof(SaveSlotRecord)) {
+        SaveSlotRecord copy = record;
+        copy.checksum = 0;
+        return ~crc32Update(0xFFFFFFFFu, &copy, size);
+    }
+
+    static uint32_t headerChecksum(const SaveStoreHeader& header, const uint32_t* buckets) {
+        SaveStoreHeader copy = header;
+        copy.checksum = 0;
+        uint32_t crc = crc32Update(0xFFFFFFFFu, &copy, sizeof(copy));
+        return ~crc32Update(crc, buckets, header.bucketCount * sizeof(uint32_t));
+    }
+
+    // FNV-1a of the slot name
+    static uint64_t hashSlotName(const char* name) {
+        uint64_t hash = 0xCBF29CE484222325ull;
+        for (size_t i = 0; i < SAVE_SLOT_NAME_SIZE && name[i]; ++i) {
+            hash = (hash ^ static_cast<unsigned char>(name[i])) * 0x100000001B3ull;
+        }
+        return hash;
+    }
+
+    // Header, index and records of a complete store file
+    static string buildStoreFile(const vector<SaveSlotRecord>& slots) {
+        uint32_t bucketCount = MIN_BUCKET_COUNT;
+        while (bucketCount < slots.size() * 2) {
+            bucketCount <<= 1;
+        }
+        vector<uint32_t> buckets(bucketCount, 0);
+        for (size_t i = 0; i < slots.size(); ++i) {
+            size_t bucket = hashSlotName(slots[i].name) & (bucketCount - 1);
+            while (buckets[bucket] != 0) {
+                bucket = (bucket + 1) & (bucketCount - 1);
+            }
+            buckets[bucket] = static_cast<uint32_t>(i + 1);
+        }
+        SaveStoreHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, SAVE_STORE_MAGIC, sizeof(SAVE_STORE_MAGIC));
+        header.version = SAVE_STORE_FORMAT_VERSION;
+        header.slotCount = static_cast<uint32_t>(slots.size());
+        header.bucketCount = bucketCount;
+        header.checksum = headerChecksum(header, buckets.data());
+
+        string contents;
+        contents.reserve(sizeof(header) + bucketCount * sizeof(uint32_t) + slots.size() * sizeof(SaveSlotRecord));
+        contents.append(reinterpret_cast<const char*>(&header), sizeof(header));
+        contents.append(reinterpret_cast<const char*>(buckets.data()), bucketCount * sizeof(uint32_t));
+        contents.append(reinterpret_cast<const char*>(slots.data()), slots.size() * sizeof(SaveSlotRecord));
+        return contents;
+    }
+
+    SaveStore::SaveStore() : header(nullptr), buckets(nullptr), records(nullptr), recordSize(0), damaged(false) {
+    }
+
+    bool SaveStore::open(const string& storePath) {
+        close();
+        path = storePath;
+        ifstream existing(path, ios::binary);
+        if (!existing.is_open()) {
+            return true; // No saves yet
+        }
+        existing.close();
+        damaged = true;
+        if (!file.open(path) || file.size() < sizeof(SaveStoreHeader)) {
+            file.close();
+            return false;
+        }
+        const SaveStoreHeader* candidate = reinterpret_cast<const SaveStoreHeader*>(file.getData());
+        const uint32_t* candidateBuckets = reinterpret_cast<const uint32_t*>(file.getData() + sizeof(SaveStoreHeader));
+        size_t candidateRecordSize = candidate->version == 1 ? SAVE_SLOT_RECORD_SIZE_V1 : sizeof(SaveSlotRecord);
+        uint64_t expectedSize = sizeof(SaveStoreHeader) + static_cast<uint64_t>(candidate->bucketCount) * sizeof(uint32_t) +
+            static_cast<uint64_t>(candidate->slotCount) * candidateRecordSize;
+        if (memcmp(candidate->magic, SAVE_STORE_MAGIC, sizeof(SAVE_STORE_MAGIC)) != 0 ||
+            candidate->version < 1 || candidate->version > SAVE_STORE_FORMAT_VERSION || candidate->bucketCount < MIN_BUCKET_COUNT ||
+            (candidate->bucketCount & (candidate->bucketCount - 1)) != 0 ||
+            candidate->bucketCount < static_cast<uint64_t>(candidate->slotCount) * 2 || expectedSize != file.size() ||
+            headerChecksum(*candidate, candidateBuckets) != candidate->checksum) {
+            file.close();
+            return false;
+        }
+        for (uint32_t i = 0; i < candidate->bucketCount; ++i) {
+            if (candidateBuckets[i] > candidate->slotCount) {
+                file.close();
+                return false;
+            }
+        }
+        header = candidate;
+        buckets = candidateBuckets;
+        records = file.getData() + sizeof(SaveStoreHeader) + candidate->bucketCount * sizeof(uint32_t);
+        recordSize = candidateRecordSize;
+        damaged = false;
+        return true;
+    }
+
+    void SaveStore::close() {
+        header = nullptr;
+        buckets = nullptr;
+        records = nullptr;
+        recordSize = 0;
+        damaged = false;
+        file.close();
+    }
+
+    size_t SaveStore::getSlotCount() const {
+        return header ? header->slotCount : 0;
+    }
+
+    long SaveStore::findRecord(const string& name) const {
+        if (!header || !isValidSlotName(name)) {
+            return -1;
+        }
+        uint32_t mask = header->bucketCount - 1;
+        uint32_t bucket = static_cast<uint32_t>(hashSlotName(name.c_str())) & mask;
+        // The index is at most half full, so an empty bucket ends every probe
+        for (uint32_t probes = 0; probes < header->bucketCount; ++probes) {
+            uint32_t entry = buckets[bucket];
+            if (entry == 0) {
+                return -1;
+            }
+            if (strncmp(recordName(entry - 1), name.c_str(), SAVE_SLOT_NAME_SIZE) == 0) {
+                return static_cast<long>(entry - 1);
+            }
+            bucket = (bucket + 1) & mask;
+        }
+        return -1;
+    }
+
+    const char* SaveStore::recordName(size_t index) const {
+        return reinterpret_cast<const char*>(records + index * recordSize); // The name comes first in every version
+    }
+
+    bool SaveStore::find(const string& name, SaveSlotRecord& slot) const {
+        long index = findRecord(name);
+        return index >= 0 && getSlot(static_cast<size_t>(index), slot);
+    }
+
+    bool SaveStore::getSlot(size_t index, SaveSlotRecord& slot) const {
+        if (index >= getSlotCount()) {
+            return false;
+        }
+        // Fields added after the file's version read as zero
+        memset(&slot, 0, sizeof(slot));
+        memcpy(&slot, records + index * recordSize, recordSize);
+        return recordChecksum(slot, recordSize) == slot.checksum && slot.name[SAVE_SLOT_NAME_SIZE - 1] == '\0';
+    }
+
+    bool SaveStore::contains(const string& name) const {
+        return findRecord(name) >= 0;
+    }
+
+    bool SaveStore::save(const SaveSlotRecord& slot) {
+        if (damaged || path.empty() || !isValidSlotName(slot.name)) {
+            return false;
+        }
+        vector<SaveSlotRecord> slots(getSlotCount());
+        for (size_t i = 0; i < slots.size(); ++i) {
+            // Older records are rewritten in the current version; damaged ones stay damaged
+            if (getSlot(i, slots[i])) {
+                slots[i].checksum = recordChecksum(slots[i]);
+            }
+        }
+        SaveSlotRecord record = slot;
+        record.checksum = recordChecksum(record);
+        long existing = findRecord(slot.name);
+        if (existing >= 0) {
+            slots[existing] = record;
+        }
+        else {
+            slots.push_back(record);
+        }
+        return replaceFile(buildStoreFile(slots));
+    }
+
+    bool SaveStore::replaceFile(const string& contents) {
+        // Write and flush a complete new file, then rename it over the old one
+        string temporaryPath = path + ".tmp";
+        FILE* out = fopen(temporaryPath.c_str(), "wb");
+        if (!out) {
+            return false;
+        }
+        bool written = fwrite(contents.data(), 1, contents.size(), out) == contents.size() && fflush(out) == 0;
+#ifdef _WIN32
+        written = written && _commit(_fileno(out)) == 0;
+#else
+        written = written && fsync(fileno(out)) == 0;
+#endif
+        written = fclose(out) == 0 && written;
+        if (!written) {
+            std::remove(temporaryPath.c_str());
+            return false;
+        }
+        string storePath = path;
+        close(); // Windows cannot replace a mapped file
+#ifdef _WIN32
+        bool renamed = MoveFileExA(temporaryPath.c_str(), storePath.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+        bool renamed = rename(temporaryPath.c_str(), storePath.c_str()) == 0;
+#endif
+        if (!renamed) {
+            std::remove(temporaryPath.c_str());
+        }
+        return open(storePath) && renamed;
+    }
+
+    void SaveStore::setCheckpoint(SaveSlotRecord& slot, const BattleCheckpoint& checkpoint) {
+        slot.flags |= SAVE_SLOT_IN_BATTLE;
+        slot.turnNumber = checkpoint.turnNumber;
+        slot.attacker = checkpoint.attacker;
+        slot.randomPosition = checkpoint.randomPosition;
+        for (int i = 0; i < 2; ++i) {
+            const CombatState& state = checkpoint.fighters[i];
+            SaveFighterState& fighter = slot.fighters[i];
+            fighter.health = state.health;
+            fighter.attack = state.attack;
+            fighter.defense = state.defense;
+            fighter.currentCooldown = state.currentCooldown;
+            fighter.abilityDuration = state.abilityDuration;
+            fighter.abilityStatus = static_cast<uint8_t>(state.abilityStatus);
+            fighter.abilityActive = state.abilityActive ? 1 : 0;
+            fighter.revived = state.revived ? 1 : 0;
+            fighter.reserved = 0;
+        }
+    }
+
+    bool SaveStore::getCheckpoint(const SaveSlotRecord& slot, BattleCheckpoint& checkpoint) {
+        if (!(slot.flags & SAVE_SLOT_IN_BATTLE) || slot.turnNumber < 1 || (slot.attacker != 1 && slot.attacker != 2)) {
+            return false;
+        }
+        checkpoint.turnNumber = slot.turnNumber;
+        checkpoint.attacker = slot.attacker;
+        checkpoint.randomPosition = slot.randomPosition;
+        for (int i = 0; i < 2; ++i) {
+            const SaveFighterState& fighter = slot.fighters[i];
+            if (fighter.health <= 0 || fighter.abilityStatus > static_cast<uint8_t>(SpecialAbilityStatus::COOLDOWN)) {
+                return false;
+            }
+            CombatState& state = checkpoint.fighters[i];
+            state.health = fighter.health;
+            state.attack = fighter.attack;
+            state.defense = fighter.defense;
+            state.currentCooldown = fighter.currentCooldown;
+            state.abilityDuration = fighter.abilityDuration;
+            state.abilityStatus = static_cast<SpecialAbilityStatus>(fighter.abilityStatus);
+            state.abilityActive = fighter.abilityActive != 0;
+            state.revived = fighter.revived != 0;
+        }
+        return true;
+    }
+
+    bool SaveStore::isValidSlotName(const string& name) {
+        if (name.empty() || name.size() >= SAVE_SLOT_NAME_SIZE) {
+            return false;
+        }
+        for (char c : name) {
+            if (static_cast<unsigned char>(c) < 0x20 || c == 0x7F) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    SaveSlotRecord SaveStore::makeSlot(const string& name, int player1Index, int player2Index, int arenaIndex,
+        int battleCount, uint64_t seed) {
+        SaveSlotRecord slot;
+        memset(&slot, 0, sizeof(slot));
+        strncpy(slot.name, name.c_str(), SAVE_SLOT_NAME_SIZE - 1);
+        slot.player1Index = player1Index;
+        slot.player2Index = player2Index;
+        slot.arenaIndex = arenaIndex;
+        slot.battleCount = battleCount;
+        slot.seed = seed;
+        slot.savedAt = static_cast<int64_t>(time(nullptr));
+        return slot;
+    }
+} // namespace FantasyArena
@@ -0,0 +1,110 @@
+#pragma once
+#ifndef SAVE_STORE_H
+#define SAVE_STORE_H
+#include <string>
+#include <cstdint>
+#include "MappedFile.h"
+#include "Arena.h"
+using namespace std;
+namespace FantasyArena {
+    const size_t SAVE_SLOT_NAME_SIZE = 32; // Including the terminating zero
+
+    // CombatState of one fighter in a saved battle
+    struct SaveFighterState {
+        int32_t health;
+        int32_t attack;
+        int32_t defense;
+        int32_t currentCooldown;
+        int32_t abilityDuration;
+        uint8_t abilityStatus;  // SpecialAbilityStatus
+        uint8_t abilityActive;  // Transparent, Mirror Image, Evasive Roll or Mirror Strike is up
+        uint8_t revived;
+        uint8_t reserved;
+    };
+    static_assert(sizeof(SaveFighterState) == 24, "SaveFighterState layout changed");
+
+    const uint32_t SAVE_SLOT_IN_BATTLE = 1; // SaveSlotRecord::flags: a battle was saved mid-fight
+
+    // One saved battle setup, and optionally the battle in progress.
+    // Fixed-width fields in a fixed order, so the file reads the same
+    // whatever compiler wrote it.
+    struct SaveSlotRecord {
+        char name[SAVE_SLOT_NAME_SIZE];
+        int32_t player1Index;
+        int32_t player2Index;
+        int32_t arenaIndex;
+        int32_t battleCount;
+        uint64_t seed;        // Replays the saved battle exactly
+        int64_t savedAt;      // time_t of the save
+        uint32_t checksum;    // CRC-32 of the record with this field zero
+        uint32_t flags;
+        // Version 2: the battle at the start of turnNumber, if SAVE_SLOT_IN_BATTLE
+        int32_t turnNumber;
+        int32_t attacker;     // 1 or 2
+        uint64_t randomPosition;
+        SaveFighterState fighters[2];
+    };
+    static_assert(sizeof(SaveSlotRecord) == 136, "SaveSlotRecord layout changed");
+    const size_t SAVE_SLOT_RECORD_SIZE_V1 = 72; // Version 1 records end after flags
+
+    // File layout: header, hash index, slot records in the order they were
+    // first saved. The index is an open-addressing table of record numbers
+    // plus one (0 = empty), probed linearly from the hash of the slot name.
+    struct SaveStoreHeader {
+        char magic[4];          // "FASV"
+        uint32_t version;
+        uint32_t slotCount;
+        uint32_t bucketCount;   // Power of two, at least twice slotCount
+        uint32_t checksum;      // CRC-32 of the header (this field zero) and the index
+        uint32_t reserved;
+    };
+    static_assert(sizeof(SaveStoreHeader) == 24, "SaveStoreHeader layout changed");
+
+    const uint32_t SAVE_STORE_FORMAT_VERSION = 2; // Version 1 files are read and rewritten as version 2
+
+    // Named save slots in one memory-mapped file. Finding a slot is one hash
+    // probe and listing reads the records in place. Every change writes a
+    // complete new file next to the old one and renames it over, so a crash
+    // leaves either the old or the new saves, never a mix.
+    class SaveStore {
+    private:
+        string path;
+        MappedFile file;
+        const SaveStoreHeader* header;
+        const uint32_t* buckets;
+        const unsigned char* records;
+        size_t recordSize; // Of the file's version
+        bool damaged; // The file exists but failed validation; never overwritten
+
+        long findRecord(const string& name) const;
+        const char* recordName(size_t index) const;
+        bool replaceFile(const string& contents);
+    public:
+        SaveStore();
+        SaveStore(const SaveStore&) = delete;
+        SaveStore& operator=(const SaveStore&) = delete;
+
+        // A missing file is an empty store; false if the file is damaged
+        bool open(const string& path);
+        void close();
+        bool isDamaged() const { return damaged; }
+        size_t getSlotCount() const;
+
+        // False if there is no such slot or its record fails the checksum
+        bool find(const string& name, SaveSlotRecord& slot) const;
+        bool getSlot(size_t index, SaveSlotRecord& slot) const; // In the order slots were first saved
+        bool contains(const string& name) const;
+
+        // Add the slot, or replace the slot with the same name
+        bool save(const SaveSlotRecord& slot);
+
+        // 1-31 printable characters
+        static bool isValidSlotName(const string& name);
+        static SaveSlotRecord makeSlot(const string& name, int player1Index, int player2Index, int arenaIndex,
+            int battleCount, uint64_t seed);
+        // Store or read back the battle in progress of a slot
+        static void setCheckpoint(SaveSlotRecord& slot, const BattleCheckpoint& checkpoint);
+        static bool getCheckpoint(const SaveSlotRecord& slot, BattleCheckpoint& checkpoint);
+    };
+} // namespace FantasyArena
+#endif // SAVE_STORE_H
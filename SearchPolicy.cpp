@@ -0,0 +1,215 @@
+#include "SearchPolicy.h"
+#include "StatTables.h"
+#include <algorithm>
+using namespace std;
+namespace FantasyArena {
+    static const int WIN_SCORE = 1000000;
+    static const int DECIDED_SCORE = WIN_SCORE - 1000; // Above this a win or loss was found
+    static const int INFINITE_SCORE = WIN_SCORE + 1;
+    static const int MAX_SEARCH_DEPTH = 100;
+    static const uint64_t NODES_PER_CLOCK_CHECK = 256;
+    static const uint8_t BOUND_EXACT = 1;
+    static const uint8_t BOUND_LOWER = 2;
+    static const uint8_t BOUND_UPPER = 3;
+
+    // Won and lost scores count plies from the root; the table stores them
+    // counted from the entry's own position so they stay valid at any ply
+    static int toTableScore(int score, int ply) {
+        if (score > DECIDED_SCORE) return score + ply;
+        if (score < -DECIDED_SCORE) return score - ply;
+        return score;
+    }
+
+    static int fromTableScore(int score, int ply) {
+        if (score > DECIDED_SCORE) return score - ply;
+        if (score < -DECIDED_SCORE) return score + ply;
+        return score;
+    }
+
+    // Score of a finished battle for the fighter that was to move at `ply`
+    static int outcomeScore(ModelOutcome outcome, int ply) {
+        switch (outcome) {
+        case ModelOutcome::ACTOR_WINS:
+            return WIN_SCORE - ply - 1;
+        case ModelOutcome::ACTOR_LOSES:
+            return -(WIN_SCORE - ply - 1);
+        default:
+            return 0;
+        }
+    }
+
+    SearchPolicy::SearchPolicy(double budgetMilliseconds, size_t tableEntries)
+        : budgetMilliseconds(budgetMilliseconds), aborted(false), nodes(0), tablebase(nullptr),
+        lastDepth(0), lastScore(0), lastNodes(0), lastSolved(TablebaseOutcome::UNKNOWN) {
+        size_t size = 1;
+        while (size < tableEntries) {
+            size <<= 1;
+        }
+        table.resize(size);
+        clearTable();
+    }
+
+    void SearchPolicy::clearTable() {
+        for (TableEntry& entry : table) {
+            entry = { 0, 0, -1, 0, 0 };
+        }
+    }
+
+    int SearchPolicy::evaluate(const ModelState& state) {
+        const ModelFighter& self = state.toMove;
+        const ModelFighter& opponent = state.waiting;
+        // Health still to take away, counting an unused resurrection
+        int selfHealth = self.health + modelResurrectionHealth(self);
+        int opponentHealth = opponent.health + modelResurrectionHealth(opponent);
+        int selfHit = modelAttackDamage(self, opponent);
+        int opponentHit = modelAttackDamage(opponent, self);
+        int selfTurns = (opponentHealth + selfHit - 1) / selfHit;
+        int opponentTurns = (selfHealth + opponentHit - 1) / opponentHit;
+        // The fighter to move strikes first, so it wins a tied race
+        int score = (selfTurns <= opponentTurns ? 500 : -500) + 100 * (opponentTurns - selfTurns);
+        score += 100 * self.health / max(self.maxHealth, 1) - 100 * opponent.health / max(opponent.maxHealth, 1);
+        score += (self.abilityReady ? 20 : 0) - (opponent.abilityReady ? 20 : 0);
+        return score;
+    }
+
+    int SearchPolicy::negamax(const ModelState& state, int depth, int alpha, int beta, int ply) {
+        ++nodes;
+        if (nodes % NODES_PER_CLOCK_CHECK == 0 && chrono::steady_clock::now() >= deadline) {
+            aborted = true;
+        }
+        if (aborted) {
+            return 0;
+        }
+
+        uint64_t key = hashModelState(state);
+        TableEntry& entry = table[key & (table.size() - 1)];
+        uint8_t tableMove = 0;
+        if (entry.key == key) {
+            tableMove = entry.move;
+            if (entry.depth >= depth) {
+                int score = fromTableScore(entry.score, ply);
+                if (entry.bound == BOUND_EXACT) return score;
+                if (entry.bound == BOUND_LOWER) alpha = max(alpha, score);
+                if (entry.bound == BOUND_UPPER) beta = min(beta, score);
+                if (alpha >= beta) return score;
+            }
+        }
+        if (depth == 0) {
+            return evaluate(state);
+        }
+
+        BattleAction moves[2] = { BattleAction::ATTACK, BattleAction::SPECIAL_ABILITY };
+        int moveCount = state.toMove.abilityReady ? 2 : 1;
+        if (moveCount == 2 && tableMove == static_cast<uint8_t>(BattleAction::SPECIAL_ABILITY)) {
+            swap(moves[0], moves[1]);
+        }
+        int originalAlpha = alpha;
+        int best = -INFINITE_SCORE;
+        BattleAction bestMove = moves[0];
+        for (int i = 0; i < moveCount; ++i) {
+            ModelState child = state;
+            ModelOutcome outcome = applyModelAction(child, moves[i]);
+            int score = outcome == ModelOutcome::ONGOING ? -negamax(child, depth - 1, -beta, -alpha, ply + 1)
+                : outcomeScore(outcome, ply);
+            if (aborted) {
+                return 0;
+            }
+            if (score > best) {
+                best = score;
+                bestMove = moves[i];
+            }
+            alpha = max(alpha, score);
+            if (alpha >= beta) {
+                break;
+            }
+        }
+
+        entry.key = key;
+        entry.score = toTableScore(best, ply);
+        entry.depth = static_cast<int16_t>(depth);
+        entry.bound = best <= originalAlpha ? BOUND_UPPER : best >= beta ? BOUND_LOWER : BOUND_EXACT;
+        entry.move = static_cast<uint8_t>(bestMove);
+        return best;
+    }
+
+    int SearchPolicy::searchRoot(const ModelState& state, int depth, BattleAction& bestAction) {
+        // The previous iteration's best move is searched first
+        BattleAction moves[2] = { bestAction, bestAction == BattleAction::ATTACK ? BattleAction::SPECIAL_ABILITY : BattleAction::ATTACK };
+        int alpha = -INFINITE_SCORE;
+        for (BattleAction move : moves) {
+            ModelState child = state;
+            ModelOutcome outcome = applyModelAction(child, move);
+            int score = outcome == ModelOutcome::ONGOING ? -negamax(child, depth - 1, -INFINITE_SCORE, -alpha, 1)
+                : outcomeScore(outcome, 0);
+            if (aborted) {
+                return 0;
+            }
+            if (score > alpha) {
+                alpha = score;
+                bestAction = move;
+            }
+        }
+        return alpha;
+    }
+
+    BattleAction SearchPolicy::chooseAction(const Character& self, const Character& opponent, int /*turnNumber*/, BattleRandom& /*random*/) {
+        ModelState state = makeModelState(self, opponent);
+        BattleAction best = BattleAction::ATTACK;
+        lastDepth = 0;
+        lastScore = 0;
+        lastNodes = 0;
+        lastSolved = TablebaseOutcome::UNKNOWN;
+        TablebaseProbe solved;
+        if (tablebase && tablebase->probe(state, solved)) {
+            best = solved.bestAction;
+            lastSolved = solved.outcome;
+        }
+        else if (state.toMove.abilityReady) {
+            // Only a choice when the ability is ready; the first iteration always completes
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            deadline = chrono::steady_clock::time_point::max();
+            aborted = false;
+            nodes = 0;
+            for (int depth = 1; depth <= MAX_SEARCH_DEPTH; ++depth) {
+                BattleAction action = best;
+                int score = searchRoot(state, depth, action);
+                if (aborted) {
+                    break;
+                }
+                best = action;
+                lastDepth = depth;
+                lastScore = score;
+                if (depth == 1) {
+                    deadline = start +
+                        chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double, milli>(budgetMilliseconds));
+                }
+                if (score > DECIDED_SCORE || score < -DECIDED_SCORE) {
+                    break; // The outcome is decided, deeper search changes nothing
+                }
+            }
+            lastNodes = nodes;
+        }
+        if (Character::isConsoleOutputEnabled()) {
+            string choice = best == BattleAction::ATTACK ? "1 (Attack)" : "2 (" + self.getSpecialAbilityName() + ")";
+            string detail;
+            if (lastSolved != TablebaseOutcome::UNKNOWN) {
+                detail = " (tablebase: forced " + getTablebaseOutcomeName(lastSolved) + ")";
+            }
+            else if (lastScore > DECIDED_SCORE) {
+                detail = " and sees a forced win";
+            }
+            else if (lastScore < -DECIDED_SCORE) {
+                detail = " and sees a forced loss";
+            }
+            else if (lastDepth > 0) {
+                detail = " (search depth " + to_string(lastDepth) + " turns)";
+            }
+            Character::display(self.getName() + " (computer) chooses " + choice + detail);
+        }
+        return best;
+    }
+
+    string SearchPolicy::getPolicyName() const {
+        return "search";
+    }
+} // namespace FantasyArena
@@ -0,0 +1,61 @@
+#pragma once
+#ifndef SEARCH_POLICY_H
+#define SEARCH_POLICY_H
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include "ActionPolicy.h"
+#include "CombatModel.h"
+#include "Tablebase.h"
+using namespace std;
+namespace FantasyArena {
+    // Computer opponent. Searches the turn tree on the CombatModel with
+    // alpha-beta negamax, iterative deepening and a transposition table, and
+    // plays the best move of the deepest search finished within the budget.
+    class SearchPolicy : public ActionPolicy {
+    private:
+        // One transposition table slot; scores of won or lost positions are
+        // stored relative to the slot's own position
+        struct TableEntry {
+            uint64_t key;
+            int32_t score;
+            int16_t depth;
+            uint8_t bound;   // EXACT, LOWER or UPPER
+            uint8_t move;    // Best BattleAction, 0 = none
+        };
+        vector<TableEntry> table;
+        double budgetMilliseconds;
+        chrono::steady_clock::time_point deadline;
+        bool aborted;
+        uint64_t nodes;
+        const Tablebase* tablebase; // Consulted before searching, not owned
+        // Statistics of the last chooseAction
+        int lastDepth;
+        int lastScore;
+        uint64_t lastNodes;
+        TablebaseOutcome lastSolved; // UNKNOWN unless the last move came from the tablebase
+
+        int negamax(const ModelState& state, int depth, int alpha, int beta, int ply);
+        int searchRoot(const ModelState& state, int depth, BattleAction& bestAction);
+    public:
+        // tableEntries is rounded up to a power of two
+        explicit SearchPolicy(double budgetMilliseconds = 5.0, size_t tableEntries = 1 << 16);
+        BattleAction chooseAction(const Character& self, const Character& opponent, int turnNumber, BattleRandom& random) override;
+        string getPolicyName() const override;
+
+        // Positions the tablebase covers are answered from it without searching
+        void setTablebase(const Tablebase* solved) { tablebase = solved; }
+        void setBudget(double milliseconds) { budgetMilliseconds = milliseconds; }
+        double getBudget() const { return budgetMilliseconds; }
+        int getLastDepth() const { return lastDepth; }
+        int getLastScore() const { return lastScore; }
+        uint64_t getLastNodes() const { return lastNodes; }
+        void clearTable();
+
+        // Static evaluation for the fighter to move: who wins the damage race
+        // if both just attack from here, then health and ability readiness
+        static int evaluate(const ModelState& state);
+    };
+} // namespace FantasyArena
+#endif // SEARCH_POLICY_H
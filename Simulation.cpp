@@ -0,0 +1,376 @@
+#include "Simulation.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+using namespace std;
+namespace FantasyArena {
+    SimulationOptions defaultSimulationOptions() {
+        SimulationOptions options;
+        options.enabled = false;
+        options.battles = 1;
+        options.player1Index = 1;
+        options.player2Index = 2;
+        options.arenaIndex = 1;
+        options.policy1 = "ability";
+        options.policy2 = "ability";
+        options.consoleMode = ConsoleMode::QUIET;
+        options.batch = false;
+        options.verify = false;
+        options.damageTables = false;
+        options.instrument = false;
+        options.replayBattle = 0;
+        options.replayTurn = 1;
+        options.hasSeed = false;
+        options.seed = 0;
+        options.tournament = 0;
+        options.threads = 0;
+        options.winRates = false;
+        options.confidenceHalfWidth = 0.02;
+        options.maxBattles = 20000;
+        options.levels = { 1, 5, 10 };
+        options.teamBattles = 0;
+        options.teamCount = 2;
+        options.teamSize = 5;
+        options.targetRule = TargetRule::LOWEST_HEALTH;
+        return options;
+    }
+
+    bool parseSimulationOptions(int argc, char* argv[], SimulationOptions& options) {
+        for (int i = 1; i < argc; ++i) {
+            string arg = argv[i];
+            bool hasValue = (i + 1 < argc);
+            if (arg == "--verbose") {
+                options.consoleMode = ConsoleMode::FULL;
+            }
+            else if (arg == "--summary") {
+                options.consoleMode = ConsoleMode::SUMMARY;
+            }
+            else if (arg == "--quiet") {
+                options.consoleMode = ConsoleMode::QUIET;
+            }
+            else if (arg == "--batch") {
+                options.batch = true;
+            }
+            else if (arg == "--verify") {
+                options.verify = true;
+            }
+            else if (arg == "--tables") {
+                options.damageTables = true;
+            }
+            else if (arg == "--stats") {
+                options.instrument = true;
+            }
+            else if (arg == "--winrates") {
+                options.winRates = true;
+            }
+            else if (!hasValue) {
+                cout << "Error: Missing value for argument " << arg << endl;
+                return false;
+            }
+            else if (arg == "--simulate") {
+                options.enabled = true;
+                options.battles = atoi(argv[++i]);
+            }
+            else if (arg == "--p1") {
+                options.player1Index = atoi(argv[++i]);
+            }
+            else if (arg == "--p2") {
+                options.player2Index = atoi(argv[++i]);
+            }
+            else if (arg == "--arena") {
+                options.arenaIndex = atoi(argv[++i]);
+            }
+            else if (arg == "--policy1") {
+                options.policy1 = argv[++i];
+            }
+            else if (arg == "--policy2") {
+                options.policy2 = argv[++i];
+            }
+            else if (arg == "--table-file") {
+                options.damageTables = true;
+                options.damageTableFile = argv[++i];
+            }
+            else if (arg == "--roster") {
+                options.rosterFile = argv[++i];
+            }
+            else if (arg == "--roster-image") {
+                options.rosterImageFile = argv[++i];
+            }
+            else if (arg == "--write-image") {
+                options.rosterImageOutput = argv[++i];
+            }
+            else if (arg == "--classes") {
+                options.classesFile = argv[++i];
+            }
+            else if (arg == "--ratings") {
+                options.ratingsFile = argv[++i];
+            }
+            else if (arg == "--stats-file") {
+                options.instrument = true;
+                options.instrumentFile = argv[++i];
+            }
+            else if (arg == "--solve") {
+                options.solveFile = argv[++i];
+            }
+            else if (arg == "--tablebase") {
+                options.tablebaseFile = argv[++i];
+            }
+            else if (arg == "--trace") {
+                options.traceFile = argv[++i];
+            }
+            else if (arg == "--replay") {
+                options.replayFile = argv[++i];
+            }
+            else if (arg == "--battle") {
+                options.replayBattle = atoi(argv[++i]);
+            }
+            else if (arg == "--turn") {
+                options.replayTurn = atoi(argv[++i]);
+            }
+            else if (arg == "--seed") {
+                options.hasSeed = true;
+                options.seed = strtoull(argv[++i], nullptr, 10);
+            }
+            else if (arg == "--tournament") {
+                options.tournament = atoi(argv[++i]);
+                if (options.tournament < 1) {
+                    cout << "Error: --tournament needs a positive number of battles per matchup." << endl;
+                    return false;
+                }
+            }
+            else if (arg == "--threads") {
+                int threads = atoi(argv[++i]);
+                options.threads = threads > 0 ? static_cast<unsigned>(threads) : 0;
+            }
+            else if (arg == "--ci") {
+                options.confidenceHalfWidth = atof(argv[++i]);
+                if (options.confidenceHalfWidth <= 0.0 || options.confidenceHalfWidth >= 0.5) {
+                    cout << "Error: --ci needs a half width between 0 and 0.5, e.g. 0.02." << endl;
+                    return false;
+                }
+            }
+            else if (arg == "--max-battles") {
+                options.maxBattles = atoi(argv[++i]);
+                if (options.maxBattles < 1) {
+                    cout << "Error: --max-battles needs a positive number." << endl;
+                    return false;
+                }
+            }
+            else if (arg == "--team-battle") {
+                options.teamBattles = atoi(argv[++i]);
+                if (options.teamBattles < 1) {
+                    cout << "Error: --team-battle needs a positive number of battles." << endl;
+                    return false;
+                }
+            }
+            else if (arg == "--teams") {
+                options.teamCount = atoi(argv[++i]);
+                if (options.teamCount < 2) {
+                    cout << "Error: --teams needs at least 2 teams." << endl;
+                    return false;
+                }
+            }
+            else if (arg == "--team-size") {
+                options.teamSize = atoi(argv[++i]);
+                if (options.teamSize < 1) {
+                    cout << "Error: --team-size needs a positive number of fighters." << endl;
+                    return false;
+                }
+            }
+            else if (arg == "--target") {
+                if (!parseTargetRule(argv[++i], options.targetRule)) {
+                    cout << "Error: --target needs lowest or threat." << endl;
+                    return false;
+                }
+            }
+            else if (arg == "--levels") {
+                // Comma separated, e.g. 1,5,10
+                options.levels.clear();
+                string list = argv[++i];
+                size_t position = 0;
+                while (position <= list.size()) {
+                    size_t comma = list.find(',', position);
+                    if (comma == string::npos) {
+                        comma = list.size();
+                    }
+                    int level = atoi(list.substr(position, comma - position).c_str());
+                    if (level < 1) {
+                        cout << "Error: --levels needs positive levels, e.g. 1,5,10." << endl;
+                        return false;
+                    }
+                    options.levels.push_back(level);
+                    position = comma + 1;
+                }
+            }
+            else {
+                cout << "Error: Unknown argument " << arg << endl;
+                return false;
+            }
+        }
+        if (options.enabled && options.battles < 1) {
+            cout << "Error: --simulate needs a positive number of battles." << endl;
+            return false;
+        }
+        return true;
+    }
+
+    SimulationSummary runSimulation(Arena& arena, const Character& player1Template, const Character& player2Template,
+        ActionPolicy& policy1, ActionPolicy& policy2, int battles) {
+        SimulationSummary summary;
+        summary.battles = battles;
+        summary.player1Wins = 0;
+        summary.player2Wins = 0;
+        summary.totalTurns = 0;
+        summary.totalWinnerHealth = 0;
+
+        uint64_t seed = arena.getBattleSeed();
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < battles; ++i) {
+            arena.setBattleSeed(seed, static_cast<uint64_t>(i));
+            BattleResult result = arena.simulateBattle(player1Template, player2Template, policy1, policy2);
+            if (result.winner == 1) {
+                summary.player1Wins++;
+            }
+            else {
+                summary.player2Wins++;
+            }
+            summary.totalTurns += result.turns;
+            summary.totalWinnerHealth += result.winnerHealth;
+        }
+        auto end = chrono::steady_clock::now();
+        summary.elapsedSeconds = chrono::duration<double>(end - start).count();
+        return summary;
+    }
+
+    TeamSimulationSummary runTeamSimulation(Arena& arena, const vector<const Character*>& fighters, const vector<int>& teams,
+        const vector<ActionPolicy*>& policies, TargetRule rule, int battles) {
+        TeamSimulationSummary summary;
+        summary.battles = battles;
+        int teamCount = 0;
+        for (int team : teams) {
+            teamCount = max(teamCount, team + 1);
+        }
+        summary.teamWins.assign(teamCount, 0);
+        summary.draws = 0;
+        summary.totalTurns = 0;
+        summary.totalSurvivors = 0;
+
+        uint64_t seed = arena.getBattleSeed();
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < battles; ++i) {
+            arena.setBattleSeed(seed, static_cast<uint64_t>(i));
+            TeamBattleResult result = arena.simulateTeamBattle(fighters, teams, policies, rule);
+            if (result.winningTeam < 0) {
+                summary.draws++;
+            }
+            else {
+                summary.teamWins[result.winningTeam]++;
+            }
+            summary.totalTurns += result.turns;
+            summary.totalSurvivors += result.survivors;
+        }
+        auto end = chrono::steady_clock::now();
+        summary.elapsedSeconds = chrono::duration<double>(end - start).count();
+        return summary;
+    }
+
+    bool replayTrace(const SimulationOptions& options) {
+        BattleTraceReader reader;
+        if (!reader.open(options.replayFile)) {
+            cout << "Error: Could not read trace file " << options.replayFile << endl;
+            return false;
+        }
+        size_t battles = reader.getBattleCount();
+        if (options.replayBattle <= 0) {
+            // No battle selected: one summary line per battle
+            cout << "Trace contains " << battles << " battles" << endl;
+            for (size_t i = 0; i < battles; ++i) {
+                const TraceBattleRecord& record = reader.getBattle(i);
+                cout << i + 1 << ". " << reader.getName(record.nameOffset[1]) << " vs "
+                    << reader.getName(record.nameOffset[2]) << " in " << reader.getName(record.nameOffset[0])
+                    << ": " << record.turnCount << " turns, winner player " << static_cast<int>(record.winner)
+                    << " (seed " << record.seed << ", stream " << record.stream << ")" << endl;
+            }
+            return true;
+        }
+        if (static_cast<size_t>(options.replayBattle) > battles) {
+            cout << "Error: The trace has only " << battles << " battles." << endl;
+            return false;
+        }
+        reader.renderText(cout, options.replayBattle - 1, options.replayTurn);
+        return true;
+    }
+
+    void printSimulationSummary(const SimulationSummary& summary, const Character& player1, const Character& player2) {
+        double battles = summary.battles > 0 ? summary.battles : 1;
+        cout << "\n=== SIMULATION RESULTS ===" << endl;
+        cout << "Battles: " << summary.battles << endl;
+        cout << fixed << setprecision(2);
+        cout << player1.getName() << " (" << player1.getClassName() << ") wins: " << summary.player1Wins
+            << " (" << 100.0 * summary.player1Wins / battles << "%)" << endl;
+        cout << player2.getName() << " (" << player2.getClassName() << ") wins: " << summary.player2Wins
+            << " (" << 100.0 * summary.player2Wins / battles << "%)" << endl;
+        cout << "Average turns: " << summary.totalTurns / battles << endl;
+        cout << "Average winner health: " << summary.totalWinnerHealth / battles << endl;
+        cout << "Elapsed: " << summary.elapsedSeconds << " s";
+        if (summary.elapsedSeconds > 0) {
+            cout << " (" << setprecision(0) << summary.battles / summary.elapsedSeconds << " battles/s)";
+        }
+        cout << endl;
+        cout << "==========================" << endl;
+        cout.unsetf(ios::fixed);
+        cout << setprecision(6);
+    }
+
+    void printTeamSimulationSummary(const TeamSimulationSummary& summary, const vector<const Character*>& fighters,
+        const vector<int>& teams) {
+        const size_t TEAM_SUMMARY_ROWS = 20;
+        const size_t TEAM_SUMMARY_NAMES = 3; // Members named per team
+        double battles = summary.battles > 0 ? summary.battles : 1;
+        vector<vector<size_t>> members(summary.teamWins.size());
+        for (size_t i = 0; i < fighters.size(); ++i) {
+            members[teams[i]].push_back(i);
+        }
+        vector<int> order(summary.teamWins.size());
+        for (size_t team = 0; team < order.size(); ++team) {
+            order[team] = static_cast<int>(team);
+        }
+        stable_sort(order.begin(), order.end(), [&summary](int a, int b) { return summary.teamWins[a] > summary.teamWins[b]; });
+
+        cout << "\n=== TEAM BATTLE RESULTS ===" << endl;
+        cout << "Battles: " << summary.battles << endl;
+        cout << fixed << setprecision(2);
+        size_t rows = 0;
+        while (rows < order.size() && rows < TEAM_SUMMARY_ROWS && (summary.teamWins[order[rows]] > 0 || order.size() <= TEAM_SUMMARY_ROWS)) {
+            ++rows;
+        }
+        for (size_t row = 0; row < rows; ++row) {
+            const vector<size_t>& team = members[order[row]];
+            cout << "Team " << order[row] + 1 << " (";
+            for (size_t j = 0; j < team.size() && j < TEAM_SUMMARY_NAMES; ++j) {
+                cout << (j > 0 ? ", " : "") << fighters[team[j]]->getName();
+            }
+            if (team.size() > TEAM_SUMMARY_NAMES) {
+                cout << " and " << team.size() - TEAM_SUMMARY_NAMES << " more";
+            }
+            cout << ") wins: " << summary.teamWins[order[row]] << " (" << 100.0 * summary.teamWins[order[row]] / battles << "%)" << endl;
+        }
+        if (order.size() > rows) {
+            cout << "... " << order.size() - rows << " more teams" << endl;
+        }
+        cout << "Draws (no survivors): " << summary.draws << " (" << 100.0 * summary.draws / battles << "%)" << endl;
+        cout << "Average turns: " << summary.totalTurns / battles << endl;
+        cout << "Average fighters standing: " << summary.totalSurvivors / battles << endl;
+        cout << "Elapsed: " << summary.elapsedSeconds << " s";
+        if (summary.elapsedSeconds > 0) {
+            cout << " (" << setprecision(0) << summary.battles / summary.elapsedSeconds << " battles/s, "
+                << summary.totalTurns / summary.elapsedSeconds << " turns/s)";
+        }
+        cout << endl;
+        cout << "===========================" << endl;
+        cout.unsetf(ios::fixed);
+        cout << setprecision(6);
+    }
+} // namespace FantasyArena
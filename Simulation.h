@@ -0,0 +1,111 @@
+#pragma once
+#ifndef SIMULATION_H
+#define SIMULATION_H
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "Character.h"
+#include "Arena.h"
+#include "ActionPolicy.h"
+using namespace std;
+namespace FantasyArena {
+    // Command-line settings for a headless simulation run
+    struct SimulationOptions {
+        bool enabled;
+        int battles;
+        int player1Index;  // 1-based roster index
+        int player2Index;  // 1-based roster index
+        int arenaIndex;    // 1-based arena index
+        string policy1;
+        string policy2;
+        ConsoleMode consoleMode; // Battle output: quiet (default), summary, or every turn (slow)
+        bool batch;        // Use the structure-of-arrays batch engine
+        bool verify;       // Cross-check batch results against the scalar engine
+        bool damageTables; // Run batch duels on precomputed damage tables
+        string damageTableFile; // Load the damage tables from this file, or build and save them
+        string solveFile;  // Solve every roster matchup and write the tablebase to this file
+        string tablebaseFile; // Tablebase for the search policy and the perfect-play hints
+        bool instrument;   // Count battle events and time the battle phases
+        string instrumentFile; // Also append the instrumentation report to this file
+        string rosterFile; // Import the roster from this CSV file instead of the default characters
+        string rosterImageFile;   // Map the roster and arenas from this image instead
+        string rosterImageOutput; // Write the roster and arenas to this image and exit
+        string classesFile; // Load custom class definitions (ClassDefinitions.h) before anything else
+        string ratingsFile; // Load the character ratings from this file and save them after every rated battle
+        string traceFile;  // Record every simulated battle into this binary trace
+        string replayFile; // Print battles from a trace file instead of simulating
+        int replayBattle;  // 1-based battle to replay, 0 = list all battles
+        int replayTurn;    // First turn to print
+        bool hasSeed;      // --seed given; otherwise a fresh seed is drawn and printed
+        uint64_t seed;     // Battle i of a run uses stream i of this seed
+        int tournament;    // Battles per matchup of a round-robin tournament, 0 = no tournament
+        unsigned threads;  // Worker threads for tournaments and win rates, 0 = all cores
+        bool winRates;     // Monte Carlo win rate matrix over classes, levels and environments
+        double confidenceHalfWidth; // Win rate interval target, e.g. 0.02 for +/-2%
+        int maxBattles;    // Per win rate cell
+        vector<int> levels; // Levels of the win rate matrix
+        int teamBattles;   // Battles of a team or free-for-all run, 0 = none
+        int teamCount;     // Teams per battle
+        int teamSize;      // Fighters per team, 1 = free-for-all
+        TargetRule targetRule; // Which enemy the fighters of a team battle attack
+    };
+
+    // Aggregated outcome of many simulated battles
+    struct SimulationSummary {
+        int battles;
+        int player1Wins;
+        int player2Wins;
+        long long totalTurns;
+        long long totalWinnerHealth;
+        double elapsedSeconds;
+    };
+
+    SimulationOptions defaultSimulationOptions();
+    // Parse "--simulate N --p1 I --p2 J --arena K --policy1 P --policy2 Q --verbose|--summary|--quiet"
+    // plus "--batch" and "--verify" for the batch engine, "--tables [--table-file FILE]"
+    // for the damage table engine, "--trace FILE" to record
+    // and "--replay FILE [--battle N] [--turn T]" to read a trace back.
+    // "--roster FILE" imports the characters from a CSV file, "--write-image FILE"
+    // compiles them into a roster image and "--roster-image FILE" maps one.
+    // "--classes FILE" adds the classes defined in FILE. "--ratings FILE" keeps
+    // the ratings of tournaments and interactive battles in FILE.
+    // "--stats [--stats-file FILE]" reports counters and phase timers.
+    // "--solve FILE" writes the tablebase, "--tablebase FILE" uses it.
+    // "--seed S" makes a run reproducible. "--tournament N [--threads T]" runs
+    // a round robin with N battles per matchup. "--winrates [--ci W]
+    // [--max-battles N] [--levels 1,5,10]" computes the win rate matrix.
+    // "--team-battle N [--teams T] [--team-size K] [--target lowest|threat]"
+    // fights N battles of T teams of K fighters (K = 1: free-for-all).
+    // Returns false and prints a message when the arguments are invalid.
+    bool parseSimulationOptions(int argc, char* argv[], SimulationOptions& options);
+
+    // Run a number of battles between fresh copies of the two templates.
+    // The templates themselves are never modified. Battle i runs on stream i
+    // of the arena's current seed.
+    SimulationSummary runSimulation(Arena& arena, const Character& player1Template, const Character& player2Template,
+        ActionPolicy& policy1, ActionPolicy& policy2, int battles);
+
+    // Aggregated outcome of many team or free-for-all battles
+    struct TeamSimulationSummary {
+        int battles;
+        vector<int> teamWins; // By team
+        int draws;            // Battles in which no fighter survived
+        long long totalTurns;
+        long long totalSurvivors;
+        double elapsedSeconds;
+    };
+
+    // Run team battles between fresh copies of the fighters (see
+    // Arena::simulateTeamBattle); battle i runs on stream i of the arena's seed
+    TeamSimulationSummary runTeamSimulation(Arena& arena, const vector<const Character*>& fighters, const vector<int>& teams,
+        const vector<ActionPolicy*>& policies, TargetRule rule, int battles);
+
+    // Render battles from a trace file written with --trace
+    bool replayTrace(const SimulationOptions& options);
+
+    void printSimulationSummary(const SimulationSummary& summary, const Character& player1, const Character& player2);
+    // Teams by wins; of many teams, only the first winners are listed
+    void printTeamSimulationSummary(const TeamSimulationSummary& summary, const vector<const Character*>& fighters,
+        const vector<int>& teams);
+} // namespace FantasyArena
+#endif // SIMULATION_H
@@ -0,0 +1,51 @@
+#include "StatTables.h"
+#include <sstream>
+using namespace std;
+namespace FantasyArena {
+    // One "Increases attack by 20%" clause; the first clause is capitalised
+    static void appendChange(string& text, const string& stats, int percent) {
+        string verb = percent > 100 ? "increases" : "reduces";
+        if (text.empty()) {
+            verb[0] = static_cast<char>(verb[0] - 'a' + 'A');
+        }
+        else {
+            text += ", ";
+        }
+        text += verb + " " + stats + " by " + to_string(percent > 100 ? percent - 100 : 100 - percent) + "%";
+    }
+
+    string describeEnvironmentModifiers(EnvironmentType environmentType) {
+        const EnvironmentModifiers& modifiers = getEnvironmentModifiers(environmentType);
+        string text;
+        if (modifiers.attackPercent != 100 && modifiers.attackPercent == modifiers.defensePercent) {
+            appendChange(text, "attack and defense", modifiers.attackPercent);
+        }
+        else {
+            if (modifiers.attackPercent != 100) {
+                appendChange(text, "attack", modifiers.attackPercent);
+            }
+            if (modifiers.defensePercent != 100) {
+                appendChange(text, "defense", modifiers.defensePercent);
+            }
+        }
+        if (modifiers.healthPercent != 100) {
+            appendChange(text, "health", modifiers.healthPercent);
+        }
+        return text;
+    }
+
+    string formatEnvironmentMultipliers(EnvironmentType environmentType) {
+        const EnvironmentModifiers& modifiers = getEnvironmentModifiers(environmentType);
+        ostringstream text;
+        const char* separator = "";
+        const pair<const char*, int> stats[] = { { "attack", modifiers.attackPercent },
+            { "defense", modifiers.defensePercent }, { "health", modifiers.healthPercent } };
+        for (const pair<const char*, int>& stat : stats) {
+            if (stat.second != 100) {
+                text << separator << stat.first << " x" << stat.second / 100.0;
+                separator = ", ";
+            }
+        }
+        return text.str();
+    }
+} // namespace FantasyArena
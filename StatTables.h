@@ -0,0 +1,118 @@
+#pragma once
+#ifndef STAT_TABLES_H
+#define STAT_TABLES_H
+#include <string>
+#include "Character.h"
+#include "Arena.h"
+using namespace std;
+namespace FantasyArena {
+    // Base stats, growth per level and ability cooldown of one class
+    struct ClassStats {
+        const char* className;
+        const char* abilityName;
+        int baseHealth;
+        int healthPerLevel;
+        int baseAttack;
+        int attackPerLevel;
+        int baseDefense;
+        int defensePerLevel;
+        int cooldown;
+    };
+
+    // Indexed by CharacterKind
+    constexpr ClassStats CLASS_STATS[CHARACTER_KIND_COUNT] = {
+        { "Warrior",            "Transparent",  100, 20, 15, 3, 10, 2, 3 },
+        { "Mage",               "Mirror Image",  70, 15, 20, 3,  5, 1, 3 },
+        { "Archer",             "Evasive Roll",  80, 15, 18, 3,  7, 2, 3 },
+        { "LegendaryCharacter", "Resurrection", 120, 25, 22, 4, 12, 2, 0 }, // Passive ability, no cooldown
+        { "MirrorStriker",      "Mirror Strike", 90, 18, 16, 3,  9, 2, 3 }
+    };
+
+    // Stats of a freshly created character
+    struct StatBlock {
+        int health;
+        int attack;
+        int defense;
+        int cooldown;
+    };
+
+    constexpr StatBlock computeStatBlock(CharacterKind kind, int level) {
+        const ClassStats& stats = CLASS_STATS[static_cast<int>(kind)];
+        return { stats.baseHealth + level * stats.healthPerLevel, stats.baseAttack + level * stats.attackPerLevel,
+            stats.baseDefense + level * stats.defensePerLevel, stats.cooldown };
+    }
+
+    // Every class at every level up to MAX_TABLE_LEVEL, generated at compile time
+    const int MAX_TABLE_LEVEL = 100;
+    struct StatBlockTable {
+        StatBlock blocks[CHARACTER_KIND_COUNT][MAX_TABLE_LEVEL + 1];
+    };
+    constexpr StatBlockTable makeStatBlockTable() {
+        StatBlockTable table = {};
+        for (int kind = 0; kind < CHARACTER_KIND_COUNT; ++kind) {
+            for (int level = 0; level <= MAX_TABLE_LEVEL; ++level) {
+                table.blocks[kind][level] = computeStatBlock(static_cast<CharacterKind>(kind), level);
+            }
+        }
+        return table;
+    }
+    inline constexpr StatBlockTable STAT_BLOCKS = makeStatBlockTable();
+
+    constexpr StatBlock getStatBlock(CharacterKind kind, int level) {
+        return (level >= 0 && level <= MAX_TABLE_LEVEL) ? STAT_BLOCKS.blocks[static_cast<int>(kind)][level]
+            : computeStatBlock(kind, level);
+    }
+
+    // Battle-start multipliers of one environment, in percent
+    struct EnvironmentModifiers {
+        const char* name;
+        int attackPercent;
+        int defensePercent;
+        int healthPercent;
+    };
+
+    // Indexed by EnvironmentType
+    constexpr EnvironmentModifiers ENVIRONMENT_MODIFIERS[] = {
+        { "Fire",     120,  90, 100 },
+        { "Ice",       90, 120, 100 },
+        { "Jungle",   110, 110, 100 },
+        { "Desert",   130, 100,  90 },
+        { "Mountain",  80, 140, 100 }
+    };
+    const int ENVIRONMENT_COUNT = 5;
+
+    constexpr const EnvironmentModifiers& getEnvironmentModifiers(EnvironmentType environmentType) {
+        return ENVIRONMENT_MODIFIERS[static_cast<int>(environmentType)];
+    }
+
+    // Exact integer form of "value * percent%" truncated toward zero
+    constexpr int applyPercent(int value, int percent) {
+        return static_cast<int>(static_cast<long long>(value) * percent / 100);
+    }
+
+    // Damage formula of the attackTarget overrides: Warrior ignores half of the
+    // defense, Archer three quarters (and half of the rest from Evasive Roll),
+    // everyone else two thirds; at least 1
+    constexpr int attackDamage(CharacterKind attacker, int attack, int defense, bool evasive) {
+        int effective = evasive ? defense / 2 : defense;
+        int reduction = attacker == CharacterKind::WARRIOR ? effective / 2 :
+            attacker == CharacterKind::ARCHER ? effective / 4 : effective / 3;
+        return attack - reduction < 1 ? 1 : attack - reduction;
+    }
+
+    // "Increases attack by 20%, reduces defense by 10%"
+    string describeEnvironmentModifiers(EnvironmentType environmentType);
+    // "attack x1.2, defense x0.9"
+    string formatEnvironmentMultipliers(EnvironmentType environmentType);
+
+    static_assert(getStatBlock(CharacterKind::WARRIOR, 5).health == 200, "Warrior stat table changed");
+    static_assert(getStatBlock(CharacterKind::MAGE, 6).attack == 38, "Mage stat table changed");
+    static_assert(getStatBlock(CharacterKind::ARCHER, 4).defense == 15, "Archer stat table changed");
+    static_assert(getStatBlock(CharacterKind::LEGENDARY, 5).cooldown == 0, "Legendary stat table changed");
+    static_assert(attackDamage(CharacterKind::ARCHER, 30, 20, true) == 28 && attackDamage(CharacterKind::MAGE, 5, 40, false) == 1,
+        "attackDamage formula changed");
+    static_assert(applyPercent(45, 140) == 63 && applyPercent(200, 90) == 180, "applyPercent must truncate exactly");
+    static_assert(sizeof(ENVIRONMENT_MODIFIERS) / sizeof(ENVIRONMENT_MODIFIERS[0]) == ENVIRONMENT_COUNT,
+        "One modifier row per EnvironmentType");
+} // namespace FantasyArena
+#endif // STAT_TABLES_H
@@ -0,0 +1,401 @@
+#include "Tablebase.h"
+#include <fstream>
+#include <cstring>
+#include <chrono>
+#include <algorithm>
+using namespace std;
+namespace FantasyArena {
+    static const char TABLEBASE_MAGIC[4] = { 'F', 'A', 'T', 'B' };
+    // Solver-only state of a value byte; the low nibble is what gets stored
+    static const uint8_t VALUE_SOLVED = 0x80;
+    static const uint8_t VALUE_IN_PROGRESS = 0x40;
+    static const uint8_t VALUE_ABILITY = 0x04;
+
+    string getTablebaseOutcomeName(TablebaseOutcome outcome) {
+        switch (outcome) {
+        case TablebaseOutcome::WIN:
+            return "win";
+        case TablebaseOutcome::LOSS:
+            return "loss";
+        case TablebaseOutcome::DRAW:
+            return "draw";
+        default:
+            return "unknown";
+        }
+    }
+
+    // State encoding. A fighter is (health, cooldown, flags); the flags are
+    // only the ones its class can have: "ability ready" for a fighter whose
+    // cooldown is 0 (otherwise ready means cooldown 0), "revived" for the
+    // Legendary and "ability active" for a waiting Warrior, Mage or
+    // MirrorStriker. The fighter to move never has an active ability.
+    static bool hasActiveFlag(CharacterKind kind, bool toMove) {
+        return !toMove && (kind == CharacterKind::WARRIOR || kind == CharacterKind::MAGE ||
+            kind == CharacterKind::MIRROR_STRIKER);
+    }
+
+    struct FlagDims {
+        uint64_t ready;
+        uint64_t revived;
+        uint64_t active;
+    };
+
+    static FlagDims flagDims(const TablebaseFighter& fighter, bool toMove) {
+        CharacterKind kind = static_cast<CharacterKind>(fighter.kind);
+        return { fighter.cooldownLength == 0 ? 2u : 1u, kind == CharacterKind::LEGENDARY ? 2u : 1u,
+            hasActiveFlag(kind, toMove) ? 2u : 1u };
+    }
+
+    static uint64_t fighterSlots(const TablebaseFighter& fighter, bool toMove) {
+        FlagDims dims = flagDims(fighter, toMove);
+        return static_cast<uint64_t>(fighter.healthCap) * (fighter.cooldownLength + 1) * dims.ready * dims.revived * dims.active;
+    }
+
+    static bool encodeFighter(const TablebaseFighter& profile, const ModelFighter& fighter, bool toMove, uint64_t& slot) {
+        FlagDims dims = flagDims(profile, toMove);
+        if (fighter.health < 1 || fighter.health > profile.healthCap ||
+            fighter.cooldown < 0 || fighter.cooldown > profile.cooldownLength ||
+            (dims.ready == 1 && fighter.abilityReady != (fighter.cooldown == 0)) ||
+            (dims.revived == 1 && fighter.revived) || (dims.active == 1 && fighter.abilityActive)) {
+            return false;
+        }
+        uint64_t flags = (dims.ready == 2 && fighter.abilityReady ? 1 : 0) +
+            dims.ready * ((fighter.revived ? 1 : 0) + dims.revived * (fighter.abilityActive ? 1 : 0));
+        slot = static_cast<uint64_t>(fighter.health - 1) +
+            static_cast<uint64_t>(profile.healthCap) * (fighter.cooldown + (profile.cooldownLength + 1) * flags);
+        return true;
+    }
+
+    static ModelFighter decodeFighter(const TablebaseFighter& profile, bool toMove, uint64_t slot) {
+        FlagDims dims = flagDims(profile, toMove);
+        ModelFighter fighter;
+        fighter.kind = static_cast<CharacterKind>(profile.kind);
+        fighter.classId = static_cast<uint8_t>(profile.kind);
+        fighter.customClass = nullptr;
+        fighter.maxHealth = profile.maxHealth;
+        fighter.attack = profile.attack;
+        fighter.defense = profile.defense;
+        fighter.cooldownLength = profile.cooldownLength;
+        fighter.health = static_cast<int32_t>(slot % profile.healthCap) + 1;
+        slot /= profile.healthCap;
+        fighter.cooldown = static_cast<int32_t>(slot % (profile.cooldownLength + 1));
+        uint64_t flags = slot / (profile.cooldownLength + 1);
+        fighter.abilityReady = dims.ready == 2 ? (flags % 2 == 1) : fighter.cooldown == 0;
+        flags /= dims.ready;
+        fighter.revived = (flags % dims.revived) == 1;
+        flags /= dims.revived;
+        fighter.abilityActive = flags == 1;
+        return fighter;
+    }
+
+    static bool sameProfile(const TablebaseFighter& profile, const ModelFighter& fighter) {
+        return profile.kind == static_cast<int32_t>(fighter.kind) && profile.maxHealth == fighter.maxHealth &&
+            profile.attack == fighter.attack && profile.defense == fighter.defense &&
+            profile.cooldownLength == fighter.cooldownLength;
+    }
+
+    static uint64_t mixKey(uint64_t hash, uint64_t value) {
+        hash ^= value + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+        hash *= 0xBF58476D1CE4E5B9ull;
+        return hash ^ (hash >> 29);
+    }
+
+    static uint64_t profileKey(int32_t kind, int32_t maxHealth, int32_t attack, int32_t defense, int32_t cooldownLength) {
+        uint64_t hash = mixKey(0, static_cast<uint32_t>(kind));
+        hash = mixKey(hash, static_cast<uint32_t>(maxHealth));
+        hash = mixKey(hash, static_cast<uint32_t>(attack));
+        hash = mixKey(hash, static_cast<uint32_t>(defense));
+        return mixKey(hash, static_cast<uint32_t>(cooldownLength));
+    }
+
+    static uint64_t matchupKey(const TablebaseFighter& toMove, const TablebaseFighter& waiting) {
+        return mixKey(profileKey(toMove.kind, toMove.maxHealth, toMove.attack, toMove.defense, toMove.cooldownLength),
+            profileKey(waiting.kind, waiting.maxHealth, waiting.attack, waiting.defense, waiting.cooldownLength));
+    }
+
+    static uint64_t matchupKey(const ModelFighter& toMove, const ModelFighter& waiting) {
+        return mixKey(profileKey(static_cast<int32_t>(toMove.kind), toMove.maxHealth, toMove.attack, toMove.defense, toMove.cooldownLength),
+            profileKey(static_cast<int32_t>(waiting.kind), waiting.maxHealth, waiting.attack, waiting.defense, waiting.cooldownLength));
+    }
+
+    // Solves both tables of one matchup. Battles always end (every few turns
+    // someone takes damage and resurrection happens once), so the states form
+    // a DAG and each state is resolved after all of its successors.
+    class TablebaseSolver {
+    private:
+        TablebaseFighter fighters[2];
+        vector<uint8_t> values[2]; // values[i]: fighters[i] to move
+
+        uint64_t waitingSlots(int side) const {
+            return fighterSlots(fighters[1 - side], false);
+        }
+
+        ModelState decode(int side, uint64_t index) const {
+            uint64_t slots = waitingSlots(side);
+            return { decodeFighter(fighters[side], true, index / slots), decodeFighter(fighters[1 - side], false, index % slots) };
+        }
+
+        bool encode(int side, const ModelState& state, uint64_t& index) const {
+            uint64_t moverSlot;
+            uint64_t waitingSlot;
+            if (!encodeFighter(fighters[side], state.toMove, true, moverSlot) ||
+                !encodeFighter(fighters[1 - side], state.waiting, false, waitingSlot)) {
+                return false;
+            }
+            index = moverSlot * waitingSlots(side) + waitingSlot;
+            return true;
+        }
+
+        static TablebaseOutcome opposite(TablebaseOutcome outcome) {
+            return outcome == TablebaseOutcome::WIN ? TablebaseOutcome::LOSS :
+                outcome == TablebaseOutcome::LOSS ? TablebaseOutcome::WIN : outcome;
+        }
+
+        static int rank(TablebaseOutcome outcome) {
+            return outcome == TablebaseOutcome::WIN ? 2 : outcome == TablebaseOutcome::DRAW ? 1 : 0;
+        }
+
+        TablebaseOutcome solve(int side, uint64_t index) {
+            uint8_t& value = values[side][index];
+            if (value & VALUE_SOLVED) {
+                return static_cast<TablebaseOutcome>(value & 3);
+            }
+            if (value & VALUE_IN_PROGRESS) {
+                return TablebaseOutcome::DRAW; // Unreachable for the combat rules; a cycle would never end
+            }
+            value = VALUE_IN_PROGRESS;
+            ModelState state = decode(side, index);
+            BattleAction moves[2] = { BattleAction::ATTACK, BattleAction::SPECIAL_ABILITY };
+            int moveCount = state.toMove.abilityReady ? 2 : 1;
+            TablebaseOutcome best = TablebaseOutcome::UNKNOWN;
+            BattleAction bestMove = BattleAction::ATTACK;
+            for (int i = 0; i < moveCount; ++i) {
+                ModelState child = state;
+                ModelOutcome outcome = applyModelAction(child, moves[i]);
+                TablebaseOutcome result;
+                uint64_t childIndex;
+                switch (outcome) {
+                case ModelOutcome::ACTOR_WINS:
+                    result = TablebaseOutcome::WIN;
+                    break;
+                case ModelOutcome::ACTOR_LOSES:
+                    result = TablebaseOutcome::LOSS;
+                    break;
+                case ModelOutcome::DRAW:
+                    result = TablebaseOutcome::DRAW;
+                    break;
+                default:
+                    result = encode(1 - side, child, childIndex) ? opposite(solve(1 - side, childIndex)) : TablebaseOutcome::DRAW;
+                    break;
+                }
+                if (best == TablebaseOutcome::UNKNOWN || rank(result) > rank(best)) {
+                    best = result;
+                    bestMove = moves[i];
+                }
+            }
+            value = VALUE_SOLVED | static_cast<uint8_t>(best) |
+                (bestMove == BattleAction::SPECIAL_ABILITY ? VALUE_ABILITY : 0);
+            return best;
+        }
+    public:
+        TablebaseSolver(const TablebaseFighter& first, const TablebaseFighter& second) {
+            fighters[0] = first;
+            fighters[1] = second;
+        }
+
+        uint64_t getStateCount(int side) const {
+            return fighterSlots(fighters[side], true) * waitingSlots(side);
+        }
+
+        // Solve both tables and pack each into 4 bits per state
+        void run(vector<uint8_t> packed[2]) {
+            for (int side = 0; side < 2; ++side) {
+                values[side].assign(getStateCount(side), 0);
+            }
+            for (int side = 0; side < 2; ++side) {
+                for (uint64_t index = 0; index < values[side].size(); ++index) {
+                    solve(side, index);
+                }
+            }
+            for (int side = 0; side < 2; ++side) {
+                packed[side].assign((values[side].size() + 1) / 2, 0);
+                for (uint64_t index = 0; index < values[side].size(); ++index) {
+                    uint8_t nibble = values[side][index] & 0x0F;
+                    packed[side][index / 2] |= (index % 2 == 0) ? nibble : static_cast<uint8_t>(nibble << 4);
+                }
+                vector<uint8_t>().swap(values[side]);
+            }
+        }
+    };
+
+    static TablebaseFighter profileOf(const Character& character, const Arena& arena) {
+        // Stats of a fresh copy after the arena's modifiers, as at the start of a battle
+        Character* fighter = character.clone();
+        arena.applyEnvironmentModifiers(*fighter);
+        TablebaseFighter profile;
+        profile.kind = static_cast<int32_t>(fighter->getKind());
+        profile.maxHealth = fighter->getMaxHealth();
+        profile.attack = fighter->getAttack();
+        profile.defense = fighter->getDefense();
+        profile.cooldownLength = fighter->getSpecialAbilityCooldown();
+        profile.healthCap = max(fighter->getHealth(), fighter->getMaxHealth() / 4);
+        delete fighter;
+        return profile;
+    }
+
+    bool buildTablebase(const vector<Character*>& roster, const vector<Arena>& arenas, const string& path, ostream& log) {
+        // Distinct matchups; two profiles that only differ in the health cap share the larger one
+        vector<TablebaseMatchupRecord> records;
+        unordered_map<uint64_t, size_t> seen;
+        for (const Arena& arena : arenas) {
+            for (size_t i = 0; i < roster.size(); ++i) {
+                for (size_t j = i + 1; j < roster.size(); ++j) {
+                    TablebaseFighter first = profileOf(*roster[i], arena);
+                    TablebaseFighter second = profileOf(*roster[j], arena);
+                    auto found = seen.find(matchupKey(first, second));
+                    if (found == seen.end()) {
+                        found = seen.find(matchupKey(second, first));
+                        swap(first, second);
+                    }
+                    if (found != seen.end()) {
+                        TablebaseMatchupRecord& record = records[found->second];
+                        record.fighters[0].healthCap = max(record.fighters[0].healthCap, first.healthCap);
+                        record.fighters[1].healthCap = max(record.fighters[1].healthCap, second.healthCap);
+                        continue;
+                    }
+                    TablebaseMatchupRecord record;
+                    memset(&record, 0, sizeof(record));
+                    record.fighters[0] = first;
+                    record.fighters[1] = second;
+                    seen.emplace(matchupKey(first, second), records.size());
+                    records.push_back(record);
+                }
+            }
+        }
+
+        ofstream out(path, ios::binary | ios::trunc);
+        if (!out.is_open()) {
+            return false;
+        }
+        TablebaseHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, TABLEBASE_MAGIC, sizeof(TABLEBASE_MAGIC));
+        header.version = TABLEBASE_FORMAT_VERSION;
+        header.matchupCount = records.size();
+        // Placeholders, rewritten once every table's offset is known
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(records.data()), static_cast<streamsize>(records.size() * sizeof(TablebaseMatchupRecord)));
+
+        uint64_t offset = sizeof(TablebaseHeader) + records.size() * sizeof(TablebaseMatchupRecord);
+        for (size_t m = 0; m < records.size(); ++m) {
+            TablebaseMatchupRecord& record = records[m];
+            auto start = chrono::steady_clock::now();
+            TablebaseSolver solver(record.fighters[0], record.fighters[1]);
+            vector<uint8_t> packed[2];
+            solver.run(packed);
+            for (int side = 0; side < 2; ++side) {
+                record.tableOffset[side] = offset;
+                record.stateCount[side] = solver.getStateCount(side);
+                header.stateCount += record.stateCount[side];
+                out.write(reinterpret_cast<const char*>(packed[side].data()), static_cast<streamsize>(packed[side].size()));
+                offset += packed[side].size();
+            }
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            log << "Matchup " << m + 1 << "/" << records.size() << ": "
+                << getClassNameForKind(static_cast<CharacterKind>(record.fighters[0].kind)) << " (" << record.fighters[0].maxHealth << " HP) vs "
+                << getClassNameForKind(static_cast<CharacterKind>(record.fighters[1].kind)) << " (" << record.fighters[1].maxHealth << " HP), "
+                << record.stateCount[0] + record.stateCount[1] << " states in " << seconds << " s" << endl;
+        }
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(records.data()), static_cast<streamsize>(records.size() * sizeof(TablebaseMatchupRecord)));
+        return out.good();
+    }
+
+    // Tablebase implementation
+    Tablebase::Tablebase() : header(nullptr), matchups(nullptr) {
+    }
+
+    bool Tablebase::open(const string& path) {
+        close();
+        if (!file.open(path) || file.size() < sizeof(TablebaseHeader)) {
+            file.close();
+            return false;
+        }
+        const TablebaseHeader* candidate = reinterpret_cast<const TablebaseHeader*>(file.getData());
+        uint64_t directoryEnd = sizeof(TablebaseHeader) + candidate->matchupCount * sizeof(TablebaseMatchupRecord);
+        if (memcmp(candidate->magic, TABLEBASE_MAGIC, sizeof(TABLEBASE_MAGIC)) != 0 ||
+            candidate->version != TABLEBASE_FORMAT_VERSION || candidate->matchupCount > file.size() || directoryEnd > file.size()) {
+            file.close();
+            return false;
+        }
+        const TablebaseMatchupRecord* records = reinterpret_cast<const TablebaseMatchupRecord*>(file.getData() + sizeof(TablebaseHeader));
+        for (size_t m = 0; m < candidate->matchupCount; ++m) {
+            const TablebaseMatchupRecord& record = records[m];
+            for (int side = 0; side < 2; ++side) {
+                // Every table must lie inside the mapping and match its profiles
+                const TablebaseFighter& mover = record.fighters[side];
+                const TablebaseFighter& waiting = record.fighters[1 - side];
+                if (mover.healthCap < 1 || waiting.healthCap < 1 || mover.cooldownLength < 0 || waiting.cooldownLength < 0 ||
+                    record.stateCount[side] != fighterSlots(mover, true) * fighterSlots(waiting, false) ||
+                    record.tableOffset[side] < directoryEnd || record.tableOffset[side] + (record.stateCount[side] + 1) / 2 > file.size()) {
+                    close();
+                    return false;
+                }
+                index.emplace(matchupKey(mover, waiting), m * 2 + side);
+            }
+        }
+        header = candidate;
+        matchups = records;
+        return true;
+    }
+
+    void Tablebase::close() {
+        header = nullptr;
+        matchups = nullptr;
+        index.clear();
+        file.close();
+    }
+
+    bool Tablebase::isOpen() const {
+        return header != nullptr;
+    }
+
+    size_t Tablebase::getMatchupCount() const {
+        return header ? static_cast<size_t>(header->matchupCount) : 0;
+    }
+
+    uint64_t Tablebase::getStateCount() const {
+        return header ? header->stateCount : 0;
+    }
+
+    bool Tablebase::probe(const ModelState& state, TablebaseProbe& result) const {
+        if (!header) {
+            return false;
+        }
+        auto found = index.find(matchupKey(state.toMove, state.waiting));
+        if (found == index.end()) {
+            return false;
+        }
+        const TablebaseMatchupRecord& record = matchups[found->second / 2];
+        int side = static_cast<int>(found->second % 2);
+        const TablebaseFighter& mover = record.fighters[side];
+        const TablebaseFighter& waiting = record.fighters[1 - side];
+        uint64_t moverSlot;
+        uint64_t waitingSlot;
+        if (!sameProfile(mover, state.toMove) || !sameProfile(waiting, state.waiting) ||
+            !encodeFighter(mover, state.toMove, true, moverSlot) || !encodeFighter(waiting, state.waiting, false, waitingSlot)) {
+            return false;
+        }
+        uint64_t stateIndex = moverSlot * fighterSlots(waiting, false) + waitingSlot;
+        uint8_t packed = file.getData()[record.tableOffset[side] + stateIndex / 2];
+        uint8_t nibble = (stateIndex % 2 == 0) ? (packed & 0x0F) : (packed >> 4);
+        result.outcome = static_cast<TablebaseOutcome>(nibble & 3);
+        result.bestAction = (nibble & VALUE_ABILITY) ? BattleAction::SPECIAL_ABILITY : BattleAction::ATTACK;
+        return result.outcome != TablebaseOutcome::UNKNOWN;
+    }
+
+    bool Tablebase::probe(const Character& self, const Character& opponent, TablebaseProbe& result) const {
+        return probe(makeModelState(self, opponent), result);
+    }
+} // namespace FantasyArena
@@ -0,0 +1,94 @@
+#pragma once
+#ifndef TABLEBASE_H
+#define TABLEBASE_H
+#include <string>
+#include <vector>
+#include <iostream>
+#include <unordered_map>
+#include <cstdint>
+#include "Character.h"
+#include "Arena.h"
+#include "CombatModel.h"
+#include "MappedFile.h"
+using namespace std;
+namespace FantasyArena {
+    // Result with perfect play on both sides, for the fighter to move
+    enum class TablebaseOutcome : uint8_t {
+        UNKNOWN,
+        WIN,
+        LOSS,
+        DRAW     // Both fighters die in the same turn
+    };
+
+    struct TablebaseProbe {
+        TablebaseOutcome outcome;
+        BattleAction bestAction;
+    };
+
+    // Combat profile of one side of a solved matchup. Probes match on these
+    // values, so a table only answers for fighters with exactly these stats.
+    struct TablebaseFighter {
+        int32_t kind;
+        int32_t maxHealth;
+        int32_t attack;
+        int32_t defense;
+        int32_t cooldownLength;
+        int32_t healthCap;     // Highest health a state can have
+    };
+    static_assert(sizeof(TablebaseFighter) == 24, "TablebaseFighter layout changed");
+
+    // Two tables per matchup, one for each fighter to move. Each state takes
+    // 4 bits: the outcome in bits 0-1 and "use the ability" in bit 2.
+    struct TablebaseMatchupRecord {
+        TablebaseFighter fighters[2];
+        uint64_t tableOffset[2];  // File offset of the table with fighters[i] to move
+        uint64_t stateCount[2];
+    };
+    static_assert(sizeof(TablebaseMatchupRecord) == 80, "TablebaseMatchupRecord layout changed");
+
+    // File layout: header, matchup directory, state tables
+    struct TablebaseHeader {
+        char magic[4];          // "FATB"
+        uint32_t version;
+        uint64_t matchupCount;
+        uint64_t stateCount;    // Over all tables
+        uint64_t reserved;
+    };
+    static_assert(sizeof(TablebaseHeader) == 32, "TablebaseHeader layout changed");
+
+    const uint32_t TABLEBASE_FORMAT_VERSION = 1;
+
+    // Solved outcomes of whole matchups, memory-mapped read-only. A probe is
+    // a hash lookup of the two profiles plus one table read.
+    class Tablebase {
+    private:
+        MappedFile file;
+        const TablebaseHeader* header;
+        const TablebaseMatchupRecord* matchups;
+        // Profiles of (fighter to move, waiting fighter) -> matchup * 2 + side
+        unordered_map<uint64_t, size_t> index;
+    public:
+        Tablebase();
+        Tablebase(const Tablebase&) = delete;
+        Tablebase& operator=(const Tablebase&) = delete;
+
+        bool open(const string& path);
+        void close();
+        bool isOpen() const;
+        size_t getMatchupCount() const;
+        uint64_t getStateCount() const;
+
+        // False if the two fighters are not a solved matchup or the state is outside it
+        bool probe(const ModelState& state, TablebaseProbe& result) const;
+        bool probe(const Character& self, const Character& opponent, TablebaseProbe& result) const;
+    };
+
+    // Solve every pair of roster characters in every arena and write the
+    // tablebase. Every state of each matchup is solved by backward induction
+    // from the finished battles, so any position reached in play can be probed.
+    // Pairs with identical profiles are solved once. Progress goes to `log`.
+    bool buildTablebase(const vector<Character*>& roster, const vector<Arena>& arenas, const string& path, ostream& log);
+
+    string getTablebaseOutcomeName(TablebaseOutcome outcome);
+} // namespace FantasyArena
+#endif // TABLEBASE_H
@@ -0,0 +1,192 @@
+#include "TeamBattle.h"
+#include <algorithm>
+using namespace std;
+namespace FantasyArena {
+    bool parseTargetRule(const string& text, TargetRule& rule) {
+        if (text == "lowest") {
+            rule = TargetRule::LOWEST_HEALTH;
+        }
+        else if (text == "threat") {
+            rule = TargetRule::HIGHEST_THREAT;
+        }
+        else {
+            return false;
+        }
+        return true;
+    }
+
+    string getTargetRuleName(TargetRule rule) {
+        return rule == TargetRule::LOWEST_HEALTH ? "lowest health" : "highest threat";
+    }
+
+    int64_t targetKey(TargetRule rule, int health, int attack) {
+        if (rule == TargetRule::LOWEST_HEALTH) {
+            return health;
+        }
+        // Attack in the high half, so health only breaks ties
+        return -(static_cast<int64_t>(attack) << 32) + health;
+    }
+
+    // InitiativeQueue implementation
+    void InitiativeQueue::schedule(uint32_t fighter, int64_t time) {
+        heap.push_back({ time, fighter });
+        push_heap(heap.begin(), heap.end(), later);
+    }
+
+    uint32_t InitiativeQueue::next(int64_t& time) {
+        pop_heap(heap.begin(), heap.end(), later);
+        Entry entry = heap.back();
+        heap.pop_back();
+        time = entry.time;
+        return entry.fighter;
+    }
+
+    // TargetIndex implementation
+    void TargetIndex::build(const vector<int>& fighterTeams, const vector<int64_t>& fighterKeys,
+        const vector<uint32_t>& fighterTieOrder) {
+        keys = fighterKeys;
+        tieOrder = fighterTieOrder;
+        teamOf.assign(fighterTeams.begin(), fighterTeams.end());
+        slot.assign(keys.size(), NONE);
+        uint32_t teamCount = 0;
+        for (int team : fighterTeams) {
+            teamCount = max(teamCount, static_cast<uint32_t>(team) + 1);
+        }
+        teams.assign(teamCount, vector<uint32_t>());
+        for (uint32_t fighter = 0; fighter < keys.size(); ++fighter) {
+            teams[teamOf[fighter]].push_back(fighter);
+        }
+        leaders.clear();
+        leaderSlot.assign(teamCount, NONE);
+        for (uint32_t team = 0; team < teamCount; ++team) {
+            vector<uint32_t>& members = teams[team];
+            if (members.empty()) {
+                continue;
+            }
+            make_heap(members.begin(), members.end(), [this](uint32_t a, uint32_t b) { return fighterBefore(b, a); });
+            for (size_t position = 0; position < members.size(); ++position) {
+                slot[members[position]] = static_cast<uint32_t>(position);
+            }
+            leaders.push_back(team);
+        }
+        make_heap(leaders.begin(), leaders.end(), [this](uint32_t a, uint32_t b) { return teamBefore(b, a); });
+        for (size_t position = 0; position < leaders.size(); ++position) {
+            leaderSlot[leaders[position]] = static_cast<uint32_t>(position);
+        }
+    }
+
+    void TargetIndex::siftFighter(uint32_t team, size_t position) {
+        vector<uint32_t>& heap = teams[team];
+        uint32_t fighter = heap[position];
+        // Up
+        while (position > 0 && fighterBefore(fighter, heap[(position - 1) / 2])) {
+            heap[position] = heap[(position - 1) / 2];
+            slot[heap[position]] = static_cast<uint32_t>(position);
+            position = (position - 1) / 2;
+        }
+        // Down
+        for (;;) {
+            size_t child = 2 * position + 1;
+            if (child >= heap.size()) {
+                break;
+            }
+            if (child + 1 < heap.size() && fighterBefore(heap[child + 1], heap[child])) {
+                ++child;
+            }
+            if (!fighterBefore(heap[child], fighter)) {
+                break;
+            }
+            heap[position] = heap[child];
+            slot[heap[position]] = static_cast<uint32_t>(position);
+            position = child;
+        }
+        heap[position] = fighter;
+        slot[fighter] = static_cast<uint32_t>(position);
+    }
+
+    void TargetIndex::siftTeam(size_t position) {
+        uint32_t team = leaders[position];
+        while (position > 0 && teamBefore(team, leaders[(position - 1) / 2])) {
+            leaders[position] = leaders[(position - 1) / 2];
+            leaderSlot[leaders[position]] = static_cast<uint32_t>(position);
+            position = (position - 1) / 2;
+        }
+        for (;;) {
+            size_t child = 2 * position + 1;
+            if (child >= leaders.size()) {
+                break;
+            }
+            if (child + 1 < leaders.size() && teamBefore(leaders[child + 1], leaders[child])) {
+                ++child;
+            }
+            if (!teamBefore(leaders[child], team)) {
+                break;
+            }
+            leaders[position] = leaders[child];
+            leaderSlot[leaders[position]] = static_cast<uint32_t>(position);
+            position = child;
+        }
+        leaders[position] = team;
+        leaderSlot[team] = static_cast<uint32_t>(position);
+    }
+
+    void TargetIndex::removeTeam(uint32_t team) {
+        size_t position = leaderSlot[team];
+        leaderSlot[team] = NONE;
+        uint32_t last = leaders.back();
+        leaders.pop_back();
+        if (last != team) {
+            leaders[position] = last;
+            siftTeam(position);
+        }
+    }
+
+    void TargetIndex::update(uint32_t fighter, int64_t key) {
+        if (slot[fighter] == NONE || keys[fighter] == key) {
+            return;
+        }
+        keys[fighter] = key;
+        uint32_t team = teamOf[fighter];
+        siftFighter(team, slot[fighter]);
+        siftTeam(leaderSlot[team]);
+    }
+
+    void TargetIndex::remove(uint32_t fighter) {
+        if (slot[fighter] == NONE) {
+            return;
+        }
+        uint32_t team = teamOf[fighter];
+        vector<uint32_t>& heap = teams[team];
+        size_t position = slot[fighter];
+        slot[fighter] = NONE;
+        uint32_t last = heap.back();
+        heap.pop_back();
+        if (heap.empty()) {
+            removeTeam(team);
+            return;
+        }
+        if (last != fighter) {
+            heap[position] = last;
+            siftFighter(team, position);
+        }
+        siftTeam(leaderSlot[team]);
+    }
+
+    uint32_t TargetIndex::getBestEnemy(uint32_t team) const {
+        if (leaders.empty()) {
+            return NONE;
+        }
+        if (leaders[0] != team) {
+            return teams[leaders[0]][0];
+        }
+        // The runner-up team is one of the top team's children
+        if (leaders.size() == 1) {
+            return NONE;
+        }
+        uint32_t best = leaders[1];
+        if (leaders.size() > 2 && teamBefore(leaders[2], best)) {
+            best = leaders[2];
+        }
+        return teams[best][0];
+    }
+} // namespace FantasyArena
@@ -0,0 +1,87 @@
+#pragma once
+#ifndef TEAM_BATTLE_H
+#define TEAM_BATTLE_H
+#include <string>
+#include <vector>
+#include <cstdint>
+using namespace std;
+namespace FantasyArena {
+    // Which enemy a fighter attacks in a team or free-for-all battle
+    enum class TargetRule {
+        LOWEST_HEALTH,  // The enemy closest to death
+        HIGHEST_THREAT  // The enemy with the highest attack, then the lowest health
+    };
+    // "lowest" or "threat"; false for anything else
+    bool parseTargetRule(const string& text, TargetRule& rule);
+    string getTargetRuleName(TargetRule rule);
+
+    // Outcome of a battle between any number of fighters
+    struct TeamBattleResult {
+        int winningTeam; // 0-based; -1 if the last fighters fell on the same turn
+        int turns;
+        int survivors;   // Fighters of the winning team still standing
+        int winnerHealth; // Their total health
+    };
+
+    // Turn order: the fighter with the earliest time acts and is scheduled
+    // again a turn interval later. Fallen fighters are dropped when they come
+    // up instead of being searched for. Ties go to the lower fighter number.
+    class InitiativeQueue {
+    private:
+        struct Entry {
+            int64_t time;
+            uint32_t fighter;
+        };
+        vector<Entry> heap; // Earliest entry first
+        static bool later(const Entry& a, const Entry& b) {
+            return a.time != b.time ? a.time > b.time : a.fighter > b.fighter;
+        }
+    public:
+        void clear() { heap.clear(); }
+        bool empty() const { return heap.empty(); }
+        void schedule(uint32_t fighter, int64_t time);
+        // Remove the next fighter to act; `time` is when it acts
+        uint32_t next(int64_t& time);
+    };
+
+    // The best target of every team for the current rule, kept up to date as
+    // health changes: a heap of fighters per team, and a heap of teams by
+    // their best fighter. Updates are O(log n), and the best enemy of a team
+    // is the top team's best fighter, or the better child's when the top
+    // team is the attacker's own. Equal keys go by a tie order, so fighters
+    // of the same class are not always picked in roster order.
+    class TargetIndex {
+    private:
+        static constexpr uint32_t NONE = 0xFFFFFFFFu;
+        vector<int64_t> keys;          // By fighter, lower is attacked first
+        vector<uint32_t> tieOrder;     // By fighter
+        vector<uint32_t> teamOf;       // By fighter
+        vector<uint32_t> slot;         // By fighter: position in its team's heap, NONE once removed
+        vector<vector<uint32_t>> teams; // Heap of the standing fighters of every team
+        vector<uint32_t> leaders;      // Heap of the teams with fighters standing
+        vector<uint32_t> leaderSlot;   // By team
+
+        bool fighterBefore(uint32_t a, uint32_t b) const {
+            return keys[a] != keys[b] ? keys[a] < keys[b] : tieOrder[a] < tieOrder[b];
+        }
+        bool teamBefore(uint32_t a, uint32_t b) const { return fighterBefore(teams[a][0], teams[b][0]); }
+        void siftFighter(uint32_t team, size_t position);
+        void siftTeam(size_t position);
+        void removeTeam(uint32_t team);
+    public:
+        // Fighter i belongs to fighterTeams[i], teams numbered from 0;
+        // fighterTieOrder holds distinct values
+        void build(const vector<int>& fighterTeams, const vector<int64_t>& fighterKeys,
+            const vector<uint32_t>& fighterTieOrder);
+        void update(uint32_t fighter, int64_t key);
+        void remove(uint32_t fighter); // Fallen for good
+        bool contains(uint32_t fighter) const { return slot[fighter] != NONE; }
+        size_t getTeamsStanding() const { return leaders.size(); }
+        uint32_t getLeadingTeam() const { return leaders.empty() ? NONE : leaders[0]; }
+        uint32_t getBestEnemy(uint32_t team) const; // NONE if every other team has fallen
+    };
+
+    // Index key of a fighter under a rule
+    int64_t targetKey(TargetRule rule, int health, int attack);
+} // namespace FantasyArena
+#endif // TEAM_BATTLE_H
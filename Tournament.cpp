@@ -0,0 +1,175 @@
+#include "Tournament.h"
+#include "ActionPolicy.h"
+#include "WorkStealingPool.h"
+#include <iomanip>
+#include <chrono>
+#include <algorithm>
+#include <mutex>
+using namespace std;
+namespace FantasyArena {
+    // Per-character totals for the standings
+    struct TournamentStanding {
+        int character;
+        int battles;
+        int wins;
+        long long totalTurns;
+    };
+
+    static void runMatchup(TournamentMatchup& matchup, size_t matchupIndex, const vector<Character*>& roster,
+        const vector<Arena>& arenas, const string& policy1Name, const string& policy2Name,
+        int battles, uint64_t seed, BattleInstrumentation* instrumentation, mutex& instrumentationMutex, RatingTable* ratings) {
+        // Everything mutable is private to this task
+        Arena arena(arenas[matchup.arena]);
+        BattleInstrumentation local;
+        if (instrumentation) {
+            BattleInstrumentation::attach(&local);
+        }
+        ActionPolicy* policy1 = createPolicy(policy1Name);
+        ActionPolicy* policy2 = createPolicy(policy2Name);
+        RatingBatch rated;
+        uint32_t player1 = static_cast<uint32_t>(matchup.player1);
+        uint32_t player2 = static_cast<uint32_t>(matchup.player2);
+        uint64_t firstStream = static_cast<uint64_t>(matchupIndex) * static_cast<uint64_t>(battles);
+        for (int b = 0; b < battles; ++b) {
+            arena.setBattleSeed(seed, firstStream + b);
+            BattleResult result = arena.simulateBattle(*roster[matchup.player1], *roster[matchup.player2], *policy1, *policy2);
+            if (result.winner == 1) {
+                matchup.player1Wins++;
+            }
+            else {
+                matchup.player2Wins++;
+            }
+            matchup.totalTurns += result.turns;
+            if (ratings) {
+                rated.addResult(result.winner == 1 ? player1 : player2, result.winner == 1 ? player2 : player1, *ratings);
+            }
+        }
+        delete policy1;
+        delete policy2;
+        if (ratings) {
+            ratings->submit(rated);
+        }
+        if (instrumentation) {
+            BattleInstrumentation::attach(nullptr);
+            lock_guard<mutex> lock(instrumentationMutex);
+            instrumentation->merge(local);
+        }
+    }
+
+    TournamentResult runTournament(const vector<Character*>& roster, const vector<Arena>& arenas,
+        const string& policy1, const string& policy2, int battlesPerMatchup, unsigned threads, uint64_t seed,
+        BattleInstrumentation* instrumentation, RatingTable* ratings) {
+        TournamentResult result;
+        result.battlesPerMatchup = battlesPerMatchup;
+        result.seed = seed;
+        for (size_t p1 = 0; p1 < roster.size(); ++p1) {
+            for (size_t p2 = 0; p2 < roster.size(); ++p2) {
+                for (size_t a = 0; a < arenas.size(); ++a) {
+                    if (p1 != p2) {
+                        result.matchups.push_back({ static_cast<int>(p1), static_cast<int>(p2), static_cast<int>(a), 0, 0, 0 });
+                    }
+                }
+            }
+        }
+
+        auto start = chrono::steady_clock::now();
+        mutex instrumentationMutex;
+        {
+            WorkStealingPool pool(threads);
+            result.threads = pool.size();
+            // Each task writes only its own matchup slot
+            for (size_t i = 0; i < result.matchups.size(); ++i) {
+                TournamentMatchup* matchup = &result.matchups[i];
+                pool.submit([=, &roster, &arenas, &policy1, &policy2, &instrumentationMutex]() {
+                    runMatchup(*matchup, i, roster, arenas, policy1, policy2, battlesPerMatchup, seed,
+                        instrumentation, instrumentationMutex, ratings);
+                });
+            }
+            pool.wait();
+        }
+        if (ratings) {
+            ratings->closePeriod();
+        }
+        result.elapsedSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        return result;
+    }
+
+    void printTournamentTable(ostream& os, const TournamentResult& result, const vector<Character*>& roster) {
+        size_t count = roster.size();
+        vector<TournamentStanding> standings(count);
+        // wins[i][j]: battles character i won against character j, on either side
+        vector<vector<int>> wins(count, vector<int>(count, 0));
+        vector<vector<int>> played(count, vector<int>(count, 0));
+        long long totalBattles = 0;
+        for (size_t i = 0; i < count; ++i) {
+            standings[i] = { static_cast<int>(i), 0, 0, 0 };
+        }
+        for (const TournamentMatchup& m : result.matchups) {
+            int battles = m.player1Wins + m.player2Wins;
+            totalBattles += battles;
+            standings[m.player1].battles += battles;
+            standings[m.player2].battles += battles;
+            standings[m.player1].wins += m.player1Wins;
+            standings[m.player2].wins += m.player2Wins;
+            standings[m.player1].totalTurns += m.totalTurns;
+            standings[m.player2].totalTurns += m.totalTurns;
+            wins[m.player1][m.player2] += m.player1Wins;
+            wins[m.player2][m.player1] += m.player2Wins;
+            played[m.player1][m.player2] += battles;
+            played[m.player2][m.player1] += battles;
+        }
+        stable_sort(standings.begin(), standings.end(), [](const TournamentStanding& a, const TournamentStanding& b) {
+            return static_cast<long long>(a.wins) * b.battles > static_cast<long long>(b.wins) * a.battles;
+        });
+
+        os << "\n=== TOURNAMENT RESULTS ===" << endl;
+        os << result.matchups.size() << " matchups x " << result.battlesPerMatchup << " battles = " << totalBattles
+            << " battles on " << result.threads << " threads (seed " << result.seed << ")" << endl;
+        os << fixed << setprecision(1);
+        // Name and class columns fit the longest entry, plus a space
+        size_t nameWidth = 12;
+        size_t classWidth = 10;
+        for (size_t i = 0; i < count; ++i) {
+            nameWidth = max(nameWidth, roster[i]->getName().size() + 1);
+            classWidth = max(classWidth, roster[i]->getClassName().size() + 1);
+        }
+        os << "\n" << left << setw(6) << "Rank" << setw(nameWidth) << "Character" << setw(classWidth) << "Class"
+            << right << setw(9) << "Battles" << setw(9) << "Wins" << setw(9) << "Losses" << setw(8) << "Win %"
+            << setw(11) << "Avg turns" << endl;
+        for (size_t rank = 0; rank < standings.size(); ++rank) {
+            const TournamentStanding& s = standings[rank];
+            double battles = s.battles > 0 ? s.battles : 1;
+            os << left << setw(6) << rank + 1 << setw(nameWidth) << roster[s.character]->getName()
+                << setw(classWidth) << roster[s.character]->getClassName()
+                << right << setw(9) << s.battles << setw(9) << s.wins << setw(9) << s.battles - s.wins
+                << setw(8) << 100.0 * s.wins / battles << setw(11) << s.totalTurns / battles << endl;
+        }
+
+        os << "\nHead to head (row win % against column, all arenas and sides):" << endl;
+        os << left << setw(nameWidth) << "" << right;
+        for (size_t j = 0; j < count; ++j) {
+            os << setw(9) << roster[j]->getName().substr(0, 8);
+        }
+        os << endl;
+        for (size_t i = 0; i < count; ++i) {
+            os << left << setw(nameWidth) << roster[i]->getName() << right;
+            for (size_t j = 0; j < count; ++j) {
+                if (i == j || played[i][j] == 0) {
+                    os << setw(9) << "-";
+                }
+                else {
+                    os << setw(9) << 100.0 * wins[i][j] / played[i][j];
+                }
+            }
+            os << endl;
+        }
+        os << "\nElapsed: " << setprecision(2) << result.elapsedSeconds << " s";
+        if (result.elapsedSeconds > 0) {
+            os << " (" << setprecision(0) << totalBattles / result.elapsedSeconds << " battles/s)";
+        }
+        os << endl;
+        os << "==========================" << endl;
+        os.unsetf(ios::fixed);
+        os << setprecision(6);
+    }
+} // namespace FantasyArena
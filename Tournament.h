@@ -0,0 +1,51 @@
+#pragma once
+#ifndef TOURNAMENT_H
+#define TOURNAMENT_H
+#include <string>
+#include <vector>
+#include <iostream>
+#include <cstdint>
+#include "Character.h"
+#include "Arena.h"
+#include "BattleInstrumentation.h"
+#include "Ratings.h"
+using namespace std;
+namespace FantasyArena {
+    // Outcome of every battle between one ordered pair in one arena
+    struct TournamentMatchup {
+        int player1;   // Roster index
+        int player2;   // Roster index
+        int arena;     // Arena index
+        int player1Wins;
+        int player2Wins;
+        long long totalTurns;
+    };
+
+    struct TournamentResult {
+        vector<TournamentMatchup> matchups;
+        int battlesPerMatchup;
+        unsigned threads;
+        uint64_t seed;
+        double elapsedSeconds;
+    };
+
+    // Round robin over every (player1, player2, arena) combination with
+    // player1 != player2. Each matchup is one task on a work-stealing pool with
+    // its own copy of the arena; battles fight on pooled copies of the roster,
+    // so the roster is only ever read. Battle b of matchup m uses stream
+    // m * battlesPerMatchup + b of the seed, which makes the result
+    // independent of the thread count.
+    // Console output must be disabled by the caller before the run.
+    // With `instrumentation`, every worker counts into its own copy and the
+    // copies are added into it at the end of each matchup.
+    // With `ratings` (sized to the roster), every matchup scores its battles
+    // into its own batch and submits it when done; the tournament is one
+    // rating period, closed after the last matchup.
+    TournamentResult runTournament(const vector<Character*>& roster, const vector<Arena>& arenas,
+        const string& policy1, const string& policy2, int battlesPerMatchup, unsigned threads, uint64_t seed,
+        BattleInstrumentation* instrumentation = nullptr, RatingTable* ratings = nullptr);
+
+    // Standings sorted by win rate, followed by a head-to-head win rate matrix
+    void printTournamentTable(ostream& os, const TournamentResult& result, const vector<Character*>& roster);
+} // namespace FantasyArena
+#endif // TOURNAMENT_H
@@ -0,0 +1,196 @@
+#include "WinRateMatrix.h"
+#include "ActionPolicy.h"
+#include "WorkStealingPool.h"
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <algorithm>
+using namespace std;
+namespace FantasyArena {
+    static const EnvironmentType ALL_ENVIRONMENTS[] = {
+        EnvironmentType::FIRE, EnvironmentType::ICE, EnvironmentType::JUNGLE,
+        EnvironmentType::DESERT, EnvironmentType::MOUNTAIN
+    };
+
+    WinRateConfig defaultWinRateConfig() {
+        WinRateConfig config;
+        config.classes = { CharacterKind::WARRIOR, CharacterKind::MAGE, CharacterKind::ARCHER,
+            CharacterKind::LEGENDARY, CharacterKind::MIRROR_STRIKER };
+        config.levels = { 1, 5, 10 };
+        config.policy1 = "random";
+        config.policy2 = "random";
+        config.batchSize = 64;
+        config.minBattles = 128;
+        config.maxBattles = 20000;
+        config.targetHalfWidth = 0.02;
+        config.z = 1.96;
+        config.threads = 0;
+        config.seed = 0;
+        return config;
+    }
+
+    ConfidenceInterval wilsonInterval(long long wins, long long battles, double z) {
+        if (battles <= 0) {
+            return { 0.0, 1.0 };
+        }
+        double n = static_cast<double>(battles);
+        double p = wins / n;
+        double z2 = z * z;
+        double denominator = 1.0 + z2 / n;
+        double center = (p + z2 / (2.0 * n)) / denominator;
+        double halfWidth = z / denominator * sqrt(p * (1.0 - p) / n + z2 / (4.0 * n * n));
+        return { max(0.0, center - halfWidth), min(1.0, center + halfWidth) };
+    }
+
+    static ConfidenceInterval meanInterval(double mean, double m2, int count, double z) {
+        if (count < 2) {
+            return { mean, mean };
+        }
+        double standardError = sqrt(m2 / (count - 1) / count);
+        return { mean - z * standardError, mean + z * standardError };
+    }
+
+    double WinRateCell::winRate() const {
+        return battles > 0 ? static_cast<double>(player1Wins) / battles : 0.0;
+    }
+
+    ConfidenceInterval WinRateCell::winRateInterval(double z) const {
+        return wilsonInterval(player1Wins, battles, z);
+    }
+
+    ConfidenceInterval WinRateCell::turnsInterval(double z) const {
+        return meanInterval(meanTurns, turnsM2, battles, z);
+    }
+
+    ConfidenceInterval WinRateCell::winnerHealthInterval(double z) const {
+        return meanInterval(meanWinnerHealth, winnerHealthM2, battles, z);
+    }
+
+    static void sampleCell(WinRateCell& cell, size_t cellIndex, const Arena& arenaTemplate, const WinRateConfig& config) {
+        // Everything mutable is private to this task
+        Arena arena(arenaTemplate);
+        Character* player1Template = createCharacter(cell.kind1, getClassNameForKind(cell.kind1), cell.level1);
+        Character* player2Template = createCharacter(cell.kind2, getClassNameForKind(cell.kind2), cell.level2);
+        ActionPolicy* policy1 = createPolicy(config.policy1);
+        ActionPolicy* policy2 = createPolicy(config.policy2);
+        uint64_t firstStream = static_cast<uint64_t>(cellIndex) * static_cast<uint64_t>(config.maxBattles);
+
+        while (cell.battles < config.maxBattles) {
+            int batchEnd = min(cell.battles + config.batchSize, config.maxBattles);
+            while (cell.battles < batchEnd) {
+                arena.setBattleSeed(config.seed, firstStream + cell.battles);
+                BattleResult result = arena.simulateBattle(*player1Template, *player2Template, *policy1, *policy2);
+
+                cell.battles++;
+                cell.player1Wins += (result.winner == 1) ? 1 : 0;
+                double delta = result.turns - cell.meanTurns;
+                cell.meanTurns += delta / cell.battles;
+                cell.turnsM2 += delta * (result.turns - cell.meanTurns);
+                delta = result.winnerHealth - cell.meanWinnerHealth;
+                cell.meanWinnerHealth += delta / cell.battles;
+                cell.winnerHealthM2 += delta * (result.winnerHealth - cell.meanWinnerHealth);
+            }
+            if (cell.battles >= config.minBattles) {
+                ConfidenceInterval interval = cell.winRateInterval(config.z);
+                if ((interval.high - interval.low) / 2.0 <= config.targetHalfWidth) {
+                    cell.converged = true;
+                    break;
+                }
+            }
+        }
+        delete player1Template;
+        delete player2Template;
+        delete policy1;
+        delete policy2;
+    }
+
+    WinRateMatrix computeWinRateMatrix(const WinRateConfig& config) {
+        WinRateMatrix matrix;
+        matrix.config = config;
+        matrix.config.batchSize = max(1, config.batchSize);
+        matrix.config.maxBattles = max(1, config.maxBattles);
+        matrix.totalBattles = 0;
+
+        vector<Arena> arenas;
+        for (EnvironmentType environment : ALL_ENVIRONMENTS) {
+            arenas.push_back(Arena("Balance Arena", environment));
+        }
+        for (size_t e = 0; e < arenas.size(); ++e) {
+            for (CharacterKind kind1 : config.classes) {
+                for (CharacterKind kind2 : config.classes) {
+                    for (int level1 : config.levels) {
+                        for (int level2 : config.levels) {
+                            WinRateCell cell = { kind1, kind2, level1, level2, ALL_ENVIRONMENTS[e], 0, 0, 0.0, 0.0, 0.0, 0.0, false };
+                            matrix.cells.push_back(cell);
+                        }
+                    }
+                }
+            }
+        }
+
+        auto start = chrono::steady_clock::now();
+        {
+            WorkStealingPool pool(config.threads);
+            matrix.threads = pool.size();
+            const WinRateConfig& sharedConfig = matrix.config;
+            for (size_t i = 0; i < matrix.cells.size(); ++i) {
+                WinRateCell* cell = &matrix.cells[i];
+                const Arena* arena = &arenas[static_cast<size_t>(cell->environment)];
+                pool.submit([cell, i, arena, &sharedConfig]() {
+                    sampleCell(*cell, i, *arena, sharedConfig);
+                });
+            }
+            pool.wait();
+        }
+        matrix.elapsedSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        for (const WinRateCell& cell : matrix.cells) {
+            matrix.totalBattles += cell.battles;
+        }
+        return matrix;
+    }
+
+    void printWinRateMatrix(ostream& os, const WinRateMatrix& matrix) {
+        const WinRateConfig& config = matrix.config;
+        int converged = 0;
+        for (const WinRateCell& cell : matrix.cells) {
+            converged += cell.converged ? 1 : 0;
+        }
+        os << "\n=== WIN RATE MATRIX ===" << endl;
+        os << "Policies: " << config.policy1 << " vs " << config.policy2 << ", target +/-" << 100.0 * config.targetHalfWidth
+            << "% at z = " << config.z << ", seed " << config.seed << endl;
+        os << fixed << setprecision(1);
+        EnvironmentType currentEnvironment = EnvironmentType::FIRE;
+        bool first = true;
+        for (const WinRateCell& cell : matrix.cells) {
+            if (first || cell.environment != currentEnvironment) {
+                currentEnvironment = cell.environment;
+                first = false;
+                os << "\n--- " << getEnvironmentNameForType(cell.environment) << " ---" << endl;
+                os << left << setw(28) << "Player 1 vs Player 2" << right << setw(22) << "P1 win % [CI]"
+                    << setw(20) << "Turns [CI]" << setw(22) << "Winner HP [CI]" << setw(8) << "N" << endl;
+            }
+            ConfidenceInterval win = cell.winRateInterval(config.z);
+            ConfidenceInterval turns = cell.turnsInterval(config.z);
+            ConfidenceInterval health = cell.winnerHealthInterval(config.z);
+            string pairing = getClassNameForKind(cell.kind1).substr(0, 8) + " L" + to_string(cell.level1) + " vs " +
+                getClassNameForKind(cell.kind2).substr(0, 8) + " L" + to_string(cell.level2);
+            ostringstream winText;
+            ostringstream turnsText;
+            ostringstream healthText;
+            winText << fixed << setprecision(1) << 100.0 * cell.winRate() << " [" << 100.0 * win.low << "," << 100.0 * win.high << "]";
+            turnsText << fixed << setprecision(1) << cell.meanTurns << " [" << turns.low << "," << turns.high << "]";
+            healthText << fixed << setprecision(1) << cell.meanWinnerHealth << " [" << health.low << "," << health.high << "]";
+            os << left << setw(28) << pairing << right << setw(22) << winText.str() << setw(20) << turnsText.str()
+                << setw(22) << healthText.str() << setw(8) << cell.battles << (cell.converged ? "" : " *") << endl;
+        }
+        long long fixedBudget = static_cast<long long>(matrix.cells.size()) * config.maxBattles;
+        os << "\n" << matrix.cells.size() << " cells, " << converged << " reached the target ("
+            << "* = stopped at " << config.maxBattles << " battles)" << endl;
+        os << matrix.totalBattles << " battles instead of " << fixedBudget << " at a fixed sample size, on "
+            << matrix.threads << " threads in " << setprecision(2) << matrix.elapsedSeconds << " s" << endl;
+        os << "=======================" << endl;
+        os.unsetf(ios::fixed);
+        os << setprecision(6);
+    }
+} // namespace FantasyArena
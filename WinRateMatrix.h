@@ -0,0 +1,74 @@
+#pragma once
+#ifndef WIN_RATE_MATRIX_H
+#define WIN_RATE_MATRIX_H
+#include <string>
+#include <vector>
+#include <iostream>
+#include <cstdint>
+#include "Character.h"
+#include "Arena.h"
+using namespace std;
+namespace FantasyArena {
+    struct WinRateConfig {
+        vector<CharacterKind> classes;
+        vector<int> levels;
+        string policy1;
+        string policy2;
+        int batchSize;          // Battles between two stopping checks
+        int minBattles;         // Never stop a cell before this many battles
+        int maxBattles;         // Hard cap per cell
+        double targetHalfWidth; // Stop once the win rate interval is this tight (0.02 = +/-2%)
+        double z;               // Normal quantile of the confidence level (1.96 = 95%)
+        unsigned threads;       // 0 = all cores
+        uint64_t seed;
+    };
+    // Every class at levels 1, 5 and 10, random play, +/-2% at 95%
+    WinRateConfig defaultWinRateConfig();
+
+    struct ConfidenceInterval {
+        double low;
+        double high;
+    };
+
+    // One (class, level) vs (class, level) pairing in one environment
+    struct WinRateCell {
+        CharacterKind kind1;
+        CharacterKind kind2;
+        int level1;
+        int level2;
+        EnvironmentType environment;
+        int battles;
+        int player1Wins;
+        // Running mean and sum of squared deviations (Welford)
+        double meanTurns;
+        double turnsM2;
+        double meanWinnerHealth;
+        double winnerHealthM2;
+        bool converged; // Reached the target width before maxBattles
+
+        double winRate() const;
+        ConfidenceInterval winRateInterval(double z) const;     // Wilson score interval
+        ConfidenceInterval turnsInterval(double z) const;       // Normal approximation
+        ConfidenceInterval winnerHealthInterval(double z) const;
+    };
+
+    struct WinRateMatrix {
+        WinRateConfig config;
+        vector<WinRateCell> cells;
+        long long totalBattles;
+        unsigned threads;
+        double elapsedSeconds;
+    };
+
+    // Wilson score interval for wins out of battles
+    ConfidenceInterval wilsonInterval(long long wins, long long battles, double z);
+
+    // Samples every cell in batches on a work-stealing pool until its interval
+    // is tight enough. Battle i of cell c uses stream c * maxBattles + i of the
+    // seed, so the matrix does not depend on the thread count.
+    // Console output must be disabled by the caller before the run.
+    WinRateMatrix computeWinRateMatrix(const WinRateConfig& config);
+
+    void printWinRateMatrix(ostream& os, const WinRateMatrix& matrix);
+} // namespace FantasyArena
+#endif // WIN_RATE_MATRIX_H
@@ -0,0 +1,105 @@
+#include "WorkStealingPool.h"
+using namespace std;
+namespace FantasyArena {
+    // Lets submit() find the calling worker's own deque
+    static thread_local const WorkStealingPool* currentPool = nullptr;
+    static thread_local size_t currentWorker = 0;
+
+    WorkStealingPool::WorkStealingPool(unsigned threadCount)
+        : queuedTasks(0), pendingTasks(0), nextQueue(0), stopping(false) {
+        if (threadCount == 0) {
+            threadCount = thread::hardware_concurrency();
+        }
+        if (threadCount == 0) {
+            threadCount = 1;
+        }
+        for (unsigned i = 0; i < threadCount; ++i) {
+            queues.emplace_back(new WorkerQueue());
+        }
+        for (unsigned i = 0; i < threadCount; ++i) {
+            workers.emplace_back(&WorkStealingPool::workerLoop, this, static_cast<size_t>(i));
+        }
+    }
+
+    WorkStealingPool::~WorkStealingPool() {
+        {
+            lock_guard<mutex> guard(sleepLock);
+            stopping = true;
+        }
+        workAvailable.notify_all();
+        // Workers drain the remaining tasks before they exit
+        for (thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+    unsigned WorkStealingPool::size() const {
+        return static_cast<unsigned>(workers.size());
+    }
+
+    void WorkStealingPool::submit(function<void()> task) {
+        size_t target = (currentPool == this) ? currentWorker : nextQueue.fetch_add(1) % queues.size();
+        pendingTasks.fetch_add(1);
+        {
+            lock_guard<mutex> guard(queues[target]->lock);
+            queues[target]->tasks.push_back(move(task));
+            queuedTasks.fetch_add(1);
+        }
+        lock_guard<mutex> guard(sleepLock);
+        workAvailable.notify_one();
+    }
+
+    void WorkStealingPool::wait() {
+        unique_lock<mutex> guard(sleepLock);
+        allDone.wait(guard, [this] { return pendingTasks.load() == 0; });
+    }
+
+    bool WorkStealingPool::popLocal(size_t worker, function<void()>& task) {
+        WorkerQueue& queue = *queues[worker];
+        lock_guard<mutex> guard(queue.lock);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        // Newest first: its data is most likely still in this core's cache
+        task = move(queue.tasks.back());
+        queue.tasks.pop_back();
+        queuedTasks.fetch_sub(1);
+        return true;
+    }
+
+    bool WorkStealingPool::steal(size_t thief, function<void()>& task) {
+        for (size_t offset = 1; offset < queues.size(); ++offset) {
+            WorkerQueue& victim = *queues[(thief + offset) % queues.size()];
+            lock_guard<mutex> guard(victim.lock);
+            if (!victim.tasks.empty()) {
+                // Oldest first, away from the end the owner is working on
+                task = move(victim.tasks.front());
+                victim.tasks.pop_front();
+                queuedTasks.fetch_sub(1);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void WorkStealingPool::workerLoop(size_t worker) {
+        currentPool = this;
+        currentWorker = worker;
+        while (true) {
+            function<void()> task;
+            if (popLocal(worker, task) || steal(worker, task)) {
+                task();
+                if (pendingTasks.fetch_sub(1) == 1) {
+                    lock_guard<mutex> guard(sleepLock);
+                    allDone.notify_all();
+                }
+                continue;
+            }
+            unique_lock<mutex> guard(sleepLock);
+            workAvailable.wait(guard, [this] { return stopping || queuedTasks.load() > 0; });
+            if (stopping && queuedTasks.load() == 0) {
+                return;
+            }
+        }
+    }
+} // namespace FantasyArena
@@ -0,0 +1,49 @@
+#pragma once
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+using namespace std;
+namespace FantasyArena {
+    // Fixed set of worker threads, one task deque each. A worker takes its own
+    // newest task first and, when its deque is empty, steals the oldest task of
+    // another worker, so uneven battles still keep every core busy.
+    class WorkStealingPool {
+    private:
+        struct WorkerQueue {
+            mutex lock;
+            deque<function<void()>> tasks;
+        };
+        vector<unique_ptr<WorkerQueue>> queues;
+        vector<thread> workers;
+        atomic<size_t> queuedTasks;   // Submitted but not yet taken
+        atomic<size_t> pendingTasks;  // Submitted but not yet finished
+        atomic<size_t> nextQueue;     // Round-robin target for outside submissions
+        mutex sleepLock;
+        condition_variable workAvailable;
+        condition_variable allDone;
+        bool stopping;
+
+        bool popLocal(size_t worker, function<void()>& task);
+        bool steal(size_t thief, function<void()>& task);
+        void workerLoop(size_t worker);
+    public:
+        explicit WorkStealingPool(unsigned threadCount = 0); // 0 = one per hardware thread
+        ~WorkStealingPool();
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+        // Tasks submitted from a worker go to that worker's own deque
+        void submit(function<void()> task);
+        // Block until every submitted task has finished
+        void wait();
+        unsigned size() const;
+    };
+} // namespace FantasyArena
+#endif // WORK_STEALING_POOL_H
@@ -0,0 +1,329 @@
+// Microbenchmarks of the combat hot paths, with a stored baseline.
+// Build from the repository root, for example:
+//   g++ -std=c++17 -O2 -pthread -I. Arena.cpp Character.cpp ActionPolicy.cpp AsyncLogSink.cpp LogEvent.cpp BattleTrace.cpp MappedFile.cpp BattleRandom.cpp CombatantPool.cpp StatTables.cpp CombatModel.cpp SearchPolicy.cpp Tablebase.cpp BattleInstrumentation.cpp FrameRenderer.cpp ClassDefinitions.cpp TeamBattle.cpp benchmarks/CombatBenchmarks.cpp -o combat_benchmarks
+// Run:
+//   combat_benchmarks [--filter TEXT] [--min-time MS] [--samples N]
+//                     [--save-baseline FILE] [--baseline FILE [--tolerance 0.25]]
+// With --baseline, exits with 1 if any benchmark is slower than the baseline
+// by more than the tolerance or allocates more per operation.
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <map>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include "Arena.h"
+#include "Character.h"
+#include "ActionPolicy.h"
+#include "AsyncLogSink.h"
+using namespace std;
+using namespace FantasyArena;
+
+// Heap allocations made by the benchmark thread (the log writer thread is not counted)
+static thread_local uint64_t allocationCount = 0;
+
+#if defined(__GNUC__) && !defined(__clang__)
+// The replacements below pair malloc and free themselves
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(size_t size) {
+    ++allocationCount;
+    void* memory = malloc(size ? size : 1);
+    if (!memory) {
+        throw bad_alloc();
+    }
+    return memory;
+}
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+void operator delete(void* memory) noexcept {
+    free(memory);
+}
+void operator delete[](void* memory) noexcept {
+    free(memory);
+}
+void operator delete(void* memory, size_t) noexcept {
+    free(memory);
+}
+void operator delete[](void* memory, size_t) noexcept {
+    free(memory);
+}
+
+// Keeps results alive so the optimizer cannot drop the measured work
+static volatile long long benchmarkSink = 0;
+
+struct BenchmarkResult {
+    string name;
+    double nsPerOp;
+    double allocationsPerOp;
+    double opsPerSecond;
+};
+
+struct BenchmarkSettings {
+    string filter;
+    double minMilliseconds; // Per sample
+    int samples;
+};
+
+// Runs body(iterations) for enough iterations to fill each sample and
+// reports the fastest sample, which is the least disturbed by other load.
+// The first call warms caches and pools.
+template <typename Body>
+static bool runBenchmark(const string& name, const BenchmarkSettings& settings, vector<BenchmarkResult>& results, Body body) {
+    if (!settings.filter.empty() && name.find(settings.filter) == string::npos) {
+        return false;
+    }
+    body(1000);
+    uint64_t iterations = 1;
+    while (true) {
+        auto start = chrono::steady_clock::now();
+        body(iterations);
+        double milliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        if (milliseconds >= settings.minMilliseconds / 4 || iterations >= (1ull << 40)) {
+            iterations = static_cast<uint64_t>(iterations * settings.minMilliseconds / max(milliseconds, 1e-3)) + 1;
+            break;
+        }
+        iterations *= 4;
+    }
+    vector<double> nsPerOp;
+    uint64_t allocations = 0;
+    for (int sample = 0; sample < settings.samples; ++sample) {
+        uint64_t allocationsBefore = allocationCount;
+        auto start = chrono::steady_clock::now();
+        body(iterations);
+        double nanoseconds = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+        allocations += allocationCount - allocationsBefore;
+        nsPerOp.push_back(nanoseconds / iterations);
+    }
+    sort(nsPerOp.begin(), nsPerOp.end());
+    BenchmarkResult result;
+    result.name = name;
+    result.nsPerOp = nsPerOp.front();
+    result.allocationsPerOp = static_cast<double>(allocations) / (static_cast<double>(iterations) * settings.samples);
+    result.opsPerSecond = 1e9 / result.nsPerOp;
+    results.push_back(result);
+    cout << left << setw(44) << name << right << fixed << setprecision(1) << setw(12) << result.nsPerOp << " ns/op"
+        << setprecision(2) << setw(10) << result.allocationsPerOp << " allocs/op" << setprecision(0) << setw(14)
+        << result.opsPerSecond << " ops/s" << endl;
+    return true;
+}
+
+static bool saveBaseline(const string& path, const vector<BenchmarkResult>& results) {
+    ofstream out(path);
+    if (!out.is_open()) {
+        return false;
+    }
+    // Times are machine-specific; compare against a baseline saved on the same machine
+    out << "# Combat benchmark baseline, written by combat_benchmarks --save-baseline" << endl;
+    out << "# name ns_per_op allocations_per_op" << endl;
+    for (const BenchmarkResult& result : results) {
+        out << result.name << " " << fixed << setprecision(2) << result.nsPerOp << " " << setprecision(4)
+            << result.allocationsPerOp << endl;
+    }
+    return out.good();
+}
+
+// Returns the number of regressions, or -1 if the baseline cannot be read
+static int compareBaseline(const string& path, const vector<BenchmarkResult>& results, double tolerance) {
+    ifstream in(path);
+    if (!in.is_open()) {
+        return -1;
+    }
+    map<string, pair<double, double>> baseline;
+    string line;
+    while (getline(in, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        istringstream fields(line);
+        string name;
+        double nsPerOp;
+        double allocationsPerOp;
+        if (fields >> name >> nsPerOp >> allocationsPerOp) {
+            baseline[name] = { nsPerOp, allocationsPerOp };
+        }
+    }
+    int regressions = 0;
+    cout << "\nComparison with " << path << " (tolerance " << setprecision(0) << tolerance * 100 << "%):" << endl;
+    for (const BenchmarkResult& result : results) {
+        auto found = baseline.find(result.name);
+        if (found == baseline.end()) {
+            cout << left << setw(44) << result.name << " no baseline" << endl;
+            continue;
+        }
+        double ratio = result.nsPerOp / found->second.first;
+        bool slower = ratio > 1.0 + tolerance;
+        // Allow for rounding in benchmarks whose operations allocate unevenly
+        bool allocates = result.allocationsPerOp > found->second.second * 1.01 + 0.01;
+        cout << left << setw(44) << result.name << right << fixed << setprecision(2) << setw(8) << ratio << "x time";
+        if (slower || allocates) {
+            cout << "  REGRESSION";
+            if (slower) cout << " (slower)";
+            if (allocates) cout << " (allocations " << found->second.second << " -> " << result.allocationsPerOp << ")";
+            ++regressions;
+        }
+        cout << endl;
+    }
+    return regressions;
+}
+
+int main(int argc, char* argv[]) {
+    BenchmarkSettings settings = { "", 100.0, 5 };
+    string saveBaselinePath;
+    string baselinePath;
+    double tolerance = 0.25;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (i + 1 >= argc) {
+            cout << "Error: Missing value for argument " << arg << endl;
+            return 2;
+        }
+        if (arg == "--filter") settings.filter = argv[++i];
+        else if (arg == "--min-time") settings.minMilliseconds = max(1.0, atof(argv[++i]));
+        else if (arg == "--samples") settings.samples = max(1, atoi(argv[++i]));
+        else if (arg == "--save-baseline") saveBaselinePath = argv[++i];
+        else if (arg == "--baseline") baselinePath = argv[++i];
+        else if (arg == "--tolerance") tolerance = atof(argv[++i]);
+        else {
+            cout << "Error: Unknown argument " << arg << endl;
+            return 2;
+        }
+    }
+
+    Character::setConsoleOutput(false);
+    Character::attachLogSink(nullptr);
+    vector<Character*> roster;
+    roster.push_back(new Warrior("Aragorn", 5));
+    roster.push_back(new Mage("Gandalf", 6));
+    roster.push_back(new Archer("Legolas", 5));
+    roster.push_back(new LegendaryCharacter("Elendil", 5));
+    roster.push_back(new MirrorStriker("Galadriel", 5));
+    Arena arena("Fangorn Forest", EnvironmentType::JUNGLE);
+    arena.setBattleSeed(20240601);
+    AbilityWhenReadyPolicy policy;
+    vector<BenchmarkResult> results;
+
+    // One attack on a fresh level 5 Warrior, topped up when it gets low
+    for (Character* character : roster) {
+        Character* attacker = character->clone();
+        Character* defender = roster[0]->clone();
+        CombatState fresh = defender->getCombatState();
+        runBenchmark("attackTarget/" + character->getClassName(), settings, results, [&](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; ++i) {
+                attacker->attackTarget(*defender);
+                if (defender->getHealth() < fresh.health / 2) {
+                    defender->setCombatState(fresh);
+                }
+            }
+            benchmarkSink = benchmarkSink + defender->getHealth();
+        });
+        delete attacker;
+        delete defender;
+    }
+
+    // One headless turn, alternating sides; both fighters are reset before anyone dies
+    {
+        Character* first = roster[0]->clone();
+        Character* second = roster[1]->clone();
+        CombatState firstFresh = first->getCombatState();
+        CombatState secondFresh = second->getCombatState();
+        runBenchmark("processTurn/headless", settings, results, [&](uint64_t iterations) {
+            Character* attacker = first;
+            Character* defender = second;
+            for (uint64_t i = 0; i < iterations; ++i) {
+                arena.processTurn(attacker, defender, static_cast<int>(i % 50) + 1, policy);
+                if (first->getHealth() < firstFresh.health / 2 || second->getHealth() < secondFresh.health / 2) {
+                    first->setCombatState(firstFresh);
+                    second->setCombatState(secondFresh);
+                }
+                swap(attacker, defender);
+            }
+            benchmarkSink = benchmarkSink + first->getHealth();
+        });
+        delete first;
+        delete second;
+    }
+
+    // Expire an active one-turn ability
+    {
+        Character* fighter = roster[0]->clone();
+        CombatState active = fighter->getCombatState();
+        active.abilityActive = true;
+        runBenchmark("checkAndDeactivateAbilitiesWithoutCooldown", settings, results, [&](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; ++i) {
+                fighter->setCombatState(active);
+                arena.checkAndDeactivateAbilitiesWithoutCooldown(fighter);
+            }
+            benchmarkSink = benchmarkSink + fighter->getCombatState().abilityActive;
+        });
+        delete fighter;
+    }
+
+    // A typical turn log line, with no log open and with the asynchronous log open
+    {
+        const string message = "Turn 12: Aragorn attacks Gandalf for 23 damage";
+        runBenchmark("logAction/off", settings, results, [&](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; ++i) {
+                Character::logAction(message);
+            }
+        });
+        AsyncLogSink sink;
+        const string logPath = "combat_benchmarks_log.txt";
+        if (sink.openFile(logPath, "")) {
+            Character::attachLogSink(&sink);
+            runBenchmark("logAction/on", settings, results, [&](uint64_t iterations) {
+                for (uint64_t i = 0; i < iterations; ++i) {
+                    Character::logAction(message);
+                }
+            });
+            Character::attachLogSink(nullptr);
+            sink.closeFile("");
+            remove(logPath.c_str());
+        }
+    }
+
+    // Complete headless battles: one class pairing and the whole roster round robin
+    runBenchmark("battle/Warrior-vs-Mage", settings, results, [&](uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; ++i) {
+            benchmarkSink = benchmarkSink + arena.simulateBattle(*roster[0], *roster[1], policy, policy).turns;
+        }
+    });
+    runBenchmark("battle/roster", settings, results, [&](uint64_t iterations) {
+        size_t pairs = roster.size() * roster.size();
+        for (uint64_t i = 0; i < iterations; ++i) {
+            size_t pair = i % pairs;
+            benchmarkSink = benchmarkSink + arena.simulateBattle(*roster[pair / roster.size()], *roster[pair % roster.size()],
+                policy, policy).turns;
+        }
+    });
+
+    for (auto character : roster) {
+        delete character;
+    }
+
+    if (!saveBaselinePath.empty()) {
+        if (!saveBaseline(saveBaselinePath, results)) {
+            cout << "Error: Could not write baseline " << saveBaselinePath << endl;
+            return 2;
+        }
+        cout << "Saved baseline to " << saveBaselinePath << endl;
+    }
+    if (!baselinePath.empty()) {
+        int regressions = compareBaseline(baselinePath, results, tolerance);
+        if (regressions < 0) {
+            cout << "Error: Could not read baseline " << baselinePath << endl;
+            return 2;
+        }
+        cout << regressions << " regression(s)" << endl;
+        return regressions == 0 ? 0 : 1;
+    }
+    return 0;
+}
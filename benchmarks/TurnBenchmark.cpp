@@ -0,0 +1,46 @@
+// Per-turn cost of the headless battle loop.
+// Build from the repository root, for example:
+//   g++ -std=c++17 -O2 -pthread -I. Arena.cpp Character.cpp ActionPolicy.cpp AsyncLogSink.cpp LogEvent.cpp BattleTrace.cpp MappedFile.cpp BattleRandom.cpp CombatantPool.cpp StatTables.cpp CombatModel.cpp SearchPolicy.cpp Tablebase.cpp BattleInstrumentation.cpp FrameRenderer.cpp ClassDefinitions.cpp TeamBattle.cpp benchmarks/TurnBenchmark.cpp -o turn_benchmark
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include "Arena.h"
+#include "Character.h"
+#include "ActionPolicy.h"
+using namespace std;
+using namespace FantasyArena;
+
+int main() {
+    const int battlesPerPair = 20000;
+    vector<Character*> roster;
+    roster.push_back(new Warrior("Aragorn", 5));
+    roster.push_back(new Mage("Gandalf", 6));
+    roster.push_back(new Archer("Legolas", 5));
+    roster.push_back(new LegendaryCharacter("Elendil", 5));
+    roster.push_back(new MirrorStriker("Galadriel", 5));
+    Arena arena("Fangorn Forest", EnvironmentType::JUNGLE);
+    AbilityWhenReadyPolicy policy;
+    Character::setConsoleOutput(false);
+
+    long long turns = 0;
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < roster.size(); ++i) {
+        for (size_t j = 0; j < roster.size(); ++j) {
+            for (int b = 0; b < battlesPerPair; ++b) {
+                turns += arena.simulateBattle(*roster[i], *roster[j], policy, policy).turns;
+            }
+        }
+    }
+    auto end = chrono::steady_clock::now();
+    double seconds = chrono::duration<double>(end - start).count();
+
+    cout << fixed << setprecision(1);
+    cout << "Turns: " << turns << endl;
+    cout << "Per turn: " << seconds * 1e9 / turns << " ns" << endl;
+    cout << "Battles/s: " << setprecision(0) << (roster.size() * roster.size() * battlesPerPair) / seconds << endl;
+    for (auto character : roster) {
+        delete character;
+    }
+    return 0;
+}
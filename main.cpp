@@ -1,11 +1,50 @@
 #include <iostream>
 #include <cstdlib>
-#include <ctime>
 #include "GameManager.h"
+#include "Simulation.h"
+#include "ClassDefinitions.h"
 using namespace std;
-int main() {
-    // Seed the random number generator
-    srand(static_cast<unsigned int>(time(nullptr)));
+int main(int argc, char* argv[]) {
+    // Headless simulation mode: fantasy_arena --simulate 100000 --p1 1 --p2 3 --arena 2
+    FantasyArena::SimulationOptions simulationOptions = FantasyArena::defaultSimulationOptions();
+    if (!FantasyArena::parseSimulationOptions(argc, argv, simulationOptions)) {
+        return 1;
+    }
+    if (!simulationOptions.classesFile.empty()) {
+        string error;
+        if (!FantasyArena::loadClassDefinitions(simulationOptions.classesFile, error)) {
+            cout << "Error: Could not load classes from " << simulationOptions.classesFile << ": " << error << endl;
+            return 1;
+        }
+    }
+    if (!simulationOptions.replayFile.empty()) {
+        return FantasyArena::replayTrace(simulationOptions) ? 0 : 1;
+    }
+    if (!simulationOptions.rosterImageOutput.empty()) {
+        FantasyArena::GameManager compiler;
+        return compiler.rosterImageMode(simulationOptions) ? 0 : 1;
+    }
+    if (!simulationOptions.solveFile.empty()) {
+        FantasyArena::GameManager solver;
+        return solver.solveMode(simulationOptions) ? 0 : 1;
+    }
+    if (simulationOptions.winRates) {
+        FantasyArena::GameManager statistics;
+        return statistics.winRateMode(simulationOptions) ? 0 : 1;
+    }
+    if (simulationOptions.tournament > 0) {
+        FantasyArena::GameManager tournament;
+        tournament.setRatingsFile(simulationOptions.ratingsFile);
+        return tournament.tournamentMode(simulationOptions) ? 0 : 1;
+    }
+    if (simulationOptions.teamBattles > 0) {
+        FantasyArena::GameManager teamBattle;
+        return teamBattle.teamBattleMode(simulationOptions) ? 0 : 1;
+    }
+    if (simulationOptions.enabled) {
+        FantasyArena::GameManager simulator;
+        return simulator.simulationMode(simulationOptions) ? 0 : 1;
+    }
     // Display welcome message
     cout << "=========================================" << endl;
     cout << "   Welcome to Fantasy Arena Battle Game  " << endl;
@@ -14,6 +53,14 @@ int main() {
     cout << endl;
     // Create and run the game
     FantasyArena::GameManager gameManager;
+    gameManager.setRosterFiles(simulationOptions.rosterFile, simulationOptions.rosterImageFile);
+    gameManager.setRatingsFile(simulationOptions.ratingsFile);
+    if (!simulationOptions.tablebaseFile.empty()) {
+        gameManager.loadTablebase(simulationOptions.tablebaseFile);
+    }
+    if (simulationOptions.instrument) {
+        gameManager.enableInstrumentation(simulationOptions.instrumentFile);
+    }
     gameManager.runGame();
     system("pause");
     return 0;